@@ -0,0 +1,257 @@
+// bgrkernels.cpp
+#include "bgrkernels.h"
+
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PCB_X86_SIMD 1
+#include <immintrin.h>
+// GCC et Clang compilent chaque noyau pour son jeu d'instructions (sans -mavx2 global) ;
+// MSVC autorise les intrinsèques partout, l'attribut est inutile.
+#if defined(__GNUC__)
+#define PCB_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PCB_TARGET(isa)
+#endif
+#endif
+
+namespace {
+
+// Coefficients de cvtColor(COLOR_BGR2GRAY) pour les images 8 bits (virgule fixe sur 14 bits)
+const int kGrayShift = 14;
+const int kB2Y = 1868;
+const int kG2Y = 9617;
+const int kR2Y = 4899;
+const int kGrayRound = 1 << (kGrayShift - 1);
+
+/**
+ * @brief Noyau scalaire, de la colonne `x` à la fin de la ligne ; sert aussi à finir les lignes des noyaux SIMD.
+ */
+void rowScalar(const uchar* bgr, uchar* gray, uchar* dark, int x, int width, int darkMaxValue)
+{
+    for (; x < width; ++x) {
+        const int b = bgr[3 * x], g = bgr[3 * x + 1], r = bgr[3 * x + 2];
+        if (gray) {
+            gray[x] = static_cast<uchar>((b * kB2Y + g * kG2Y + r * kR2Y + kGrayRound) >> kGrayShift);
+        }
+        if (dark) {
+            dark[x] = std::max(b, std::max(g, r)) <= darkMaxValue ? 255 : 0;
+        }
+    }
+}
+
+#ifdef PCB_X86_SIMD
+
+/**
+ * @brief Sépare 16 pixels BGR entrelacés (48 octets) en trois vecteurs B, G et R (pshufb).
+ */
+PCB_TARGET("ssse3")
+inline void deinterleave16(const uchar* p, __m128i& b, __m128i& g, __m128i& r)
+{
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+    const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+    // -1 : octet mis à zéro par pshufb
+    b = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    g = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    r = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(v0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+/**
+ * @brief Niveaux de gris de 4 pixels (entiers 32 bits) à partir de B, G, R étendus sur 16 bits.
+ * pmaddwd calcule B*kB2Y + G*kG2Y sur les paires (B, G), puis R*kR2Y + 1*arrondi sur les paires (R, 1).
+ */
+PCB_TARGET("ssse3")
+inline __m128i gray4(__m128i b16, __m128i g16, __m128i r16, bool high)
+{
+    const __m128i bgCoeffs = _mm_set1_epi32((kG2Y << 16) | kB2Y);
+    const __m128i rCoeffs = _mm_set1_epi32((kGrayRound << 16) | kR2Y);
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i bg = high ? _mm_unpackhi_epi16(b16, g16) : _mm_unpacklo_epi16(b16, g16);
+    const __m128i r1 = high ? _mm_unpackhi_epi16(r16, ones) : _mm_unpacklo_epi16(r16, ones);
+    const __m128i sum = _mm_add_epi32(_mm_madd_epi16(bg, bgCoeffs), _mm_madd_epi16(r1, rCoeffs));
+    return _mm_srli_epi32(sum, kGrayShift);
+}
+
+/**
+ * @brief Niveaux de gris de 8 pixels (entiers 16 bits) à partir de B, G, R étendus sur 16 bits.
+ */
+PCB_TARGET("ssse3")
+inline __m128i gray8(__m128i b16, __m128i g16, __m128i r16)
+{
+    return _mm_packs_epi32(gray4(b16, g16, r16, false), gray4(b16, g16, r16, true));
+}
+
+/**
+ * @brief Noyau SSSE3 : 16 pixels par itération.
+ */
+PCB_TARGET("ssse3")
+void rowSsse3(const uchar* bgr, uchar* gray, uchar* dark, int width, int darkMaxValue)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i darkMax = _mm_set1_epi8(static_cast<char>(darkMaxValue));
+    int x = 0;
+    for (; x <= width - 16; x += 16) {
+        __m128i b, g, r;
+        deinterleave16(bgr + 3 * x, b, g, r);
+        if (gray) {
+            const __m128i lo = gray8(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(g, zero), _mm_unpacklo_epi8(r, zero));
+            const __m128i hi = gray8(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(g, zero), _mm_unpackhi_epi8(r, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(gray + x), _mm_packus_epi16(lo, hi));
+        }
+        if (dark) {
+            // V = max(B, G, R) ; V <= seuil  <=>  min(V, seuil) == V (comparaison non signée)
+            const __m128i v = _mm_max_epu8(_mm_max_epu8(b, g), r);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dark + x), _mm_cmpeq_epi8(_mm_min_epu8(v, darkMax), v));
+        }
+    }
+    rowScalar(bgr, gray, dark, x, width, darkMaxValue);
+}
+
+/**
+ * @brief Niveaux de gris de 16 pixels (entiers 16 bits), version AVX2 de gray8().
+ */
+PCB_TARGET("avx2")
+inline __m256i gray16(__m256i b16, __m256i g16, __m256i r16)
+{
+    const __m256i bgCoeffs = _mm256_set1_epi32((kG2Y << 16) | kB2Y);
+    const __m256i rCoeffs = _mm256_set1_epi32((kGrayRound << 16) | kR2Y);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i lo = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(b16, g16), bgCoeffs),
+                                        _mm256_madd_epi16(_mm256_unpacklo_epi16(r16, ones), rCoeffs));
+    const __m256i hi = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(b16, g16), bgCoeffs),
+                                        _mm256_madd_epi16(_mm256_unpackhi_epi16(r16, ones), rCoeffs));
+    return _mm256_packs_epi32(_mm256_srli_epi32(lo, kGrayShift), _mm256_srli_epi32(hi, kGrayShift));
+}
+
+/**
+ * @brief Noyau AVX2 : 32 pixels par itération. Le désentrelacement se fait par moitiés de 16 pixels
+ * (pshufb travaille dans chaque voie de 128 bits) ; le calcul et les écritures se font sur 256 bits.
+ * Les unpack/pack AVX2 opèrent aussi voie par voie : l'ordre des pixels est conservé.
+ */
+PCB_TARGET("avx2")
+void rowAvx2(const uchar* bgr, uchar* gray, uchar* dark, int width, int darkMaxValue)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i darkMax = _mm256_set1_epi8(static_cast<char>(darkMaxValue));
+    int x = 0;
+    for (; x <= width - 32; x += 32) {
+        __m128i b0, g0, r0, b1, g1, r1;
+        deinterleave16(bgr + 3 * x, b0, g0, r0);
+        deinterleave16(bgr + 3 * x + 48, b1, g1, r1);
+        const __m256i b = _mm256_inserti128_si256(_mm256_castsi128_si256(b0), b1, 1);
+        const __m256i g = _mm256_inserti128_si256(_mm256_castsi128_si256(g0), g1, 1);
+        const __m256i r = _mm256_inserti128_si256(_mm256_castsi128_si256(r0), r1, 1);
+        if (gray) {
+            const __m256i lo = gray16(_mm256_unpacklo_epi8(b, zero), _mm256_unpacklo_epi8(g, zero), _mm256_unpacklo_epi8(r, zero));
+            const __m256i hi = gray16(_mm256_unpackhi_epi8(b, zero), _mm256_unpackhi_epi8(g, zero), _mm256_unpackhi_epi8(r, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gray + x), _mm256_packus_epi16(lo, hi));
+        }
+        if (dark) {
+            const __m256i v = _mm256_max_epu8(_mm256_max_epu8(b, g), r);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dark + x), _mm256_cmpeq_epi8(_mm256_min_epu8(v, darkMax), v));
+        }
+    }
+    rowScalar(bgr, gray, dark, x, width, darkMaxValue);
+}
+
+#endif // PCB_X86_SIMD
+
+// Remplace Auto, ou un chemin non disponible, par le meilleur chemin disponible
+SimdPath resolvePath(SimdPath path)
+{
+    if (path != SimdPath::Auto && isSimdPathSupported(path)) {
+        return path;
+    }
+    if (isSimdPathSupported(SimdPath::Avx2)) return SimdPath::Avx2;
+    if (isSimdPathSupported(SimdPath::Ssse3)) return SimdPath::Ssse3;
+    return SimdPath::Scalar;
+}
+
+} // namespace
+
+const char* simdPathName(SimdPath path)
+{
+    switch (path) {
+    case SimdPath::Auto:   return "auto";
+    case SimdPath::Scalar: return "scalar";
+    case SimdPath::Ssse3:  return "ssse3";
+    case SimdPath::Avx2:   return "avx2";
+    }
+    return "unknown";
+}
+
+bool isSimdPathSupported(SimdPath path)
+{
+    switch (path) {
+    case SimdPath::Auto:
+    case SimdPath::Scalar:
+        return true;
+#ifdef PCB_X86_SIMD
+    case SimdPath::Ssse3:
+        return cv::checkHardwareSupport(CV_CPU_SSSE3);
+    case SimdPath::Avx2:
+        return cv::checkHardwareSupport(CV_CPU_AVX2);
+#else
+    case SimdPath::Ssse3:
+    case SimdPath::Avx2:
+        return false;
+#endif
+    }
+    return false;
+}
+
+/**
+ * @brief Niveaux de gris et pixels sombres en une passe (voir bgrkernels.h).
+ */
+void bgrToGrayAndDarkPixels(const cv::Mat& bgr, cv::Mat* gray, cv::Mat* darkPixels, int darkMaxValue, SimdPath path)
+{
+    if (bgr.type() != CV_8UC3) {
+        // Cas non prévu par les noyaux : chemin OpenCV d'origine
+        if (gray) cv::cvtColor(bgr, *gray, cv::COLOR_BGR2GRAY);
+        if (darkPixels) {
+            cv::Mat hsv;
+            cv::cvtColor(bgr, hsv, cv::COLOR_BGR2HSV);
+            cv::inRange(hsv, cv::Scalar(0, 0, 0), cv::Scalar(180, 255, darkMaxValue), *darkPixels);
+        }
+        return;
+    }
+    if (gray) gray->create(bgr.size(), CV_8UC1);
+    if (darkPixels) darkPixels->create(bgr.size(), CV_8UC1);
+    if (!gray && !darkPixels) return;
+
+    const SimdPath resolved = resolvePath(path);
+    const int threshold = std::max(0, std::min(255, darkMaxValue));
+    const int width = bgr.cols;
+    // Bandes de lignes traitées en parallèle (chaque ligne est indépendante)
+    cv::parallel_for_(cv::Range(0, bgr.rows), [&](const cv::Range& rows) {
+        for (int y = rows.start; y < rows.end; ++y) {
+            const uchar* src = bgr.ptr<uchar>(y);
+            uchar* grayRow = gray ? gray->ptr<uchar>(y) : nullptr;
+            uchar* darkRow = darkPixels ? darkPixels->ptr<uchar>(y) : nullptr;
+            switch (resolved) {
+#ifdef PCB_X86_SIMD
+            case SimdPath::Avx2:
+                rowAvx2(src, grayRow, darkRow, width, threshold);
+                break;
+            case SimdPath::Ssse3:
+                rowSsse3(src, grayRow, darkRow, width, threshold);
+                break;
+#endif
+            default:
+                rowScalar(src, grayRow, darkRow, 0, width, threshold);
+                break;
+            }
+        }
+    });
+}
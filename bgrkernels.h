@@ -0,0 +1,47 @@
+// bgrkernels.h
+#ifndef BGRKERNELS_H
+#define BGRKERNELS_H
+
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Jeu d'instructions utilisé par les noyaux de bgrkernels.
+ * Auto choisit le plus rapide disponible sur le processeur (AVX2, puis SSSE3, puis scalaire).
+ */
+enum class SimdPath
+{
+    Auto,
+    Scalar,
+    Ssse3,
+    Avx2
+};
+
+/**
+ * @brief Nom lisible d'un chemin ("auto", "scalar", "ssse3", "avx2").
+ */
+const char* simdPathName(SimdPath path);
+
+/**
+ * @brief Vrai si le chemin peut être exécuté sur ce processeur (Auto et Scalar le sont toujours).
+ */
+bool isSimdPathSupported(SimdPath path);
+
+/**
+ * @brief Calcule en une seule lecture de l'image BGR les niveaux de gris et le masque des pixels sombres.
+ *
+ * - `gray` est identique à cv::cvtColor(bgr, gray, COLOR_BGR2GRAY) : (1868 B + 9617 G + 4899 R + 2^13) >> 14.
+ * - `darkPixels` est identique à cvtColor(COLOR_BGR2HSV) suivi de inRange((0,0,0), (180,255,darkMaxValue)) :
+ *   H et S n'étant pas contraints, seul V = max(B, G, R) <= darkMaxValue compte (255 si sombre, 0 sinon).
+ *
+ * Le travail est réparti par bandes de lignes avec cv::parallel_for_ (respecte cv::setNumThreads()).
+ * Une image qui n'est pas en CV_8UC3 passe par cvtColor/inRange.
+ * @param bgr L'image couleur d'entrée (CV_8UC3).
+ * @param gray Sortie niveaux de gris (CV_8UC1), ou nullptr si inutile.
+ * @param darkPixels Sortie masque des pixels sombres (CV_8UC1), ou nullptr si inutile.
+ * @param darkMaxValue Valeur V maximale d'un pixel sombre.
+ * @param path Jeu d'instructions à utiliser (Auto en production ; les autres servent à la vérification).
+ */
+void bgrToGrayAndDarkPixels(const cv::Mat& bgr, cv::Mat* gray, cv::Mat* darkPixels, int darkMaxValue,
+                            SimdPath path = SimdPath::Auto);
+
+#endif // BGRKERNELS_H
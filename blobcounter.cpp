@@ -0,0 +1,149 @@
+// blobcounter.cpp
+#include "blobcounter.h"
+
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Plages de l'image : pour chaque ligne, suites de pixels de même valeur, de gauche à droite.
+ * Deux plages consécutives d'une même ligne ont donc toujours des valeurs différentes.
+ */
+struct Runs
+{
+    std::vector<int> start;        // Première colonne
+    std::vector<int> end;          // Colonne suivant la dernière (intervalle [start, end[)
+    std::vector<unsigned char> on; // 1 : pixels non nuls, 0 : pixels nuls
+    std::vector<unsigned char> edge; // 1 : la plage touche le bord de l'image
+    std::vector<std::size_t> rowBegin; // Indice de la première plage de chaque ligne (+ fin)
+};
+
+int findRoot(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]]; // Compression de chemin par moitiés
+        i = parent[i];
+    }
+    return i;
+}
+
+void unite(std::vector<int>& parent, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a != b) {
+        parent[a < b ? b : a] = a < b ? a : b; // La plus petite étiquette devient la racine
+    }
+}
+
+/**
+ * @brief Parcourt les paires (plage de la ligne courante, plage de la ligne précédente) qui se touchent
+ * en 8-connexité, c'est-à-dire dont les intervalles de colonnes, agrandis d'une colonne, se chevauchent.
+ */
+template <typename Visit>
+void forEachTouchingPair(const Runs& runs, std::size_t prevBegin, std::size_t prevEnd,
+                         std::size_t curBegin, std::size_t curEnd, Visit visit)
+{
+    std::size_t j = prevBegin;
+    for (std::size_t i = curBegin; i < curEnd; ++i) {
+        // Les plages précédentes terminées avant la colonne start-1 ne toucheront plus aucune plage courante
+        while (j < prevEnd && runs.end[j] < runs.start[i]) ++j;
+        for (std::size_t k = j; k < prevEnd && runs.start[k] <= runs.end[i]; ++k) {
+            visit(static_cast<int>(i), static_cast<int>(k));
+        }
+    }
+}
+
+// Vrai si les deux plages ont au moins une colonne en commun (voisines en 4-connexité d'une ligne à l'autre)
+bool sharesColumn(const Runs& runs, int a, int b)
+{
+    return runs.start[a] < runs.end[b] && runs.start[b] < runs.end[a];
+}
+
+} // namespace
+
+/**
+ * @brief Compte les contours externes des deux polarités (voir blobcounter.h).
+ */
+BlobCounts countExternalBlobs(const cv::Mat& mask)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+    BlobCounts counts;
+    if (mask.empty()) {
+        return counts;
+    }
+    const int width = mask.cols, height = mask.rows;
+
+    // 1. Découpage en plages et regroupement : 8-connexité (objets) et 4-connexité (fonds)
+    Runs runs;
+    runs.rowBegin.reserve(height + 1);
+    std::vector<int> parent8, parent4;
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row = mask.ptr<unsigned char>(y);
+        const std::size_t begin = runs.start.size();
+        runs.rowBegin.push_back(begin);
+        for (int x = 0; x < width;) {
+            const unsigned char value = row[x] != 0;
+            const int start = x;
+            while (x < width && (row[x] != 0) == value) ++x;
+            const int index = static_cast<int>(runs.start.size());
+            runs.start.push_back(start);
+            runs.end.push_back(x);
+            runs.on.push_back(value);
+            runs.edge.push_back(y == 0 || y == height - 1 || start == 0 || x == width);
+            parent8.push_back(index);
+            parent4.push_back(index);
+        }
+        if (y > 0) {
+            forEachTouchingPair(runs, runs.rowBegin[y - 1], begin, begin, runs.start.size(), [&](int i, int k) {
+                if (runs.on[i] == runs.on[k]) {
+                    unite(parent8, i, k);
+                    if (sharesColumn(runs, i, k)) unite(parent4, i, k);
+                }
+            });
+        }
+    }
+    runs.rowBegin.push_back(runs.start.size());
+
+    const int count = static_cast<int>(runs.start.size());
+    std::vector<int> root8(count), root4(count);
+    for (int i = 0; i < count; ++i) {
+        root8[i] = findRoot(parent8, i);
+        root4[i] = findRoot(parent4, i);
+    }
+
+    // 2. Fonds extérieurs : composantes 4-connexes qui touchent le bord (reliées entre elles par l'extérieur)
+    std::vector<unsigned char> outer(count, 0);
+    for (int i = 0; i < count; ++i) {
+        if (runs.edge[i]) outer[root4[i]] = 1;
+    }
+
+    // 3. Objets non enfermés : touchent le bord, ou un fond extérieur (plage voisine sur la ligne,
+    //    ou plage d'une ligne voisine ayant une colonne en commun)
+    std::vector<unsigned char> external(count, 0);
+    for (int i = 0; i < count; ++i) {
+        if (runs.edge[i]) external[root8[i]] = 1;
+    }
+    for (int y = 0; y < height; ++y) {
+        const std::size_t begin = runs.rowBegin[y], end = runs.rowBegin[y + 1];
+        for (std::size_t i = begin + 1; i < end; ++i) {
+            if (outer[root4[i - 1]]) external[root8[i]] = 1;
+            if (outer[root4[i]]) external[root8[i - 1]] = 1;
+        }
+        if (y > 0) {
+            forEachTouchingPair(runs, runs.rowBegin[y - 1], begin, begin, end, [&](int i, int k) {
+                if (runs.on[i] != runs.on[k] && sharesColumn(runs, i, k)) {
+                    if (outer[root4[k]]) external[root8[i]] = 1;
+                    if (outer[root4[i]]) external[root8[k]] = 1;
+                }
+            });
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (root8[i] == i && external[i]) {
+            ++(runs.on[i] ? counts.foreground : counts.background);
+        }
+    }
+    return counts;
+}
@@ -0,0 +1,31 @@
+// blobcounter.h
+#ifndef BLOBCOUNTER_H
+#define BLOBCOUNTER_H
+
+#include <cstddef>
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Nombre de contours externes d'un masque binaire et de son inverse.
+ */
+struct BlobCounts
+{
+    std::size_t foreground = 0; // Contours externes du masque (pixels non nuls)
+    std::size_t background = 0; // Contours externes du masque inversé (pixels nuls)
+};
+
+/**
+ * @brief Compte, sans construire de liste de points, ce que findContours(RETR_EXTERNAL) trouverait
+ * sur le masque et sur son inverse.
+ *
+ * Un contour externe correspond à un objet 8-connexe qui n'est enfermé dans aucun autre : il touche le bord
+ * de l'image ou le fond "extérieur" (composante 4-connexe du fond reliée au bord ; findContours considère
+ * l'extérieur de l'image comme du fond). Les deux polarités sont traitées en une seule lecture : l'image est
+ * découpée en plages (suites de pixels de même valeur sur une ligne), regroupées par union-find en
+ * 8-connexité (objets) et en 4-connexité (fonds) pour chacune des deux valeurs.
+ * @param mask Masque CV_8UC1.
+ * @return Les deux nombres de contours externes.
+ */
+BlobCounts countExternalBlobs(const cv::Mat& mask);
+
+#endif // BLOBCOUNTER_H
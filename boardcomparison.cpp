@@ -0,0 +1,288 @@
+// boardcomparison.cpp
+#include "boardcomparison.h"
+#include <algorithm>              // std::sort, std::max, std::min
+#include <chrono>
+#include <cmath>                  // std::atan2, std::hypot, std::abs
+#include <string>
+#include <opencv2/imgproc.hpp>    // phaseCorrelate, createHanningWindow, dessin
+#include <opencv2/video/tracking.hpp> // findTransformECC
+#include "pcbpipeline.h"          // PcbPipeline::toGray
+
+using namespace cv;
+
+namespace {
+
+const int kMinPyramidSide = 16; // Les pyramides descendent jusque-là : les niveaux utiles existent pour les deux images
+
+double millisecondsSince(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+Mat toGrayImage(const Mat& image)
+{
+    if (image.channels() == 3) {
+        return PcbPipeline::toGray(image);
+    }
+    if (image.channels() == 4) {
+        Mat gray;
+        cvtColor(image, gray, COLOR_BGRA2GRAY);
+        return gray;
+    }
+    return image;
+}
+
+// Premier niveau dont le plus grand côté tient dans `side` (le dernier niveau sinon)
+int levelForSide(const ImagePyramid& pyramid, int side)
+{
+    for (int level = 0; level < pyramid.levelCount(); ++level) {
+        if (std::max(pyramid.level(level).cols, pyramid.level(level).rows) <= side) {
+            return level;
+        }
+    }
+    return pyramid.levelCount() - 1;
+}
+
+Matx33d toHomogeneous(const Matx23d& m)
+{
+    return Matx33d(m(0, 0), m(0, 1), m(0, 2), m(1, 0), m(1, 1), m(1, 2), 0, 0, 1);
+}
+
+/**
+ * @brief Ramène en pixels pleine résolution une transformation calculée sur un niveau de la pyramide.
+ * Le pixel x d'un niveau réduit d'un facteur s (INTER_AREA) couvre les pixels [s x, s (x + 1)[ de la source :
+ * son centre est en s x + (s - 1) / 2. La transformation pleine résolution est S T S^-1.
+ */
+Matx23d toFullResolution(const Matx23d& atLevel, Size fullSize, Size levelSize)
+{
+    const double sx = static_cast<double>(fullSize.width) / levelSize.width;
+    const double sy = static_cast<double>(fullSize.height) / levelSize.height;
+    const Matx33d scale(sx, 0, (sx - 1) / 2, 0, sy, (sy - 1) / 2, 0, 0, 1);
+    const Matx33d full = scale * toHomogeneous(atLevel) * scale.inv();
+    return Matx23d(full(0, 0), full(0, 1), full(0, 2), full(1, 0), full(1, 1), full(1, 2));
+}
+
+Point2d apply(const Matx23d& m, const Point2d& p)
+{
+    return Point2d(m(0, 0) * p.x + m(0, 1) * p.y + m(0, 2), m(1, 0) * p.x + m(1, 1) * p.y + m(1, 2));
+}
+
+Point2d centerOf(const Rect& rect)
+{
+    return Point2d(rect.x + rect.width / 2.0, rect.y + rect.height / 2.0);
+}
+
+// Rectangle de même taille, centré sur `center`
+Rect rectAt(const Rect& rect, const Point2d& center)
+{
+    return Rect(cvRound(center.x - rect.width / 2.0), cvRound(center.y - rect.height / 2.0), rect.width, rect.height);
+}
+
+// Tailles voisines : écart relatif limité, avec une marge de 2 px pour les petits composants
+bool similarSize(int a, int b, double tolerance)
+{
+    return std::abs(a - b) <= std::max(2.0, tolerance * std::max(a, b));
+}
+
+} // namespace
+
+double BoardRegistration::angleDegrees() const
+{
+    return std::atan2(testToReference(1, 0), testToReference(0, 0)) * 180.0 / CV_PI;
+}
+
+GoldenBoard::GoldenBoard(const RegistrationOptions& registration, const ComparisonOptions& comparison)
+    : m_registrationOptions(registration)
+    , m_comparisonOptions(comparison)
+{
+}
+
+/**
+ * @brief Prépare la référence : pyramide en niveaux de gris et index spatial des composants
+ * (cases de la taille du rayon de recherche : une recherche ne parcourt que quelques cases).
+ */
+void GoldenBoard::setReference(const cv::Mat& bgr, const std::vector<cv::Rect>& rects)
+{
+    CV_Assert(!bgr.empty());
+    m_size = bgr.size();
+    m_pyramid.build(toGrayImage(bgr), kMinPyramidSide);
+    m_coarseLevel = levelForSide(m_pyramid, m_registrationOptions.coarseSide);
+    m_fineLevel = std::min(levelForSide(m_pyramid, m_registrationOptions.fineSide), m_coarseLevel);
+    m_rects = rects;
+    m_index = SpatialIndex(std::max(16, cvRound(2 * m_comparisonOptions.searchRadius)));
+    for (size_t i = 0; i < m_rects.size(); ++i) {
+        m_index.insert(static_cast<int>(i), m_rects[i]);
+    }
+}
+
+/**
+ * @brief Recalage grossier puis fin (voir la description de la classe).
+ * Les deux images doivent avoir à peu près la même taille : les niveaux de même indice ont alors la même
+ * échelle. Sur chaque niveau, seule la partie commune aux deux images (à partir du coin haut gauche) est utilisée.
+ */
+BoardRegistration GoldenBoard::registerImage(const cv::Mat& testBgr) const
+{
+    CV_Assert(!empty() && !testBgr.empty());
+    ImagePyramid testPyramid;
+    testPyramid.build(toGrayImage(testBgr), kMinPyramidSide);
+    if (testPyramid.levelCount() <= m_coarseLevel) {
+        CV_Error(Error::StsBadSize, "golden board: the test image is much smaller than the reference");
+    }
+    auto commonPart = [&](int level, Mat& reference, Mat& test) {
+        const Mat& r = m_pyramid.level(level);
+        const Mat& t = testPyramid.level(level);
+        const Rect common(0, 0, std::min(r.cols, t.cols), std::min(r.rows, t.rows));
+        reference = r(common);
+        test = t(common);
+    };
+
+    // 1. Translation grossière : corrélation de phase (fenêtre de Hann contre les effets de bord)
+    BoardRegistration registration;
+    Mat reference, test, reference32, test32, window;
+    commonPart(m_coarseLevel, reference, test);
+    reference.convertTo(reference32, CV_32F);
+    test.convertTo(test32, CV_32F);
+    createHanningWindow(window, reference32.size(), CV_32F);
+    const Point2d shift = phaseCorrelate(reference32, test32, window, &registration.phaseResponse);
+
+    // 2. Affinage ECC sur le niveau fin, initialisé par la translation ramenée à ce niveau.
+    // La matrice de l'ECC envoie les points de la référence (modèle) sur ceux de l'image testée.
+    const Size coarseSize = m_pyramid.level(m_coarseLevel).size();
+    const Size fineSize = m_pyramid.level(m_fineLevel).size();
+    const double toFine = static_cast<double>(fineSize.width) / coarseSize.width;
+    Mat warp = (Mat_<float>(2, 3) << 1, 0, static_cast<float>(shift.x * toFine), 0, 1, static_cast<float>(shift.y * toFine));
+    Matx23d referenceToTest(1, 0, shift.x * toFine, 0, 1, shift.y * toFine);
+    commonPart(m_fineLevel, reference, test);
+    try {
+        const TermCriteria criteria(TermCriteria::COUNT + TermCriteria::EPS,
+                                    m_registrationOptions.eccIterations, m_registrationOptions.eccEpsilon);
+        registration.eccCorrelation = findTransformECC(reference, test, warp,
+                                                       m_registrationOptions.rotation ? MOTION_EUCLIDEAN : MOTION_TRANSLATION,
+                                                       criteria, noArray(), 5);
+        warp.convertTo(warp, CV_64F);
+        referenceToTest = Matx23d(warp.ptr<double>());
+        registration.refined = true;
+    } catch (const cv::Exception&) {
+        // Pas de convergence (image uniforme, cartes trop différentes) : la translation grossière reste valable
+    }
+
+    registration.referenceToTest = toFullResolution(referenceToTest, m_size, fineSize);
+    invertAffineTransform(registration.referenceToTest, registration.testToReference);
+    return registration;
+}
+
+/**
+ * @brief Appariement glouton : toutes les paires candidates (centres à moins de searchRadius, tailles voisines)
+ * sont triées par distance, puis retenues de la plus proche à la plus lointaine si aucun des deux composants
+ * n'est déjà apparié.
+ */
+BoardComparison GoldenBoard::diffComponents(const std::vector<cv::Rect>& testRects,
+                                            const BoardRegistration& registration) const
+{
+    struct Candidate { double distance; int reference; int test; };
+    const ComparisonOptions& options = m_comparisonOptions;
+    const double radius = options.searchRadius;
+
+    std::vector<Candidate> candidates;
+    std::vector<Point2d> testCenters(testRects.size());
+    for (size_t j = 0; j < testRects.size(); ++j) {
+        const Point2d center = apply(registration.testToReference, centerOf(testRects[j]));
+        testCenters[j] = center;
+        // Un composant dont le centre est à moins de `radius` contient ce centre : il coupe ce carré
+        const Rect area(cvFloor(center.x - radius), cvFloor(center.y - radius),
+                        cvCeil(2 * radius) + 1, cvCeil(2 * radius) + 1);
+        for (int i : m_index.queryRect(area)) {
+            const Rect& ref = m_rects[i];
+            const Point2d offset = center - centerOf(ref);
+            const double distance = std::hypot(offset.x, offset.y);
+            if (distance <= radius && similarSize(ref.width, testRects[j].width, options.sizeTolerance)
+                && similarSize(ref.height, testRects[j].height, options.sizeTolerance)) {
+                candidates.push_back({ distance, i, static_cast<int>(j) });
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return a.reference != b.reference ? a.reference < b.reference : a.test < b.test;
+    });
+
+    BoardComparison comparison;
+    comparison.registration = registration;
+    std::vector<bool> referenceUsed(m_rects.size(), false), testUsed(testRects.size(), false);
+    for (const Candidate& candidate : candidates) {
+        if (referenceUsed[candidate.reference] || testUsed[candidate.test]) {
+            continue;
+        }
+        referenceUsed[candidate.reference] = testUsed[candidate.test] = true;
+        ComponentPair pair;
+        pair.reference = candidate.reference;
+        pair.test = candidate.test;
+        pair.offset = testCenters[candidate.test] - centerOf(m_rects[candidate.reference]);
+        (candidate.distance > options.positionTolerance ? comparison.shifted : comparison.matched).push_back(pair);
+    }
+    for (size_t i = 0; i < m_rects.size(); ++i) {
+        if (!referenceUsed[i]) comparison.missing.push_back(static_cast<int>(i));
+    }
+    for (size_t j = 0; j < testRects.size(); ++j) {
+        if (!testUsed[j]) comparison.extra.push_back(static_cast<int>(j));
+    }
+    return comparison;
+}
+
+BoardComparison GoldenBoard::compare(const cv::Mat& testBgr, const std::vector<cv::Rect>& testRects) const
+{
+    auto start = std::chrono::steady_clock::now();
+    const BoardRegistration registration = registerImage(testBgr);
+    const double registrationMs = millisecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    BoardComparison comparison = diffComponents(testRects, registration);
+    comparison.diffMs = millisecondsSince(start);
+    comparison.registrationMs = registrationMs;
+    return comparison;
+}
+
+/**
+ * @brief Les composants de la référence sont dessinés à leur place attendue dans l'image testée
+ * (centre transformé, même taille). L'épaisseur des traits suit la taille de l'image.
+ */
+cv::Mat GoldenBoard::renderOverlay(const cv::Mat& testBgr, const std::vector<cv::Rect>& testRects,
+                                   const BoardComparison& comparison) const
+{
+    Mat overlay;
+    if (testBgr.channels() == 1) {
+        cvtColor(testBgr, overlay, COLOR_GRAY2BGR);
+    } else {
+        overlay = testBgr.clone();
+    }
+    const int thickness = std::max(1, cvRound(std::max(overlay.cols, overlay.rows) / 1500.0));
+    const Scalar matchedColor(0, 200, 0), missingColor(0, 0, 255), extraColor(255, 0, 255), shiftedColor(0, 255, 255);
+    const Matx23d& toTest = comparison.registration.referenceToTest;
+
+    for (const ComponentPair& pair : comparison.matched) {
+        rectangle(overlay, testRects[pair.test], matchedColor, 1);
+    }
+    for (int i : comparison.missing) {
+        rectangle(overlay, rectAt(m_rects[i], apply(toTest, centerOf(m_rects[i]))), missingColor, 2 * thickness);
+    }
+    for (int j : comparison.extra) {
+        rectangle(overlay, testRects[j], extraColor, 2 * thickness);
+    }
+    for (const ComponentPair& pair : comparison.shifted) {
+        const Rect& actual = testRects[pair.test];
+        const Point2d expected = apply(toTest, centerOf(m_rects[pair.reference]));
+        rectangle(overlay, rectAt(m_rects[pair.reference], expected), shiftedColor, 1);
+        rectangle(overlay, actual, shiftedColor, 2 * thickness);
+        arrowedLine(overlay, Point(cvRound(expected.x), cvRound(expected.y)),
+                    Point(cvRound(centerOf(actual).x), cvRound(centerOf(actual).y)), shiftedColor, thickness);
+    }
+
+    const std::string legend = "missing " + std::to_string(comparison.missing.size())
+                               + "  extra " + std::to_string(comparison.extra.size())
+                               + "  shifted " + std::to_string(comparison.shifted.size());
+    const double fontScale = 0.6 * thickness;
+    putText(overlay, legend, Point(10 * thickness, 30 * thickness), FONT_HERSHEY_SIMPLEX, fontScale,
+            Scalar(0, 0, 0), 4 * thickness);
+    putText(overlay, legend, Point(10 * thickness, 30 * thickness), FONT_HERSHEY_SIMPLEX, fontScale,
+            Scalar(255, 255, 255), thickness);
+    return overlay;
+}
@@ -0,0 +1,144 @@
+// boardcomparison.h
+#ifndef BOARDCOMPARISON_H
+#define BOARDCOMPARISON_H
+
+#include <vector>
+#include <opencv2/core.hpp>
+#include "imagepyramid.h"
+#include "spatialindex.h"
+
+/**
+ * @brief Réglages du recalage d'une image testée sur la carte de référence.
+ */
+struct RegistrationOptions
+{
+    int coarseSide = 512;      // Corrélation de phase sur le premier niveau de la pyramide qui tient dans ce côté
+    int fineSide = 1024;       // Affinage ECC sur le premier niveau qui tient dans ce côté
+    bool rotation = true;      // ECC euclidien (rotation + translation) ; faux : translation seule
+    int eccIterations = 30;    // Itérations maximales de l'ECC
+    double eccEpsilon = 1e-4;  // Arrêt de l'ECC quand la correction devient plus petite
+};
+
+/**
+ * @brief Transformation entre la carte de référence et l'image testée, en pixels pleine résolution.
+ */
+struct BoardRegistration
+{
+    cv::Matx23d referenceToTest = cv::Matx23d(1, 0, 0, 0, 1, 0); // Point de la référence -> même point dans l'image testée
+    cv::Matx23d testToReference = cv::Matx23d(1, 0, 0, 0, 1, 0); // Inverse
+    double phaseResponse = 0.0;  // Netteté du pic de corrélation de phase (0 à 1) : faible, le recalage est douteux
+    double eccCorrelation = 0.0; // Corrélation finale de l'ECC (0 si l'ECC n'a pas convergé)
+    bool refined = false;        // Faux : seule la translation grossière (corrélation de phase) a été trouvée
+
+    /**
+     * @brief Rotation de l'image testée par rapport à la référence, en degrés.
+     */
+    double angleDegrees() const;
+};
+
+/**
+ * @brief Tolérances de l'appariement des composants.
+ */
+struct ComparisonOptions
+{
+    double positionTolerance = 3.0; // Écart de centre (px) au-delà duquel un composant apparié est « décalé »
+    double searchRadius = 30.0;     // Écart de centre maximal (px) pour apparier deux composants
+    double sizeTolerance = 0.25;    // Écart relatif maximal de largeur et de hauteur pour apparier deux composants
+};
+
+/**
+ * @brief Composant de la référence apparié à un composant de l'image testée.
+ */
+struct ComponentPair
+{
+    int reference = -1;   // Indice dans les composants de la référence
+    int test = -1;        // Indice dans les composants de l'image testée
+    cv::Point2d offset;   // Centre du composant testé moins centre du composant de référence, repère de la référence
+};
+
+/**
+ * @brief Différences entre les composants de la référence et ceux de l'image testée.
+ */
+struct BoardComparison
+{
+    BoardRegistration registration;
+    std::vector<int> missing;            // Composants de la référence sans correspondant (indices de la référence)
+    std::vector<int> extra;              // Composants testés sans correspondant dans la référence (indices testés)
+    std::vector<ComponentPair> shifted;  // Appariés, décalés de plus de positionTolerance
+    std::vector<ComponentPair> matched;  // Appariés, à leur place
+    double registrationMs = 0.0;         // Durée du recalage (pyramide de l'image testée comprise)
+    double diffMs = 0.0;                 // Durée de l'appariement
+
+    bool identical() const { return missing.empty() && extra.empty() && shifted.empty(); }
+};
+
+/**
+ * @brief La classe GoldenBoard compare des cartes à une carte de référence (« golden board ») : composants
+ * manquants, en trop ou décalés.
+ *
+ * La référence est préparée une fois (setReference()) : pyramide de son image en niveaux de gris et index spatial
+ * de ses composants. Pour chaque carte testée, compare() :
+ *  1. recale l'image testée sur la référence, du grossier au fin : corrélation de phase sur un niveau réduit
+ *     de la pyramide (translation, même de la moitié de l'image), puis ECC sur un niveau plus fin, initialisé
+ *     par cette translation (rotation et translation sous-pixel) ; la transformation est ramenée en pixels
+ *     pleine résolution ;
+ *  2. projette les centres des composants testés dans le repère de la référence et apparie chaque composant
+ *     au plus proche composant de référence de taille voisine (appariement glouton par distance croissante ;
+ *     l'index spatial limite la recherche aux composants proches).
+ * Seules les images réduites passent par le recalage : il coûte quelques dizaines de millisecondes,
+ * une fois la pyramide construite, même sur une image de 20 MP.
+ *
+ * Les composants sont ceux que produit le pipeline (DetectionResult::rects) sur chacune des deux images,
+ * avec les mêmes paramètres. Indépendante de Qt.
+ */
+class GoldenBoard
+{
+public:
+    explicit GoldenBoard(const RegistrationOptions& registration = RegistrationOptions(),
+                         const ComparisonOptions& comparison = ComparisonOptions());
+
+    /**
+     * @brief Définit la carte de référence.
+     * @param bgr Image de la référence (couleur ou niveaux de gris).
+     * @param rects Composants détectés sur cette image.
+     */
+    void setReference(const cv::Mat& bgr, const std::vector<cv::Rect>& rects);
+
+    bool empty() const { return m_pyramid.empty(); }
+    const std::vector<cv::Rect>& referenceRects() const { return m_rects; }
+    cv::Size referenceSize() const { return m_size; }
+
+    /**
+     * @brief Recale une image sur la référence.
+     */
+    BoardRegistration registerImage(const cv::Mat& testBgr) const;
+
+    /**
+     * @brief Apparie les composants testés à ceux de la référence, avec un recalage déjà calculé.
+     */
+    BoardComparison diffComponents(const std::vector<cv::Rect>& testRects, const BoardRegistration& registration) const;
+
+    /**
+     * @brief Recale puis apparie (registerImage() puis diffComponents()), en mesurant chaque étape.
+     */
+    BoardComparison compare(const cv::Mat& testBgr, const std::vector<cv::Rect>& testRects) const;
+
+    /**
+     * @brief Dessine les différences sur une copie de l'image testée : manquants en rouge (à leur place attendue),
+     * en trop en magenta, décalés en jaune (flèche depuis la place attendue), appariés en vert fin.
+     */
+    cv::Mat renderOverlay(const cv::Mat& testBgr, const std::vector<cv::Rect>& testRects,
+                          const BoardComparison& comparison) const;
+
+private:
+    RegistrationOptions m_registrationOptions;
+    ComparisonOptions m_comparisonOptions;
+    cv::Size m_size;              // Taille de l'image de référence
+    ImagePyramid m_pyramid;       // Référence en niveaux de gris, jusqu'au niveau grossier
+    int m_coarseLevel = 0;        // Niveau de la corrélation de phase
+    int m_fineLevel = 0;          // Niveau de l'ECC
+    std::vector<cv::Rect> m_rects; // Composants de la référence
+    SpatialIndex m_index;          // Index des composants de la référence
+};
+
+#endif // BOARDCOMPARISON_H
@@ -0,0 +1,120 @@
+// boundedqueue.h
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief File bornée entre deux threads (un producteur, un consommateur), utilisée entre les étages de FrameStream.
+ * Quand la file est pleine, push() attend qu'une place se libère (contre-pression) ou, si `dropOldest` est vrai,
+ * jette l'élément le plus ancien pour garder les plus récents (flux en direct : mieux vaut sauter une trame
+ * que prendre du retard). close() termine la file : les éléments restants peuvent encore être retirés,
+ * puis pop() retourne false.
+ */
+template <class T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Ajoute un élément.
+     * @param dropOldest File pleine : jeter l'élément le plus ancien (vrai) ou attendre une place (faux).
+     * @return false si la file est fermée (l'élément n'est pas ajouté).
+     */
+    bool push(T item, bool dropOldest)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!dropOldest) {
+                m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+            }
+            if (m_closed) {
+                return false;
+            }
+            if (m_items.size() >= m_capacity) {
+                m_items.pop_front();
+                ++m_dropped;
+            }
+            m_items.push_back(std::move(item));
+        }
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Retire le plus ancien élément, en attendant qu'il y en ait un.
+     * @return false si la file est fermée et vide.
+     */
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+        return takeFront(lock, item);
+    }
+
+    /**
+     * @brief Comme pop(), en attendant au plus `timeout`.
+     * @return false si aucun élément n'est arrivé à temps (ou si la file est fermée et vide).
+     */
+    bool popFor(T& item, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait_for(lock, timeout, [this] { return m_closed || !m_items.empty(); });
+        return takeFront(lock, item);
+    }
+
+    /**
+     * @brief Ferme la file : push() échoue, pop() vide les éléments restants puis retourne false.
+     * @param discard Jeter aussi les éléments restants (arrêt immédiat).
+     */
+    void close(bool discard = false)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            if (discard) {
+                m_items.clear();
+            }
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+    std::size_t size() const { std::lock_guard<std::mutex> lock(m_mutex); return m_items.size(); }
+    std::size_t capacity() const { return m_capacity; }
+    std::uint64_t dropped() const { std::lock_guard<std::mutex> lock(m_mutex); return m_dropped; }
+    bool isFinished() const { std::lock_guard<std::mutex> lock(m_mutex); return m_closed && m_items.empty(); }
+
+private:
+    bool takeFront(std::unique_lock<std::mutex>& lock, T& item)
+    {
+        if (m_items.empty()) {
+            return false;
+        }
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    const std::size_t m_capacity;         // Nombre maximal d'éléments en attente
+    std::deque<T> m_items;                // Éléments en attente, du plus ancien au plus récent
+    mutable std::mutex m_mutex;           // Protège la file, l'état et le compteur
+    std::condition_variable m_notEmpty;   // Signalé quand un élément est ajouté (ou à la fermeture)
+    std::condition_variable m_notFull;    // Signalé quand une place se libère (ou à la fermeture)
+    std::uint64_t m_dropped = 0;          // Éléments jetés pour faire de la place (dropOldest)
+    bool m_closed = false;                // Vrai après close()
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -0,0 +1,40 @@
+// cancellationtoken.h
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Le jeton CancellationToken permet d'abandonner un traitement devenu obsolète.
+ * Il compare le numéro de génération de la demande en cours avec le dernier numéro publié
+ * par le demandeur : dès qu'une demande plus récente arrive, le jeton est considéré comme annulé.
+ * Un jeton construit par défaut n'est jamais annulé (exécution synchrone classique).
+ */
+class CancellationToken
+{
+public:
+    CancellationToken() = default;
+
+    /**
+     * @brief Construit un jeton lié à un compteur de génération.
+     * @param latestGeneration Compteur partagé, incrémenté par le demandeur à chaque nouvelle demande.
+     * @param generation Numéro de génération de la demande associée à ce jeton.
+     */
+    CancellationToken(const std::atomic<std::uint64_t>* latestGeneration, std::uint64_t generation)
+        : m_latestGeneration(latestGeneration), m_generation(generation) {}
+
+    /**
+     * @brief Indique si une demande plus récente a remplacé celle-ci.
+     */
+    bool isCancelled() const {
+        return m_latestGeneration
+               && m_latestGeneration->load(std::memory_order_relaxed) != m_generation;
+    }
+
+private:
+    const std::atomic<std::uint64_t>* m_latestGeneration = nullptr; // Compteur du demandeur (nul : jamais annulé)
+    std::uint64_t m_generation = 0;                                  // Génération de la demande associée
+};
+
+#endif // CANCELLATIONTOKEN_H
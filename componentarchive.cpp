@@ -0,0 +1,354 @@
+// componentarchive.cpp
+#include "componentarchive.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include <opencv2/imgcodecs.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// En-tête de 16 octets au début de chaque fichier : signature (8 octets), version, réservé
+const char kDataMagic[8] = { 'P', 'C', 'B', 'D', 'A', 'T', 'A', '\0' };
+const char kIndexMagic[8] = { 'P', 'C', 'B', 'I', 'N', 'D', 'X', '\0' };
+const std::uint32_t kVersion = 1;
+const std::uint64_t kHeaderSize = 16;
+
+// Les blocs commencent sur une frontière de 64 octets (ligne de cache) : les vues Raw sont bien alignées
+const std::uint64_t kBlockAlignment = 64;
+
+void setError(std::string* error, const std::string& message)
+{
+    if (error) *error = message;
+}
+
+void writeHeader(std::ofstream& file, const char (&magic)[8])
+{
+    const std::uint32_t reserved = 0;
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+    file.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+}
+
+bool checkHeader(const unsigned char* data, std::uint64_t size, const char (&magic)[8])
+{
+    if (size < kHeaderSize || std::memcmp(data, magic, sizeof(magic)) != 0) {
+        return false;
+    }
+    std::uint32_t version;
+    std::memcpy(&version, data + sizeof(magic), sizeof(version));
+    return version == kVersion;
+}
+
+// Vérifie l'en-tête d'un fichier existant (ouverture en ajout d'une archive déjà créée)
+bool checkFileHeader(const std::string& path, const char (&magic)[8])
+{
+    std::ifstream file(path, std::ios::binary);
+    unsigned char header[kHeaderSize];
+    if (!file.read(reinterpret_cast<char*>(header), kHeaderSize)) {
+        return false;
+    }
+    return checkHeader(header, kHeaderSize, magic);
+}
+
+} // namespace
+
+// =====================================================================================
+// Écriture
+// =====================================================================================
+
+/**
+ * @brief Ouvre l'archive en ajout ; crée les deux fichiers (avec leur en-tête) s'ils n'existent pas.
+ */
+bool ComponentArchiveWriter::open(const std::string& basePath, std::string* error)
+{
+    return openFiles(basePath, true, error);
+}
+
+/**
+ * @brief Crée les deux fichiers (avec leur en-tête), en écrasant une archive existante.
+ */
+bool ComponentArchiveWriter::create(const std::string& basePath, std::string* error)
+{
+    return openFiles(basePath, false, error);
+}
+
+/**
+ * @brief Ouvre les deux fichiers, en ajout (`append`) ou vidés.
+ * En ajout, une entrée d'index tronquée par une écriture interrompue est écartée avant d'ajouter la suite.
+ */
+bool ComponentArchiveWriter::openFiles(const std::string& basePath, bool append, std::string* error)
+{
+    close();
+    const std::string dataFile = dataPath(basePath);
+    const std::string indexFile = indexPath(basePath);
+
+    std::error_code ec;
+    const bool exists = append && fs::exists(dataFile, ec) && fs::exists(indexFile, ec);
+    if (exists) {
+        if (!checkFileHeader(dataFile, kDataMagic) || !checkFileHeader(indexFile, kIndexMagic)) {
+            setError(error, "Not a component archive (or unsupported version): " + basePath);
+            return false;
+        }
+        // Écarte une entrée d'index incomplète pour que les suivantes restent alignées
+        const std::uint64_t indexSize = fs::file_size(indexFile, ec);
+        const std::uint64_t complete = kHeaderSize + (indexSize - kHeaderSize) / sizeof(ComponentRecord) * sizeof(ComponentRecord);
+        if (!ec && complete != indexSize) {
+            fs::resize_file(indexFile, complete, ec);
+        }
+    }
+
+    const auto mode = std::ios::binary | (exists ? std::ios::app : std::ios::trunc);
+    m_data.open(dataFile, mode);
+    m_index.open(indexFile, mode);
+    if (!isOpen()) {
+        close();
+        setError(error, "Cannot open component archive for writing: " + basePath);
+        return false;
+    }
+    if (!exists) {
+        writeHeader(m_data, kDataMagic);
+        writeHeader(m_index, kIndexMagic);
+        m_data.flush();
+        m_index.flush();
+    }
+    m_dataSize = fs::file_size(dataFile, ec);
+    if (ec) {
+        close();
+        setError(error, "Cannot read archive size: " + ec.message());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Ferme les deux fichiers.
+ */
+void ComponentArchiveWriter::close()
+{
+    if (m_data.is_open()) m_data.close();
+    if (m_index.is_open()) m_index.close();
+    m_dataSize = 0;
+}
+
+/**
+ * @brief Ajoute un composant brut : ses lignes sont écrites bout à bout (la ROI n'a pas besoin d'être contiguë).
+ */
+bool ComponentArchiveWriter::appendRaw(int id, const cv::Rect& box, double area, const cv::Mat& roi)
+{
+    if (!isOpen() || roi.empty()) {
+        return false;
+    }
+    const std::size_t rowBytes = roi.cols * roi.elemSize();
+    std::vector<const unsigned char*> rows(roi.rows);
+    for (int y = 0; y < roi.rows; ++y) {
+        rows[y] = roi.ptr<unsigned char>(y);
+    }
+
+    ComponentRecord record = {};
+    record.id = static_cast<std::uint32_t>(id);
+    record.encoding = static_cast<std::uint32_t>(ArchiveEncoding::Raw);
+    record.x = box.x; record.y = box.y; record.width = roi.cols; record.height = roi.rows;
+    record.cvType = roi.type();
+    record.rowBytes = static_cast<std::uint32_t>(rowBytes);
+    record.area = area;
+    return writeBlock(record, rows.data(), rows.size(), rowBytes);
+}
+
+/**
+ * @brief Ajoute un composant déjà encodé (un seul bloc d'octets).
+ */
+bool ComponentArchiveWriter::appendEncoded(int id, const cv::Rect& box, double area, int cvType,
+                                           ArchiveEncoding encoding, const std::vector<unsigned char>& blob)
+{
+    if (!isOpen() || blob.empty()) {
+        return false;
+    }
+    ComponentRecord record = {};
+    record.id = static_cast<std::uint32_t>(id);
+    record.encoding = static_cast<std::uint32_t>(encoding);
+    record.x = box.x; record.y = box.y; record.width = box.width; record.height = box.height;
+    record.cvType = cvType;
+    record.rowBytes = 0;
+    record.area = area;
+    const unsigned char* data = blob.data();
+    return writeBlock(record, &data, 1, blob.size());
+}
+
+/**
+ * @brief Écrit le bloc (aligné sur 64 octets) puis, une fois les données sur disque, son entrée d'index.
+ */
+bool ComponentArchiveWriter::writeBlock(ComponentRecord& record, const unsigned char* const* rows,
+                                        std::size_t rowCount, std::size_t rowBytes)
+{
+    // Bourrage jusqu'à la prochaine frontière d'alignement
+    static const char padding[kBlockAlignment] = {};
+    const std::uint64_t padBytes = (kBlockAlignment - m_dataSize % kBlockAlignment) % kBlockAlignment;
+    m_data.write(padding, static_cast<std::streamsize>(padBytes));
+
+    record.offset = m_dataSize + padBytes;
+    record.size = static_cast<std::uint64_t>(rowCount) * rowBytes;
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        m_data.write(reinterpret_cast<const char*>(rows[i]), static_cast<std::streamsize>(rowBytes));
+    }
+    m_data.flush();
+    if (!m_data) {
+        return false;
+    }
+    m_dataSize = record.offset + record.size;
+
+    m_index.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    m_index.flush();
+    return static_cast<bool>(m_index);
+}
+
+// =====================================================================================
+// Lecture
+// =====================================================================================
+
+/**
+ * @brief Projection en lecture seule d'un fichier entier.
+ */
+struct ComponentArchiveReader::Mapping
+{
+    const unsigned char* data = nullptr;
+    std::uint64_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    bool map(const std::string& path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+        size = static_cast<std::uint64_t>(fileSize.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        size = static_cast<std::uint64_t>(st.st_size);
+        void* address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // La projection reste valide après la fermeture du descripteur
+        if (address == MAP_FAILED) return false;
+        data = static_cast<const unsigned char*>(address);
+        return true;
+#endif
+    }
+
+    ~Mapping()
+    {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) ::munmap(const_cast<unsigned char*>(data), size);
+#endif
+    }
+};
+
+ComponentArchiveReader::ComponentArchiveReader() = default;
+ComponentArchiveReader::~ComponentArchiveReader() = default;
+
+/**
+ * @brief Projette le fichier de données et charge les entrées d'index valides.
+ */
+bool ComponentArchiveReader::open(const std::string& basePath, std::string* error)
+{
+    close();
+    auto mapping = std::make_unique<Mapping>();
+    if (!mapping->map(ComponentArchiveWriter::dataPath(basePath))
+        || !checkHeader(mapping->data, mapping->size, kDataMagic)) {
+        setError(error, "Cannot map component archive data: " + ComponentArchiveWriter::dataPath(basePath));
+        return false;
+    }
+
+    // L'index est petit (64 octets par composant) : il est simplement lu en mémoire
+    std::ifstream index(ComponentArchiveWriter::indexPath(basePath), std::ios::binary);
+    unsigned char header[kHeaderSize];
+    if (!index.read(reinterpret_cast<char*>(header), kHeaderSize) || !checkHeader(header, kHeaderSize, kIndexMagic)) {
+        setError(error, "Cannot read component archive index: " + ComponentArchiveWriter::indexPath(basePath));
+        return false;
+    }
+    ComponentRecord record;
+    while (index.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.offset + record.size > mapping->size) {
+            break; // Données manquantes (archive tronquée) : les entrées suivantes sont ignorées
+        }
+        m_records.push_back(record);
+    }
+    m_mapping = std::move(mapping);
+    return true;
+}
+
+/**
+ * @brief Libère la projection et l'index.
+ */
+void ComponentArchiveReader::close()
+{
+    m_mapping.reset();
+    m_records.clear();
+}
+
+/**
+ * @brief Retourne un pointeur sur le bloc d'un composant dans la projection.
+ */
+const unsigned char* ComponentArchiveReader::blob(std::size_t index, std::size_t& size) const
+{
+    if (!m_mapping || index >= m_records.size()) {
+        size = 0;
+        return nullptr;
+    }
+    const ComponentRecord& record = m_records[index];
+    size = static_cast<std::size_t>(record.size);
+    return m_mapping->data + record.offset;
+}
+
+/**
+ * @brief Retourne les pixels d'un composant : vue directe pour Raw, image décodée sinon.
+ */
+cv::Mat ComponentArchiveReader::roi(std::size_t index) const
+{
+    std::size_t size = 0;
+    const unsigned char* data = blob(index, size);
+    if (!data) {
+        return cv::Mat();
+    }
+    const ComponentRecord& record = m_records[index];
+    if (record.encoding == static_cast<std::uint32_t>(ArchiveEncoding::Raw)) {
+        if (static_cast<std::uint64_t>(record.rowBytes) * record.height != record.size) {
+            return cv::Mat(); // Entrée incohérente
+        }
+        // Vue en lecture seule sur la projection : ne pas écrire dans cette Mat
+        return cv::Mat(record.height, record.width, record.cvType, const_cast<unsigned char*>(data), record.rowBytes);
+    }
+    const cv::Mat encoded(1, static_cast<int>(size), CV_8UC1, const_cast<unsigned char*>(data));
+    return cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+}
@@ -0,0 +1,176 @@
+// componentarchive.h
+#ifndef COMPONENTARCHIVE_H
+#define COMPONENTARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Encodage d'un composant dans l'archive.
+ */
+enum class ArchiveEncoding : std::uint32_t
+{
+    Raw = 0,  // Pixels bruts, lignes contiguës : lisibles sans copie depuis le fichier projeté en mémoire
+    Png = 1,
+    Jpeg = 2,
+    Webp = 3
+};
+
+/**
+ * @brief Entrée de l'index : une par composant, 64 octets, dans l'ordre d'ajout.
+ * Les entiers sont écrits dans l'ordre d'octets de la machine (l'archive est lue par ce même programme).
+ */
+struct ComponentRecord
+{
+    std::uint32_t id;        // Identifiant du composant (indice dans la liste de détection)
+    std::uint32_t encoding;  // ArchiveEncoding
+    std::int32_t x, y, width, height; // Boîte englobante dans l'image source
+    std::int32_t cvType;     // Type OpenCV des pixels (CV_8UC3, ...) ; utile pour Raw
+    std::uint32_t rowBytes;  // Octets par ligne pour Raw (0 sinon)
+    double area;             // Aire du contour
+    std::uint64_t offset;    // Position du bloc dans le fichier de données
+    std::uint64_t size;      // Taille du bloc en octets
+    std::uint64_t reserved;  // Réservé (0)
+};
+static_assert(sizeof(ComponentRecord) == 64, "ComponentRecord doit rester sur 64 octets (format de fichier)");
+
+/**
+ * @brief La classe ComponentArchiveWriter ajoute des composants à une archive composée de deux fichiers :
+ * `<base>.pcbdata` (les blocs de pixels, bruts ou compressés) et `<base>.pcbidx` (une ComponentRecord
+ * par composant). L'écriture se fait uniquement en fin de fichier ; le bloc est écrit avant son entrée
+ * d'index, si bien qu'une interruption ne laisse jamais une entrée pointant vers des données absentes.
+ */
+class ComponentArchiveWriter
+{
+public:
+    ComponentArchiveWriter() = default;
+    ~ComponentArchiveWriter() { close(); }
+
+    ComponentArchiveWriter(const ComponentArchiveWriter&) = delete;
+    ComponentArchiveWriter& operator=(const ComponentArchiveWriter&) = delete;
+
+    /**
+     * @brief Ouvre (ou crée) l'archive pour y ajouter des composants.
+     * @param basePath Chemin sans extension.
+     * @param error Message d'erreur en cas d'échec (optionnel).
+     * @return true si l'archive est prête.
+     */
+    bool open(const std::string& basePath, std::string* error = nullptr);
+
+    /**
+     * @brief Crée une archive vide, en remplaçant celle qui existerait déjà sous ce nom.
+     * Les identifiants d'une archive ne sont uniques que pour un même export : c'est ce mode qu'utilise
+     * ComponentExporter, pour qu'un nouvel export ne mélange pas ses composants avec ceux du précédent.
+     * @param basePath Chemin sans extension.
+     * @param error Message d'erreur en cas d'échec (optionnel).
+     * @return true si l'archive est prête.
+     */
+    bool create(const std::string& basePath, std::string* error = nullptr);
+
+    /**
+     * @brief Ferme les fichiers (les données déjà ajoutées restent lisibles).
+     */
+    void close();
+
+    bool isOpen() const { return m_data.is_open() && m_index.is_open(); }
+
+    /**
+     * @brief Ajoute les pixels bruts d'un composant (copiés ligne par ligne, sans compression).
+     * @param id Identifiant du composant.
+     * @param box Boîte englobante dans l'image source.
+     * @param area Aire du contour.
+     * @param roi Pixels du composant (une ROI non contiguë est acceptée).
+     * @return true si le composant a été ajouté.
+     */
+    bool appendRaw(int id, const cv::Rect& box, double area, const cv::Mat& roi);
+
+    /**
+     * @brief Ajoute un composant déjà encodé (PNG, JPEG ou WebP, par exemple avec cv::imencode).
+     * @param id Identifiant du composant.
+     * @param box Boîte englobante dans l'image source.
+     * @param area Aire du contour.
+     * @param cvType Type OpenCV des pixels avant encodage.
+     * @param encoding Encodage du bloc.
+     * @param blob Octets encodés.
+     * @return true si le composant a été ajouté.
+     */
+    bool appendEncoded(int id, const cv::Rect& box, double area, int cvType,
+                       ArchiveEncoding encoding, const std::vector<unsigned char>& blob);
+
+    /**
+     * @brief Retourne les chemins des deux fichiers d'une archive.
+     */
+    static std::string dataPath(const std::string& basePath) { return basePath + ".pcbdata"; }
+    static std::string indexPath(const std::string& basePath) { return basePath + ".pcbidx"; }
+
+private:
+    bool openFiles(const std::string& basePath, bool append, std::string* error);
+    bool writeBlock(ComponentRecord& record, const unsigned char* const* rows, std::size_t rowCount, std::size_t rowBytes);
+
+    std::ofstream m_data;       // Fichier des blocs (ouvert en ajout)
+    std::ofstream m_index;      // Fichier d'index (ouvert en ajout)
+    std::uint64_t m_dataSize = 0; // Taille actuelle du fichier de données (position du prochain bloc)
+};
+
+/**
+ * @brief La classe ComponentArchiveReader projette le fichier de données en mémoire (mmap sous POSIX,
+ * MapViewOfFile sous Windows) et charge l'index. Les composants bruts sont rendus sous forme de cv::Mat
+ * pointant directement dans la projection : aucune copie, mais la Mat n'est valide que tant que
+ * le lecteur reste ouvert.
+ */
+class ComponentArchiveReader
+{
+public:
+    ComponentArchiveReader();
+    ~ComponentArchiveReader();
+
+    ComponentArchiveReader(const ComponentArchiveReader&) = delete;
+    ComponentArchiveReader& operator=(const ComponentArchiveReader&) = delete;
+
+    /**
+     * @brief Ouvre une archive en lecture.
+     * Une entrée d'index incomplète en fin de fichier (écriture interrompue) est ignorée.
+     * @param basePath Chemin sans extension.
+     * @param error Message d'erreur en cas d'échec (optionnel).
+     * @return true si l'archive a été ouverte.
+     */
+    bool open(const std::string& basePath, std::string* error = nullptr);
+
+    /**
+     * @brief Libère la projection ; les Mat obtenues par roi() deviennent invalides.
+     */
+    void close();
+
+    std::size_t count() const { return m_records.size(); }
+    const ComponentRecord& record(std::size_t index) const { return m_records[index]; }
+    const std::vector<ComponentRecord>& records() const { return m_records; }
+
+    /**
+     * @brief Retourne le bloc d'un composant tel qu'il est stocké (sans copie).
+     * @param index Position dans l'index.
+     * @param size Reçoit la taille du bloc en octets.
+     */
+    const unsigned char* blob(std::size_t index, std::size_t& size) const;
+
+    /**
+     * @brief Retourne les pixels d'un composant.
+     * Raw : vue sans copie dans la projection. Encodé : image décodée (nouvelle mémoire).
+     * @param index Position dans l'index.
+     * @return La Mat du composant, vide en cas d'erreur.
+     */
+    cv::Mat roi(std::size_t index) const;
+
+private:
+    struct Mapping; // Projection mémoire dépendante de la plateforme (voir componentarchive.cpp)
+
+    std::unique_ptr<Mapping> m_mapping;
+    std::vector<ComponentRecord> m_records;
+};
+
+#endif // COMPONENTARCHIVE_H
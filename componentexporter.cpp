@@ -0,0 +1,254 @@
+// componentexporter.cpp
+#include "componentexporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+
+#include <opencv2/imgcodecs.hpp>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Démarre les threads d'encodage puis le thread de répartition.
+ * @param threadCount Nombre de threads d'encodage (0 : nombre de cœurs).
+ * @param maxQueued Nombre maximal de composants en attente d'encodage.
+ */
+ComponentExporter::ComponentExporter(unsigned threadCount, std::size_t maxQueued)
+    : m_encoders(threadCount, std::max<std::size_t>(1, maxQueued))
+    , m_busy(false)
+    , m_stopping(false)
+    , m_dispatcher(&ComponentExporter::dispatchLoop, this)
+{
+}
+
+/**
+ * @brief Laisse le thread de répartition terminer les exports en file, puis le rejoint.
+ * Les threads d'encodage sont arrêtés ensuite par le destructeur de m_encoders.
+ */
+ComponentExporter::~ComponentExporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobAvailable.notify_all();
+    m_dispatcher.join();
+}
+
+/**
+ * @brief Met en file un export ; rend la main immédiatement.
+ */
+void ComponentExporter::exportAsync(const cv::Mat& image, const std::vector<cv::Rect>& rects,
+                                    const std::vector<double>& areas, const ExportOptions& options, Callback onFinished)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(Job{image, rects, areas, options, std::move(onFinished)});
+    }
+    m_jobAvailable.notify_one();
+}
+
+/**
+ * @brief Bloque jusqu'à ce que tous les exports en file soient écrits.
+ */
+void ComponentExporter::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_jobs.empty() && !m_busy; });
+}
+
+/**
+ * @brief Retourne l'extension de fichier d'un format (".png", ".jpg" ou ".webp").
+ */
+std::string ComponentExporter::extension(ExportCodec codec)
+{
+    switch (codec) {
+    case ExportCodec::Jpeg: return ".jpg";
+    case ExportCodec::Raw:  return ".png"; // Un fichier brut seul serait illisible : PNG sans compression
+    case ExportCodec::Webp: return ".webp";
+    case ExportCodec::Png:
+    default:                return ".png";
+    }
+}
+
+/**
+ * @brief Traduit le niveau des options en paramètres cv::imwrite, borné à la plage du format.
+ */
+std::vector<int> ComponentExporter::encodeParams(const ExportOptions& options)
+{
+    switch (options.codec) {
+    case ExportCodec::Jpeg:
+        return { cv::IMWRITE_JPEG_QUALITY, std::clamp(options.level, 0, 100) };
+    case ExportCodec::Webp:
+        return { cv::IMWRITE_WEBP_QUALITY, std::clamp(options.level, 1, 100) };
+    case ExportCodec::Raw:
+        return { cv::IMWRITE_PNG_COMPRESSION, 0 };
+    case ExportCodec::Png:
+    default:
+        return { cv::IMWRITE_PNG_COMPRESSION, std::clamp(options.level, 0, 9) };
+    }
+}
+
+/**
+ * @brief Boucle du thread de répartition : traite les exports un par un, dans l'ordre des demandes.
+ * À l'arrêt, le thread ne se termine qu'une fois la file vide.
+ */
+void ComponentExporter::dispatchLoop()
+{
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_jobs.empty()) {
+                return; // Arrêt demandé et plus rien à exporter
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_busy = true;
+        }
+
+        runJob(job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy = false;
+            if (m_jobs.empty()) {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Encode chaque composant dans sa propre tâche (un fichier "component_N" par boîte englobante).
+ * submit() bloque ce thread quand la file des encodeurs est pleine.
+ */
+void ComponentExporter::runJob(const Job& job)
+{
+    const auto start = std::chrono::steady_clock::now();
+    ExportReport report;
+    report.directory = job.options.directory;
+
+    // Le répertoire est créé une seule fois par export, avant de lancer les encodeurs
+    std::error_code ec;
+    fs::create_directories(job.options.directory, ec);
+    if (ec || job.image.empty()) {
+        report.failed = static_cast<int>(job.rects.size());
+        if (job.onFinished) job.onFinished(report);
+        return;
+    }
+
+    if (job.options.archive) {
+        runArchiveJob(job, report);
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (job.onFinished) job.onFinished(report);
+        return;
+    }
+
+    auto written = std::make_shared<std::atomic<int>>(0);
+    auto failed = std::make_shared<std::atomic<int>>(0);
+    const std::string ext = extension(job.options.codec);
+    const std::vector<int> params = encodeParams(job.options);
+    const cv::Rect imageBounds(0, 0, job.image.cols, job.image.rows);
+
+    for (std::size_t index = 0; index < job.rects.size(); ++index) {
+        const cv::Rect box = job.rects[index] & imageBounds;
+        if (box.empty()) {
+            ++*failed;
+            continue;
+        }
+        // La ROI partage les pixels de l'image source : aucune copie avant l'encodage
+        const cv::Mat roi = job.image(box);
+        const std::string fileName = (fs::path(job.options.directory)
+                                      / ("component_" + std::to_string(index) + ext)).string();
+        m_encoders.submit([roi, fileName, params, written, failed]() {
+            bool ok = false;
+            try {
+                ok = cv::imwrite(fileName, roi, params);
+            } catch (const cv::Exception&) {
+                ok = false; // Format non pris en charge par cette version d'OpenCV, disque plein, ...
+            }
+            if (ok) ++*written; else ++*failed;
+        });
+    }
+    m_encoders.waitIdle(); // Seul ce thread alimente les encodeurs : attend la fin de cet export
+
+    report.written = written->load();
+    report.failed = failed->load();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (job.onFinished) job.onFinished(report);
+}
+
+/**
+ * @brief Écrit les composants d'un export dans l'archive du répertoire. Comme l'export par fichiers, qui
+ * écrase les fichiers du même nom, chaque export remplace l'archive précédente : ses identifiants
+ * (0..N-1) désignent sans ambiguïté les composants de la dernière détection.
+ * Les blocs bruts sont copiés directement. Sinon, les composants sont encodés en parallèle par lots
+ * (mémoire bornée), puis ajoutés dans l'ordre par ce seul thread : l'archive n'a qu'un écrivain.
+ */
+void ComponentExporter::runArchiveJob(const Job& job, ExportReport& report)
+{
+    ComponentArchiveWriter writer;
+    const std::string basePath = (fs::path(job.options.directory) / kComponentArchiveName).string();
+    if (!writer.create(basePath)) {
+        report.failed = static_cast<int>(job.rects.size());
+        return;
+    }
+    const cv::Rect imageBounds(0, 0, job.image.cols, job.image.rows);
+    auto areaOf = [&job](std::size_t index) { return index < job.areas.size() ? job.areas[index] : 0.0; };
+
+    if (job.options.codec == ExportCodec::Raw) {
+        for (std::size_t index = 0; index < job.rects.size(); ++index) {
+            const cv::Rect box = job.rects[index] & imageBounds;
+            if (!box.empty() && writer.appendRaw(static_cast<int>(index), box, areaOf(index), job.image(box))) {
+                ++report.written;
+            } else {
+                ++report.failed;
+            }
+        }
+        return;
+    }
+
+    ArchiveEncoding encoding = ArchiveEncoding::Png;
+    if (job.options.codec == ExportCodec::Jpeg) encoding = ArchiveEncoding::Jpeg;
+    else if (job.options.codec == ExportCodec::Webp) encoding = ArchiveEncoding::Webp;
+    const std::string ext = extension(job.options.codec);
+    const std::vector<int> params = encodeParams(job.options);
+
+    const std::size_t batchSize = 64;
+    std::vector<std::vector<unsigned char>> blobs(batchSize);
+    for (std::size_t first = 0; first < job.rects.size(); first += batchSize) {
+        const std::size_t count = std::min(batchSize, job.rects.size() - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            blobs[i].clear();
+            const cv::Rect box = job.rects[first + i] & imageBounds;
+            if (box.empty()) {
+                continue; // Bloc vide : compté en échec ci-dessous
+            }
+            const cv::Mat roi = job.image(box);
+            std::vector<unsigned char>* blob = &blobs[i];
+            m_encoders.submit([roi, blob, ext, params]() {
+                try {
+                    if (!cv::imencode(ext, roi, *blob, params)) blob->clear();
+                } catch (const cv::Exception&) {
+                    blob->clear();
+                }
+            });
+        }
+        m_encoders.waitIdle();
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t index = first + i;
+            const cv::Rect box = job.rects[index] & imageBounds;
+            if (!blobs[i].empty() && writer.appendEncoded(static_cast<int>(index), box, areaOf(index), job.image.type(), encoding, blobs[i])) {
+                ++report.written;
+            } else {
+                ++report.failed;
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+// componentexporter.h
+#ifndef COMPONENTEXPORTER_H
+#define COMPONENTEXPORTER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "componentarchive.h"
+#include "threadpool.h"
+
+/**
+ * @brief Format d'encodage des images de composants exportées.
+ */
+enum class ExportCodec
+{
+    Png,  // Sans perte ; niveau = compression zlib (0 à 9)
+    Jpeg, // Avec perte ; niveau = qualité (0 à 100)
+    Webp, // Avec perte ; niveau = qualité (1 à 100)
+    Raw   // Pixels bruts, sans encodage : archive uniquement (export par fichiers : PNG sans compression)
+};
+
+/**
+ * @brief Options d'un export : répertoire de destination, format et niveau de compression/qualité.
+ */
+struct ExportOptions
+{
+    std::string directory = "extracted_components"; // Répertoire de destination (créé si nécessaire)
+    ExportCodec codec = ExportCodec::Png;            // Format des fichiers écrits
+    int level = 3;                                   // Compression (PNG) ou qualité (JPEG/WebP), voir ExportCodec
+    bool archive = false; // true : une seule archive indexée (voir ComponentArchiveWriter) au lieu d'un fichier par composant
+};
+
+/**
+ * @brief Nom de base (sans extension) de l'archive écrite dans le répertoire d'export.
+ */
+const char* const kComponentArchiveName = "components";
+
+/**
+ * @brief Bilan d'un export, transmis au rappel de fin.
+ */
+struct ExportReport
+{
+    std::string directory; // Répertoire de destination
+    int written = 0;       // Nombre de fichiers écrits
+    int failed = 0;        // Nombre de composants qui n'ont pas pu être écrits
+    double seconds = 0.0;  // Durée totale de l'export
+};
+
+/**
+ * @brief La classe ComponentExporter écrit les images des composants détectés sur disque,
+ * en dehors du pipeline de détection, soit un fichier par composant, soit dans une archive indexée.
+ * Chaque export est mis en file et exportAsync() rend la main immédiatement. Un thread de répartition
+ * confie ensuite l'encodage des composants à un ThreadPool dont la file est bornée : si les encodeurs
+ * prennent du retard, c'est ce thread qui attend (contre-pression), jamais l'appelant ni l'interface.
+ * Indépendante de Qt (bibliothèque pcb_core).
+ */
+class ComponentExporter
+{
+public:
+    using Callback = std::function<void(const ExportReport&)>;
+
+    /**
+     * @brief Démarre l'exporteur.
+     * @param threadCount Nombre de threads d'encodage (0 : nombre de cœurs).
+     * @param maxQueued Nombre maximal de composants en attente d'encodage.
+     */
+    explicit ComponentExporter(unsigned threadCount = 0, std::size_t maxQueued = 64);
+
+    /**
+     * @brief Termine les exports déjà demandés, puis arrête les threads.
+     */
+    ~ComponentExporter();
+
+    ComponentExporter(const ComponentExporter&) = delete;
+    ComponentExporter& operator=(const ComponentExporter&) = delete;
+
+    /**
+     * @brief Met en file l'export des composants `rects` de `image`.
+     * L'image est partagée (pas de copie) : l'appelant ne doit plus modifier ses pixels.
+     * @param image L'image source (BGR).
+     * @param rects Les boîtes englobantes des composants ; le fichier N correspond à rects[N].
+     * @param areas Les aires des contours (enregistrées dans l'index de l'archive ; peut être vide).
+     * @param options Répertoire, format et niveau.
+     * @param onFinished Appelé à la fin de l'export, depuis un thread de l'exporteur (optionnel).
+     */
+    void exportAsync(const cv::Mat& image, const std::vector<cv::Rect>& rects, const std::vector<double>& areas,
+                     const ExportOptions& options, Callback onFinished = Callback());
+
+    /**
+     * @brief Bloque jusqu'à la fin de tous les exports demandés.
+     */
+    void waitIdle();
+
+    /**
+     * @brief Retourne l'extension de fichier (avec le point) d'un format.
+     */
+    static std::string extension(ExportCodec codec);
+
+    /**
+     * @brief Retourne les paramètres cv::imwrite correspondant aux options (niveau borné à la plage du format).
+     */
+    static std::vector<int> encodeParams(const ExportOptions& options);
+
+private:
+    struct Job
+    {
+        cv::Mat image;
+        std::vector<cv::Rect> rects;
+        std::vector<double> areas;
+        ExportOptions options;
+        Callback onFinished;
+    };
+
+    void dispatchLoop();        // Boucle du thread de répartition
+    void runJob(const Job& job); // Encode tous les composants d'un export et appelle le rappel
+    void runArchiveJob(const Job& job, ExportReport& report); // Variante : remplace l'archive par celle de cet export
+
+    ThreadPool m_encoders;              // Threads d'encodage (file bornée)
+    std::deque<Job> m_jobs;             // Exports en attente de répartition
+    std::mutex m_mutex;                 // Protège m_jobs, m_busy et m_stopping
+    std::condition_variable m_jobAvailable; // Signalé quand un export est ajouté (ou à l'arrêt)
+    std::condition_variable m_idle;     // Signalé quand plus aucun export n'est en attente ni en cours
+    bool m_busy;                        // Vrai pendant la répartition d'un export
+    bool m_stopping;                    // Vrai pendant la destruction
+    std::thread m_dispatcher;           // Thread de répartition (démarré en dernier)
+};
+
+#endif // COMPONENTEXPORTER_H
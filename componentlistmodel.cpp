@@ -0,0 +1,130 @@
+// componentlistmodel.cpp
+#include "componentlistmodel.h"
+#include <algorithm> // std::min
+#include "pipelineprofiler.h" // Mesure de l'application des résultats (ScopedStageTimer)
+
+namespace {
+
+/**
+ * @brief Vrai si deux composants désignent la même détection (même source, même boîte, même aire).
+ * L'identifiant n'est pas comparé : c'est la position dans la liste, qui se décale après une insertion.
+ */
+bool sameDetection(const Composant& a, const Composant& b)
+{
+    return a.getSource() == b.getSource() && a.getBoundingBox() == b.getBoundingBox() && a.getArea() == b.getArea();
+}
+
+} // namespace
+
+ComponentListModel::ComponentListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_iconSize(48, 48)
+{
+}
+
+int ComponentListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_components.size();
+}
+
+/**
+ * @brief Texte et vignette d'une ligne, produits seulement quand la vue affiche cette ligne.
+ */
+QVariant ComponentListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_components.size()) {
+        return QVariant();
+    }
+    const Composant& component = m_components.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return component.getDetails();
+    case Qt::DecorationRole:
+        return m_thumbnails.thumbnail(component, m_iconSize);
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Applique un nouveau résultat comme un diff de l'ancien.
+ * Le préfixe et le suffixe communs sont conservés ; au milieu, les lignes en regard sont mises à jour
+ * en place, et seul l'excédent est inséré ou supprimé. Relancer le pipeline sans changement effectif
+ * n'émet donc aucun signal, et un réglage qui ne touche que quelques détections ne rafraîchit qu'elles.
+ */
+void ComponentListModel::setComponents(const QVector<Composant>& components)
+{
+    ScopedStageTimer timer("ComponentListModel::setComponents");
+    const int oldCount = m_components.size();
+    const int newCount = components.size();
+
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && sameDetection(m_components[prefix], components[prefix])) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix
+           && sameDetection(m_components[oldCount - 1 - suffix], components[newCount - 1 - suffix])) {
+        ++suffix;
+    }
+    const int oldMiddle = oldCount - prefix - suffix;
+    const int newMiddle = newCount - prefix - suffix;
+    const int replaced = std::min(oldMiddle, newMiddle);
+
+    // Lignes en regard : remplacées en place
+    for (int row = prefix; row < prefix + replaced; ++row) {
+        m_components[row] = components[row];
+    }
+    if (replaced > 0) {
+        emit dataChanged(index(prefix), index(prefix + replaced - 1));
+    }
+
+    // Excédent de l'ancienne liste : supprimé
+    if (oldMiddle > replaced) {
+        const int first = prefix + replaced;
+        beginRemoveRows(QModelIndex(), first, prefix + oldMiddle - 1);
+        m_components.remove(first, oldMiddle - replaced);
+        endRemoveRows();
+    }
+
+    // Excédent de la nouvelle liste : inséré
+    if (newMiddle > replaced) {
+        const int first = prefix + replaced;
+        beginInsertRows(QModelIndex(), first, prefix + newMiddle - 1);
+        m_components.insert(first, newMiddle - replaced, Composant());
+        for (int row = first; row < prefix + newMiddle; ++row) {
+            m_components[row] = components[row];
+        }
+        endInsertRows();
+    }
+
+    // Le suffixe a pu se décaler : ses identifiants (positions) changent, donc son texte aussi
+    m_components = components;
+    if (oldMiddle != newMiddle && suffix > 0) {
+        emit dataChanged(index(newCount - suffix), index(newCount - 1), {Qt::DisplayRole, Qt::ToolTipRole});
+    }
+}
+
+void ComponentListModel::clear(bool dropThumbnails)
+{
+    if (!m_components.isEmpty()) {
+        beginResetModel();
+        m_components.clear();
+        endResetModel();
+    }
+    if (dropThumbnails) {
+        m_thumbnails.clear();
+    }
+}
+
+void ComponentListModel::setIconSize(const QSize& size)
+{
+    if (size == m_iconSize) {
+        return;
+    }
+    m_iconSize = size;
+    if (!m_components.isEmpty()) {
+        emit dataChanged(index(0), index(m_components.size() - 1), {Qt::DecorationRole});
+    }
+}
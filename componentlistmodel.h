@@ -0,0 +1,57 @@
+// componentlistmodel.h
+#ifndef COMPONENTLISTMODEL_H
+#define COMPONENTLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QSize>
+#include <QVector>
+#include "composant.h"
+#include "thumbnailcache.h"
+
+/**
+ * @brief Modèle de la liste des composants détectés, affiché par un QListView.
+ *
+ * La vue ne demande que les lignes visibles : le texte et la vignette d'un composant ne sont produits
+ * qu'à l'affichage de sa ligne (vignette générée à la demande puis gardée dans un ThumbnailCache).
+ * Un nouveau résultat est appliqué comme un diff : seules les lignes ajoutées, supprimées ou modifiées
+ * sont signalées à la vue, qui conserve sa sélection et sa position de défilement.
+ */
+class ComponentListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit ComponentListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Remplace la liste par celle d'un nouveau résultat, en n'émettant que les changements.
+     * @param components Les composants du nouveau résultat.
+     */
+    void setComponents(const QVector<Composant>& components);
+
+    /**
+     * @brief Vide la liste.
+     * @param dropThumbnails Vrai pour oublier aussi les vignettes (nouvelle image chargée).
+     */
+    void clear(bool dropThumbnails = false);
+
+    /**
+     * @brief Taille des vignettes renvoyées pour Qt::DecorationRole (celle des icônes de la vue).
+     */
+    void setIconSize(const QSize& size);
+
+    /**
+     * @brief Composant affiché à une ligne.
+     */
+    const Composant& componentAt(int row) const { return m_components.at(row); }
+
+private:
+    QVector<Composant> m_components;
+    QSize m_iconSize;
+    mutable ThumbnailCache m_thumbnails; // Rempli depuis data() (const) au fil de l'affichage
+};
+
+#endif // COMPONENTLISTMODEL_H
@@ -4,20 +4,48 @@
 //c'est comme une "fiche d'identité" pour chaque pièce trouvée sur la carte.
 // composant.cpp
 #include "composant.h" // Inclut le fichier d'en-tête pour la classe Composant
+#include <atomic>      // Compteur des identifiants de sources
+
+/**
+ * @brief Crée une source partagée pour une image, avec un identifiant jamais réutilisé.
+ * L'identifiant (et non l'adresse de la source, qui peut être réutilisée) sert de clé au cache de vignettes.
+ * @param image L'image couleur d'origine.
+ * @return La source partagée.
+ */
+ComponentSourcePtr makeComponentSource(const cv::Mat& image)
+{
+    static std::atomic<quint64> nextId{1};
+    return std::make_shared<const ComponentSource>(ComponentSource{image, nextId++});
+}
 
 /**
  * @brief Constructeur de la classe Composant.
  * @param id Identifiant unique du composant.
  * @param boundingBox Boîte englobante du composant dans l'image (cv::Rect).
  * @param area Aire du contour du composant en pixels carrés.
- * @param image QPixmap représentant la petite image extraite du composant.
+ * @param source Image source dans laquelle se trouve la boîte englobante.
  */
-Composant::Composant(int id, const cv::Rect& boundingBox, double area, const QPixmap& image)
-    : m_id(id), m_boundingBox(boundingBox), m_area(area), m_image(image)
+Composant::Composant(int id, const cv::Rect& boundingBox, double area, ComponentSourcePtr source)
+    : m_id(id), m_boundingBox(boundingBox), m_area(area), m_source(std::move(source))
 {
     // Le corps du constructeur est vide car tous les membres sont initialisés dans la liste d'initialisation
 }
 
+/**
+ * @brief Retourne la région de l'image source couverte par le composant.
+ * La ROI partage les pixels de la source : aucune copie n'est faite.
+ * @return La ROI, ou une Mat vide si le composant n'a pas de source.
+ */
+cv::Mat Composant::getImageRegion() const
+{
+    if (!m_source || m_source->image.empty()) {
+        return cv::Mat();
+    }
+    // Borne la boîte à l'image par sécurité (les boîtes du pipeline y sont déjà contenues)
+    const cv::Rect clipped = m_boundingBox & cv::Rect(0, 0, m_source->image.cols, m_source->image.rows);
+    return clipped.empty() ? cv::Mat() : m_source->image(clipped);
+}
+
 /**
  * @brief Retourne une chaîne de caractères détaillée sur le composant.
  * Formatte les informations pour un affichage lisible dans l'interface utilisateur.
@@ -3,25 +3,49 @@
 #define COMPOSANT_H
 
 #include <QString>
-#include <opencv2/core.hpp> // Pour cv::Rect
-#include <QPixmap>          // Pour stocker l'image du composant
+#include <QtGlobal>         // Pour quint64
+#include <memory>           // Pour std::shared_ptr
+#include <opencv2/core.hpp> // Pour cv::Rect et cv::Mat
+
+/**
+ * @brief Image source partagée par tous les composants d'un même résultat.
+ * Les composants n'en gardent qu'une référence : leurs vignettes sont générées à la demande (voir ThumbnailCache).
+ */
+struct ComponentSource
+{
+    cv::Mat image; // Image couleur d'origine (pixels partagés, jamais modifiés)
+    quint64 id;    // Identifiant unique de cette source (clé du cache de vignettes)
+};
+
+using ComponentSourcePtr = std::shared_ptr<const ComponentSource>;
+
+/**
+ * @brief Crée une source partagée pour une image, avec un identifiant jamais réutilisé.
+ * @param image L'image couleur d'origine (partagée sans copie).
+ */
+ComponentSourcePtr makeComponentSource(const cv::Mat& image);
 
 /**
  * @brief La classe Composant représente un composant électronique détecté sur une carte PCB.
- * Elle stocke des informations telles que son identifiant, sa boîte englobante,
- * son aire et une petite image de lui-même.
+ * Elle ne stocke que son identifiant, sa boîte englobante, son aire et une référence vers l'image source :
+ * aucune image n'est créée à la détection, les vignettes sont générées à la demande à la taille des icônes.
  */
 class Composant
 {
 public:
+    /**
+     * @brief Constructeur par défaut (composant vide, requis par QVector).
+     */
+    Composant() = default;
+
     /**
      * @brief Constructeur de la classe Composant.
      * @param id Identifiant unique du composant.
      * @param boundingBox Boîte englobante du composant dans l'image (cv::Rect).
      * @param area Aire du contour du composant en pixels carrés.
-     * @param image QPixmap représentant la petite image extraite du composant.
+     * @param source Image source dans laquelle se trouve la boîte englobante.
      */
-    Composant(int id, const cv::Rect& boundingBox, double area, const QPixmap& image);
+    Composant(int id, const cv::Rect& boundingBox, double area, ComponentSourcePtr source);
 
     /**
      * @brief Retourne une chaîne de caractères détaillée sur le composant.
@@ -48,16 +72,21 @@ public:
     double getArea() const { return m_area; }
 
     /**
-     * @brief Retourne la QPixmap représentant l'image du composant.
-     * @return La QPixmap du composant.
+     * @brief Retourne l'image source du composant (nulle pour un composant vide).
+     */
+    const ComponentSourcePtr& getSource() const { return m_source; }
+
+    /**
+     * @brief Retourne la région de l'image source couverte par le composant (sans copie des pixels).
+     * @return La ROI, ou une Mat vide si le composant n'a pas de source.
      */
-    QPixmap getImage() const { return m_image; }
+    cv::Mat getImageRegion() const;
 
 private:
-    int m_id;             // Identifiant unique du composant
-    cv::Rect m_boundingBox; // Boîte englobante (x, y, largeur, hauteur)
-    double m_area;        // Aire du contour
-    QPixmap m_image;      // Image extraite du composant
+    int m_id = -1;             // Identifiant unique du composant
+    cv::Rect m_boundingBox;    // Boîte englobante (x, y, largeur, hauteur)
+    double m_area = 0.0;       // Aire du contour
+    ComponentSourcePtr m_source; // Image source partagée (les vignettes sont générées à la demande)
 };
 
 #endif // COMPOSANT_H
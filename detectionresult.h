@@ -0,0 +1,29 @@
+// detectionresult.h
+#ifndef DETECTIONRESULT_H
+#define DETECTIONRESULT_H
+
+#include <opencv2/core.hpp> // Pour cv::Mat et cv::Rect
+#include <vector>
+
+/**
+ * @brief La structure DetectionResult contient tout ce que produit une exécution du pipeline
+ * de détection : les images de résultat et la liste des composants retenus.
+ * C'est un simple type valeur (sans Qt) : les cv::Mat sont partagées par comptage de références,
+ * la copie d'un DetectionResult est donc peu coûteuse.
+ * Les vecteurs `rects` et `areas` sont alignés : l'indice i correspond à l'identifiant du composant i.
+ */
+struct DetectionResult
+{
+    cv::Mat contoursImage;              // Image originale annotée (boîtes rouges et numéros verts)
+    cv::Mat extractedComponentsOnBlank; // Composants extraits copiés sur un fond blanc
+    cv::Mat mask;                       // Masque binaire final (après seuillage, zones sombres et morphologie)
+    std::vector<cv::Rect> rects;        // Boîtes englobantes des composants retenus
+    std::vector<double> areas;          // Aire du contour de chaque composant (pixels carrés)
+
+    /**
+     * @brief Retourne le nombre de composants détectés.
+     */
+    int componentCount() const { return static_cast<int>(rects.size()); }
+};
+
+#endif // DETECTIONRESULT_H
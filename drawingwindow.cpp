@@ -4,6 +4,9 @@
 #include <QPushButton>     // Inclut la classe QPushButton pour créer des boutons
 #include <QFileDialog>     // Inclut la classe QFileDialog pour ouvrir des boîtes de dialogue de fichier (par exemple, pour sauvegarder)
 #include <QMessageBox>     // Inclut la classe QMessageBox pour afficher des messages d'information ou d'erreur
+#include <QStringList>     // Inclut QStringList (assemblage de la description du survol)
+#include <QStatusBar>      // Inclut la barre d'état (description de l'annotation ou de la détection survolée)
+#include "groundtruth.h"   // Lecture et écriture des fichiers d'annotations (bibliothèque pcb_core)
 
 // Constructeur de la classe DrawingWindow
 DrawingWindow::DrawingWindow(QWidget *parent)
@@ -16,6 +19,7 @@ DrawingWindow::DrawingWindow(QWidget *parent)
 
     // Crée une instance de ImageViewer (où l'image et les contours seront affichés)
     imageViewer = new ImageViewer(this);
+    imageViewer->setToolTip("Left drag: draw a rectangle. Wheel: zoom. Right or middle drag: pan.");
     // Ajoute l'imageViewer au layout principal, il occupera la majeure partie de l'espace
     mainLayout->addWidget(imageViewer);
 
@@ -28,11 +32,23 @@ DrawingWindow::DrawingWindow(QWidget *parent)
     undoButton = new QPushButton("Undo Last Contour", this);
     // Crée le bouton "Clear All Contours" (pour supprimer tous les contours dessinés)
     clearAllButton = new QPushButton("Clear All Contours", this);
+    // Crée le bouton "Fit to Window" (annule le zoom et le déplacement de la vue)
+    fitButton = new QPushButton("Fit to Window", this);
+    // Boutons de la vérité terrain : les rectangles dessinés servent de référence au réglage automatique
+    // (bouton "Tune Parameters", ou pcb_tune sur un répertoire d'images annotées)
+    saveAnnotationsButton = new QPushButton("Save Annotations", this);
+    loadAnnotationsButton = new QPushButton("Load Annotations", this);
+    tuneButton = new QPushButton("Tune Parameters", this);
+    tuneButton->setToolTip("Search the slider values whose detections best match the drawn rectangles");
 
     // Ajoute les boutons au layout horizontal
     buttonLayout->addWidget(saveButton);
     buttonLayout->addWidget(undoButton);
     buttonLayout->addWidget(clearAllButton);
+    buttonLayout->addWidget(fitButton);
+    buttonLayout->addWidget(saveAnnotationsButton);
+    buttonLayout->addWidget(loadAnnotationsButton);
+    buttonLayout->addWidget(tuneButton);
     // Ajoute un espace étirable qui poussera les boutons vers la gauche du layout horizontal
     buttonLayout->addStretch();
 
@@ -45,6 +61,13 @@ DrawingWindow::DrawingWindow(QWidget *parent)
     connect(undoButton, &QPushButton::clicked, this, &DrawingWindow::onUndoLastContour);
     // Connecte le signal 'clicked' du bouton 'clearAllButton' à la fonction 'onClearAllContours'
     connect(clearAllButton, &QPushButton::clicked, this, &DrawingWindow::onClearAllContours);
+    // Connecte le signal 'clicked' du bouton 'fitButton' directement au slot 'fitToWindow' de l'ImageViewer
+    connect(fitButton, &QPushButton::clicked, imageViewer, &ImageViewer::fitToWindow);
+    connect(saveAnnotationsButton, &QPushButton::clicked, this, &DrawingWindow::onSaveAnnotations);
+    connect(loadAnnotationsButton, &QPushButton::clicked, this, &DrawingWindow::onLoadAnnotations);
+    connect(tuneButton, &QPushButton::clicked, this, &DrawingWindow::onTuneParameters);
+    // Connecte le changement de survol de l'ImageViewer à la description dans la barre d'état
+    connect(imageViewer, &ImageViewer::hoverChanged, this, &DrawingWindow::onHoverChanged);
 
     // Définit le widget central de la fenêtre principale
     setCentralWidget(centralWidget);
@@ -65,6 +88,45 @@ void DrawingWindow::setOriginalImage(const cv::Mat& image) {
     imageViewer->setImage(image); // Passe l'image à l'ImageViewer
 }
 
+// Mémorise le fichier de l'image affichée (emplacement proposé pour ses annotations)
+void DrawingWindow::setImagePath(const QString& imagePath) {
+    m_imagePath = imagePath;
+}
+
+QString DrawingWindow::defaultAnnotationPath() const {
+    if (m_imagePath.isEmpty()) {
+        return "board_annotations.csv";
+    }
+    return QString::fromStdString(annotationPathFor(m_imagePath.toStdString()));
+}
+
+// Transmet les boîtes des composants détectés à l'ImageViewer (indexées pour le survol et le croisement)
+void DrawingWindow::setDetections(const std::vector<cv::Rect>& detections) {
+    imageViewer->setDetections(detections);
+}
+
+// Slot appelé quand l'annotation ou la détection sous le curseur change.
+// Le croisement annotation/détections passe par l'index spatial de l'ImageViewer (pas de parcours de toutes les boîtes).
+void DrawingWindow::onHoverChanged(int annotation, int detection) {
+    QStringList parts;
+    if (annotation >= 0) {
+        const cv::Rect& rect = imageViewer->getDrawnRectangles()[annotation];
+        parts << QString("Contour %1 (X: %2, Y: %3, W: %4, H: %5) overlaps %6 detection(s)")
+                     .arg(annotation).arg(rect.x).arg(rect.y).arg(rect.width).arg(rect.height)
+                     .arg(imageViewer->detectionsOverlappingAnnotation(annotation).size());
+    }
+    if (detection >= 0) {
+        const cv::Rect& rect = imageViewer->getDetections()[detection];
+        parts << QString("Component %1 (X: %2, Y: %3, W: %4, H: %5)")
+                     .arg(detection).arg(rect.x).arg(rect.y).arg(rect.width).arg(rect.height);
+    }
+    if (parts.isEmpty()) {
+        statusBar()->clearMessage();
+    } else {
+        statusBar()->showMessage(parts.join("  |  "));
+    }
+}
+
 // Récupère l'image avec les rectangles dessinés
 cv::Mat DrawingWindow::getResultImage() const {
     return imageViewer->getImageWithRectangles(); // Retourne l'image modifiée par l'ImageViewer
@@ -126,3 +188,46 @@ void DrawingWindow::onClearAllContours() {
         QMessageBox::information(this, "Clear All", "All rectangles cleared successfully!"); // Informe l'utilisateur du succès
     }
 }
+
+// Slot appelé lorsque le bouton "Save Annotations" est cliqué : un rectangle par ligne (id,x,y,width,height).
+// La boîte de dialogue propose <image>_annotations.csv à côté de l'image, le nom que pcb_tune et pcb_eval recherchent.
+void DrawingWindow::onSaveAnnotations() {
+    if (imageViewer->getDrawnRectangles().empty()) {
+        QMessageBox::information(this, "No Contours", "No rectangles have been drawn yet.");
+        return;
+    }
+    QString savePath = QFileDialog::getSaveFileName(this, "Save Annotations", defaultAnnotationPath(), "CSV Files (*.csv)");
+    if (savePath.isEmpty()) {
+        return;
+    }
+    if (saveAnnotations(savePath.toStdString(), imageViewer->getDrawnRectangles())) {
+        statusBar()->showMessage(QString("%1 annotations saved to %2").arg(imageViewer->getDrawnRectangles().size()).arg(savePath), 3000);
+    } else {
+        QMessageBox::critical(this, "Save Error", "Failed to save annotations. Check file permissions or disk space.");
+    }
+}
+
+// Slot appelé lorsque le bouton "Load Annotations" est cliqué : remplace les rectangles dessinés (annulable)
+void DrawingWindow::onLoadAnnotations() {
+    QString loadPath = QFileDialog::getOpenFileName(this, "Load Annotations", defaultAnnotationPath(), "CSV Files (*.csv)");
+    if (loadPath.isEmpty()) {
+        return;
+    }
+    std::vector<cv::Rect> rectangles;
+    std::string error;
+    if (!loadAnnotations(loadPath.toStdString(), rectangles, &error)) {
+        QMessageBox::critical(this, "Load Error", QString::fromStdString(error));
+        return;
+    }
+    imageViewer->replaceDrawnRectangles(rectangles);
+    statusBar()->showMessage(QString("%1 annotations loaded").arg(rectangles.size()), 3000);
+}
+
+// Slot appelé lorsque le bouton "Tune Parameters" est cliqué : la recherche est lancée par la fenêtre principale
+void DrawingWindow::onTuneParameters() {
+    if (imageViewer->getDrawnRectangles().empty()) {
+        QMessageBox::information(this, "Tune Parameters", "Draw a rectangle around each component first.");
+        return;
+    }
+    emit tuneRequested(imageViewer->getImage(), imageViewer->getDrawnRectangles());
+}
@@ -5,6 +5,7 @@
 #include "imageviewer.h"
 #include <opencv2/opencv.hpp>
 #include <QPushButton>
+#include <QString>
 
 class DrawingWindow : public QMainWindow {
     Q_OBJECT
@@ -14,18 +15,38 @@ public:
     ~DrawingWindow();
 
     void setOriginalImage(const cv::Mat& image);
+    // Fichier de l'image affichée : les annotations sont proposées à côté, sous <image>_annotations.csv
+    void setImagePath(const QString& imagePath);
     cv::Mat getResultImage() const;
+    // Boîtes des composants détectés, affichées sous les annotations et croisées avec elles
+    void setDetections(const std::vector<cv::Rect>& detections);
+
+signals:
+    // Demande le réglage automatique des paramètres sur cette image, d'après les rectangles dessinés
+    void tuneRequested(const cv::Mat& image, const std::vector<cv::Rect>& annotations);
 
 private slots:
     void onSaveContours();
     void onUndoLastContour(); // ADDED: Slot for undo button
     void onClearAllContours(); // ADDED: Slot for clear all button
+    void onHoverChanged(int annotation, int detection); // Décrit dans la barre d'état ce qui est sous le curseur
+    void onSaveAnnotations(); // Écrit les rectangles dessinés dans un fichier CSV (vérité terrain)
+    void onLoadAnnotations(); // Remplace les rectangles dessinés par ceux d'un fichier CSV
+    void onTuneParameters(); // Émet tuneRequested avec les rectangles dessinés
 
 private:
     ImageViewer *imageViewer;
     QPushButton *saveButton;
     QPushButton *undoButton; // ADDED: Undo button
     QPushButton *clearAllButton; // ADDED: Clear All button
+    QPushButton *fitButton; // Revient à l'image entière après un zoom
+    QPushButton *saveAnnotationsButton; // Enregistre les rectangles (x, y, largeur, hauteur) en CSV
+    QPushButton *loadAnnotationsButton; // Recharge des rectangles enregistrés
+    QPushButton *tuneButton; // Cherche les paramètres qui retrouvent le mieux les rectangles dessinés
+    QString m_imagePath; // Fichier de l'image affichée (vide s'il n'est pas connu)
+
+    // Fichier d'annotations proposé par les boîtes de dialogue (à côté de l'image si son fichier est connu)
+    QString defaultAnnotationPath() const;
 };
 
 #endif // DRAWINGWINDOW_H
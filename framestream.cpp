@@ -0,0 +1,311 @@
+// framestream.cpp
+#include "framestream.h"
+#include <algorithm> // std::all_of
+#include <cctype>    // std::isdigit
+#include <opencv2/imgproc.hpp>
+#include "pcbpipeline.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const auto kFpsWindow = std::chrono::seconds(1); // Fenêtre du débit soutenu et de la latence
+
+double millisecondsSince(Clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+} // namespace
+
+FrameStream::FrameStream(const StreamOptions& options)
+    : m_options(options)
+    , m_toPreprocess(options.queueCapacity)
+    , m_toSegment(options.queueCapacity)
+    , m_toRender(options.queueCapacity)
+    , m_output(options.queueCapacity)
+{
+}
+
+FrameStream::~FrameStream()
+{
+    stop();
+}
+
+/**
+ * @brief Ouvre la source : un nombre seul désigne une caméra, tout le reste est passé tel quel à cv::VideoCapture
+ * (fichier vidéo, motif printf d'une suite d'images, URL).
+ */
+bool FrameStream::open(const std::string& source, std::string* error)
+{
+    const bool isCamera = !source.empty()
+                          && std::all_of(source.begin(), source.end(), [](unsigned char c) { return std::isdigit(c); });
+    const bool opened = isCamera ? m_capture.open(std::stoi(source)) : m_capture.open(source);
+    if (!opened || !m_capture.isOpened()) {
+        if (error) *error = "cannot open video source " + source;
+        return false;
+    }
+    m_sourceFps = m_capture.get(cv::CAP_PROP_FPS);
+    return true;
+}
+
+/**
+ * @brief Démarre un thread par étage. Un flux ne se démarre qu'une fois : ses files, une fois fermées,
+ * ne se rouvrent pas.
+ */
+void FrameStream::start(const PipelineParams& params)
+{
+    CV_Assert(m_capture.isOpened() && m_threads.empty());
+    setParams(params);
+    m_startedAt = Clock::now();
+    m_threads.emplace_back(&FrameStream::decodeLoop, this);
+    m_threads.emplace_back(&FrameStream::preprocessLoop, this);
+    m_threads.emplace_back(&FrameStream::segmentLoop, this);
+    m_threads.emplace_back(&FrameStream::renderLoop, this);
+}
+
+void FrameStream::setParams(const PipelineParams& params)
+{
+    std::lock_guard<std::mutex> lock(m_paramsMutex);
+    m_params = params;
+}
+
+bool FrameStream::next(StreamFrame& frame, std::chrono::milliseconds timeout)
+{
+    Work work;
+    if (!m_output.popFor(work, timeout)) {
+        return false;
+    }
+    frame.index = work.index;
+    frame.image = work.image;
+    frame.result = std::move(work.result);
+    frame.latencyMs = std::chrono::duration<double, std::milli>(
+                          Clock::now() - work.decodedAt).count();
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_delivered;
+    return true;
+}
+
+/**
+ * @brief Ferme toutes les files en jetant leur contenu (chaque étage sort de sa boucle au prochain pop() ou push()),
+ * puis rejoint les threads.
+ */
+void FrameStream::stop()
+{
+    m_stopping = true;
+    closeQueues();
+    for (std::thread& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+}
+
+bool FrameStream::isFinished() const
+{
+    return m_output.isFinished();
+}
+
+std::string FrameStream::lastError() const
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_error;
+}
+
+StreamStats FrameStream::stats() const
+{
+    const BoundedQueue<Work>* queues[StageCount] = { &m_toPreprocess, &m_toSegment, &m_toRender, &m_output };
+    const char* names[StageCount] = { "decode", "preprocess", "segment", "render" };
+    StreamStats stats;
+    for (int stage = 0; stage < StageCount; ++stage) {
+        StreamStageStats& s = stats.stages[stage];
+        s.name = names[stage];
+        s.queueDepth = queues[stage]->size();
+        s.queueCapacity = queues[stage]->capacity();
+        s.dropped = queues[stage]->dropped();
+        stats.dropped += s.dropped;
+    }
+    stats.finished = m_output.isFinished();
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    for (int stage = 0; stage < StageCount; ++stage) {
+        StreamStageStats& s = stats.stages[stage];
+        s.frames = m_stageFrames[stage];
+        s.meanMs = s.frames > 0 ? m_stageTotalMs[stage] / s.frames : 0.0;
+    }
+    stats.decoded = m_stageFrames[Decode];
+    stats.delivered = m_delivered;
+    if (m_threads.empty() && m_stageFrames[Decode] == 0) {
+        return stats; // Pas encore démarré
+    }
+    const Clock::time_point now = Clock::now();
+    stats.elapsedSeconds = std::chrono::duration<double>(now - m_startedAt).count();
+    if (stats.elapsedSeconds > 0.0) {
+        stats.averageFps = m_stageFrames[Render] / stats.elapsedSeconds;
+    }
+    // Dernière seconde (ou moins, juste après le démarrage)
+    const double window = std::min(stats.elapsedSeconds, std::chrono::duration<double>(kFpsWindow).count());
+    int recentFrames = 0;
+    double recentLatency = 0.0;
+    for (const auto& sample : m_recent) {
+        if (now - sample.first <= kFpsWindow) {
+            ++recentFrames;
+            recentLatency += sample.second;
+        }
+    }
+    if (window > 0.0) {
+        stats.fps = recentFrames / window;
+    }
+    if (recentFrames > 0) {
+        stats.latencyMs = recentLatency / recentFrames;
+    }
+    return stats;
+}
+
+void FrameStream::decodeLoop()
+{
+    std::uint64_t index = 0;
+    try {
+        while (!m_stopping) {
+            if (m_options.realTime && m_sourceFps > 0.0) {
+                // Trame n à n / fps secondes du démarrage, comme le ferait la caméra
+                std::this_thread::sleep_until(m_startedAt + std::chrono::duration_cast<Clock::duration>(
+                                                  std::chrono::duration<double>(index / m_sourceFps)));
+            }
+            const Clock::time_point begin = Clock::now();
+            Work work;
+            if (!m_capture.read(work.image) || work.image.empty()) {
+                break; // Fin de la source (ou caméra déconnectée)
+            }
+            work.index = index++;
+            {
+                std::lock_guard<std::mutex> lock(m_paramsMutex);
+                work.params = m_params;
+            }
+            work.decodedAt = Clock::now();
+            recordStage(Decode, begin);
+            if (!m_toPreprocess.push(std::move(work), m_options.dropFrames)) {
+                break; // Flux arrêté
+            }
+        }
+    } catch (const cv::Exception& e) {
+        fail(std::string("decode: ") + e.what());
+    }
+    m_capture.release();
+    m_toPreprocess.close();
+}
+
+/**
+ * @brief Gris et pixels sombres en une passe, flou gaussien, CLAHE : les mêmes opérations que les étapes 1 à 3
+ * de PcbPipeline::run(), sans cache (chaque trame est nouvelle).
+ */
+void FrameStream::preprocessLoop()
+{
+    try {
+        cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE(); // Réutilisé d'une trame à l'autre
+        Work work;
+        while (m_toPreprocess.pop(work)) {
+            const Clock::time_point begin = Clock::now();
+            cv::Mat gray;
+            PcbPipeline::toGrayAndDarkPixels(work.image, gray, work.darkPixels);
+            PcbPipeline::applyGaussianBlur(gray, work.params);
+            clahe->setClipLimit(work.params.claheClipLimit / 10.0); // Même réglage que PcbPipeline::applyClahe()
+            clahe->apply(gray, work.preprocessed);
+            recordStage(Preprocess, begin);
+            if (!m_toSegment.push(std::move(work), m_options.dropFrames)) {
+                break;
+            }
+        }
+    } catch (const cv::Exception& e) {
+        fail(std::string("preprocess: ") + e.what());
+    }
+    m_toSegment.close();
+}
+
+/**
+ * @brief Seuillage, zones sombres, fermeture, ouverture et extraction des composants (étapes 4 à 9 sans le rendu).
+ */
+void FrameStream::segmentLoop()
+{
+    try {
+        MorphologyScratch scratch; // Images intermédiaires de la morphologie, réutilisées d'une trame à l'autre
+        Work work;
+        while (m_toSegment.pop(work)) {
+            const Clock::time_point begin = Clock::now();
+            cv::Mat threshold, darkMask, mask;
+            PcbPipeline::segment(work.preprocessed, threshold);
+            PcbPipeline::closeDarkAreas(work.darkPixels, darkMask, &scratch);
+            cv::bitwise_or(threshold, darkMask, mask);
+            PcbPipeline::applyFillHoles(mask, work.params, &scratch);
+            PcbPipeline::applySeparation(mask, work.params, &scratch);
+            PcbPipeline::findComponents(mask, work.params.contourMinArea, work.image.size(),
+                                        work.result.rects, work.result.areas, work.params.extractor);
+            work.result.mask = mask;
+            work.preprocessed.release(); // Plus utiles : libérés avant d'attendre dans la file suivante
+            work.darkPixels.release();
+            recordStage(Segment, begin);
+            if (!m_toRender.push(std::move(work), m_options.dropFrames)) {
+                break;
+            }
+        }
+    } catch (const cv::Exception& e) {
+        fail(std::string("segment: ") + e.what());
+    }
+    m_toRender.close();
+}
+
+void FrameStream::renderLoop()
+{
+    try {
+        Work work;
+        while (m_toRender.pop(work)) {
+            const Clock::time_point begin = Clock::now();
+            PcbPipeline::renderResults(work.image, work.result.rects,
+                                       work.result.contoursImage, work.result.extractedComponentsOnBlank);
+            recordStage(Render, begin);
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                const Clock::time_point now = Clock::now();
+                m_recent.emplace_back(now, std::chrono::duration<double, std::milli>(now - work.decodedAt).count());
+                while (!m_recent.empty() && now - m_recent.front().first > kFpsWindow) {
+                    m_recent.pop_front();
+                }
+            }
+            if (!m_output.push(std::move(work), m_options.dropFrames)) {
+                break;
+            }
+        }
+    } catch (const cv::Exception& e) {
+        fail(std::string("render: ") + e.what());
+    }
+    m_output.close();
+}
+
+void FrameStream::recordStage(Stage stage, Clock::time_point begin)
+{
+    const double ms = millisecondsSince(begin);
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_stageFrames[stage];
+    m_stageTotalMs[stage] += ms;
+}
+
+void FrameStream::fail(const std::string& message)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        if (m_error.empty()) {
+            m_error = message; // Seule la première erreur compte : les suivantes en découlent
+        }
+    }
+    m_stopping = true;
+    closeQueues();
+}
+
+void FrameStream::closeQueues()
+{
+    m_toPreprocess.close(true);
+    m_toSegment.close(true);
+    m_toRender.close(true);
+    m_output.close(true);
+}
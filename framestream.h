@@ -0,0 +1,195 @@
+// framestream.h
+#ifndef FRAMESTREAM_H
+#define FRAMESTREAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include "boundedqueue.h"
+#include "detectionresult.h"
+#include "pipelineparams.h"
+
+/**
+ * @brief Réglages d'un flux de trames.
+ */
+struct StreamOptions
+{
+    std::size_t queueCapacity = 2; // Trames en attente au plus devant chaque étage (et en sortie)
+    bool dropFrames = true;        // File pleine : jeter la trame la plus ancienne (vrai) ou ralentir le décodage (faux)
+    bool realTime = false;         // Décoder au rythme de la source (enregistrement rejoué comme une caméra)
+};
+
+/**
+ * @brief Une trame traitée, remise au consommateur.
+ */
+struct StreamFrame
+{
+    std::uint64_t index = 0;  // Numéro de la trame dans la source (à partir de 0) ; un saut = trames jetées
+    cv::Mat image;            // Trame décodée (BGR)
+    DetectionResult result;   // Détection sur cette trame
+    double latencyMs = 0.0;   // De la fin du décodage à la remise au consommateur (next())
+};
+
+/**
+ * @brief Activité d'un étage du flux.
+ */
+struct StreamStageStats
+{
+    const char* name = "";    // "decode", "preprocess", "segment" ou "render"
+    std::uint64_t frames = 0; // Trames traitées par l'étage
+    double meanMs = 0.0;      // Durée moyenne de traitement d'une trame
+    std::size_t queueDepth = 0;    // Trames en attente à la sortie de l'étage (entrée de l'étage suivant)
+    std::size_t queueCapacity = 0; // Capacité de cette file
+    std::uint64_t dropped = 0;     // Trames jetées dans cette file (consommateur en retard)
+};
+
+/**
+ * @brief Bilan d'un flux : débit, latence et occupation des files.
+ */
+struct StreamStats
+{
+    std::array<StreamStageStats, 4> stages; // decode, preprocess, segment, render (la file du rendu est la sortie)
+    std::uint64_t decoded = 0;   // Trames lues dans la source
+    std::uint64_t delivered = 0; // Trames remises au consommateur
+    std::uint64_t dropped = 0;   // Trames jetées, toutes files confondues
+    double fps = 0.0;            // Débit soutenu : trames rendues par seconde sur la dernière seconde
+    double averageFps = 0.0;     // Trames rendues par seconde depuis le démarrage
+    double latencyMs = 0.0;      // Latence moyenne sur la dernière seconde
+    double elapsedSeconds = 0.0; // Durée depuis le démarrage
+    bool finished = false;       // Source épuisée et toutes les trames rendues remises (ou flux arrêté)
+};
+
+/**
+ * @brief La classe FrameStream applique le pipeline de détection à une suite de trames : caméra, fichier vidéo
+ * ou suite d'images lue par cv::VideoCapture (par exemple "board_%04d.png").
+ *
+ * Le traitement est découpé en quatre étages, chacun sur son thread, reliés par des files bornées
+ * (BoundedQueue) : décodage -> prétraitement (gris, flou, CLAHE, pixels sombres) -> segmentation (seuillage,
+ * morphologie, extraction des composants) -> rendu (images annotées). Les étages travaillent en même temps
+ * sur des trames successives : le débit est celui de l'étage le plus lent, et non la somme des étages.
+ * Quand un étage (ou le consommateur) prend du retard, sa file se remplit ; les trames les plus anciennes
+ * sont alors jetées (StreamOptions::dropFrames) pour que la sortie reste au plus près du direct.
+ *
+ * Les paramètres peuvent changer pendant le flux (setParams()) : chaque trame emporte les paramètres lus
+ * à son décodage. Indépendante de Qt : le consommateur (fenêtre, outil en ligne de commande) retire les trames
+ * rendues avec next() depuis son propre thread.
+ */
+class FrameStream
+{
+public:
+    explicit FrameStream(const StreamOptions& options = StreamOptions());
+
+    /**
+     * @brief Arrête le flux (voir stop()).
+     */
+    ~FrameStream();
+
+    FrameStream(const FrameStream&) = delete;
+    FrameStream& operator=(const FrameStream&) = delete;
+
+    /**
+     * @brief Ouvre la source sans démarrer le flux.
+     * @param source Numéro de caméra ("0"), chemin d'une vidéo, motif d'une suite d'images ou URL.
+     * @param error Message d'erreur en cas d'échec (optionnel).
+     * @return true si la source est ouverte.
+     */
+    bool open(const std::string& source, std::string* error = nullptr);
+
+    /**
+     * @brief Démarre les quatre étages sur la source ouverte.
+     */
+    void start(const PipelineParams& params);
+
+    /**
+     * @brief Change les paramètres des trames décodées à partir de maintenant.
+     */
+    void setParams(const PipelineParams& params);
+
+    /**
+     * @brief Retire la plus ancienne trame rendue, en attendant au plus `timeout`.
+     * @return false si aucune trame n'est prête (voir isFinished() pour distinguer la fin du flux).
+     */
+    bool next(StreamFrame& frame, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Arrête les étages sans attendre la fin de la source ; les trames en cours sont abandonnées.
+     */
+    void stop();
+
+    /**
+     * @brief Vrai quand plus aucune trame ne sera remise (source épuisée, flux arrêté ou erreur).
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief Message de l'erreur qui a interrompu le flux (vide s'il n'y en a pas eu).
+     */
+    std::string lastError() const;
+
+    /**
+     * @brief Images par seconde annoncées par la source (0 si inconnues, caméra le plus souvent).
+     */
+    double sourceFps() const { return m_sourceFps; }
+
+    StreamStats stats() const;
+
+private:
+    /**
+     * @brief Trame en cours de traitement, passée d'un étage à l'autre.
+     */
+    struct Work
+    {
+        std::uint64_t index = 0;
+        PipelineParams params;                  // Lus au décodage : la trame est traitée de bout en bout avec eux
+        std::chrono::steady_clock::time_point decodedAt;
+        cv::Mat image;                          // Trame décodée (BGR)
+        cv::Mat preprocessed;                   // Gris, flou et CLAHE
+        cv::Mat darkPixels;                     // Pixels sombres, avant fermeture
+        DetectionResult result;                 // Masque et composants (segmentation), puis images (rendu)
+    };
+
+    enum Stage { Decode = 0, Preprocess, Segment, Render, StageCount };
+
+    void decodeLoop();
+    void preprocessLoop();
+    void segmentLoop();
+    void renderLoop();
+
+    void recordStage(Stage stage, std::chrono::steady_clock::time_point begin);
+    void fail(const std::string& message); // Erreur dans un étage : arrête le flux
+    void closeQueues(); // Ferme toutes les files en jetant leur contenu
+
+    StreamOptions m_options;
+    cv::VideoCapture m_capture;
+    double m_sourceFps = 0.0;
+
+    // Files à la sortie de chaque étage ; celle du rendu est lue par le consommateur (next())
+    BoundedQueue<Work> m_toPreprocess;
+    BoundedQueue<Work> m_toSegment;
+    BoundedQueue<Work> m_toRender;
+    BoundedQueue<Work> m_output;
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_stopping{false};
+
+    mutable std::mutex m_paramsMutex;
+    PipelineParams m_params;
+
+    mutable std::mutex m_statsMutex;              // Protège les compteurs ci-dessous
+    std::array<std::uint64_t, StageCount> m_stageFrames{};
+    std::array<double, StageCount> m_stageTotalMs{};
+    std::uint64_t m_delivered = 0;
+    std::deque<std::pair<std::chrono::steady_clock::time_point, double>> m_recent; // Fin de rendu et latence (dernière seconde)
+    std::chrono::steady_clock::time_point m_startedAt;
+    std::string m_error;
+};
+
+#endif // FRAMESTREAM_H
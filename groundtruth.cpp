@@ -0,0 +1,243 @@
+// groundtruth.cpp
+#include "groundtruth.h"
+#include "imagefiles.h"
+#include <algorithm> // std::sort, std::find, std::max
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Retire les espaces en début et en fin de chaîne
+std::string trimmed(const std::string& text)
+{
+    const char* spaces = " \t\r\n";
+    const std::size_t begin = text.find_first_not_of(spaces);
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const std::size_t end = text.find_last_not_of(spaces);
+    return text.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string> splitFields(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        fields.push_back(trimmed(field));
+    }
+    return fields;
+}
+
+// Côté des cases de l'index : de l'ordre de la taille moyenne des annotations
+int cellSizeFor(const std::vector<cv::Rect>& rects)
+{
+    if (rects.empty()) {
+        return 128;
+    }
+    double total = 0.0;
+    for (const cv::Rect& rect : rects) {
+        total += std::max(rect.width, rect.height);
+    }
+    return std::max(16, static_cast<int>(2 * total / rects.size()));
+}
+
+} // namespace
+
+double MatchCounts::precision() const
+{
+    const int detections = truePositives + falsePositives;
+    if (detections == 0) {
+        return falseNegatives == 0 ? 1.0 : 0.0;
+    }
+    return static_cast<double>(truePositives) / detections;
+}
+
+double MatchCounts::recall() const
+{
+    const int annotations = truePositives + falseNegatives;
+    return annotations == 0 ? 1.0 : static_cast<double>(truePositives) / annotations;
+}
+
+double MatchCounts::f1() const
+{
+    const double p = precision(), r = recall();
+    return p + r > 0.0 ? 2.0 * p * r / (p + r) : 0.0;
+}
+
+double MatchCounts::meanIoU() const
+{
+    return truePositives > 0 ? iouSum / truePositives : 0.0;
+}
+
+MatchCounts& MatchCounts::operator+=(const MatchCounts& other)
+{
+    truePositives += other.truePositives;
+    falsePositives += other.falsePositives;
+    falseNegatives += other.falseNegatives;
+    iouSum += other.iouSum;
+    return *this;
+}
+
+double intersectionOverUnion(const cv::Rect& a, const cv::Rect& b)
+{
+    const double intersection = (a & b).area();
+    const double unionArea = static_cast<double>(a.area()) + b.area() - intersection;
+    return unionArea > 0.0 ? intersection / unionArea : 0.0;
+}
+
+GroundTruth::GroundTruth(const std::vector<cv::Rect>& annotations)
+    : m_annotations(annotations)
+    , m_index(cellSizeFor(annotations))
+{
+    for (std::size_t i = 0; i < m_annotations.size(); ++i) {
+        m_index.insert(static_cast<int>(i), m_annotations[i]);
+    }
+}
+
+/**
+ * @brief Appariement glouton par IoU décroissant (voir la description de la classe).
+ * Avec un seuil d'au moins 0,5, une boîte n'a presque jamais plus d'une paire possible : l'ordre ne départage
+ * que les annotations qui se chevauchent.
+ */
+MatchCounts GroundTruth::match(const std::vector<cv::Rect>& detections, double minIoU) const
+{
+    struct Candidate { double iou; int detection; int annotation; };
+    std::vector<Candidate> candidates;
+    for (std::size_t d = 0; d < detections.size(); ++d) {
+        for (int a : m_index.queryRect(detections[d])) {
+            const double iou = intersectionOverUnion(detections[d], m_annotations[a]);
+            if (iou >= minIoU && iou > 0.0) {
+                candidates.push_back({ iou, static_cast<int>(d), a });
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& x, const Candidate& y) {
+        if (x.iou != y.iou) return x.iou > y.iou;
+        return x.detection != y.detection ? x.detection < y.detection : x.annotation < y.annotation;
+    });
+
+    MatchCounts counts;
+    std::vector<bool> detectionUsed(detections.size(), false), annotationUsed(m_annotations.size(), false);
+    for (const Candidate& candidate : candidates) {
+        if (detectionUsed[candidate.detection] || annotationUsed[candidate.annotation]) {
+            continue;
+        }
+        detectionUsed[candidate.detection] = annotationUsed[candidate.annotation] = true;
+        ++counts.truePositives;
+        counts.iouSum += candidate.iou;
+    }
+    counts.falsePositives = static_cast<int>(detections.size()) - counts.truePositives;
+    counts.falseNegatives = static_cast<int>(m_annotations.size()) - counts.truePositives;
+    return counts;
+}
+
+/**
+ * @brief Lit un fichier d'annotations CSV (voir groundtruth.h).
+ * @param path Chemin du fichier.
+ * @param rects Rectangles lus (remplacés seulement si tout le fichier est valide).
+ * @param error Message d'erreur en cas d'échec (optionnel).
+ */
+bool loadAnnotations(const std::string& path, std::vector<cv::Rect>& rects, std::string* error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    std::vector<cv::Rect> loaded;
+    int columns[4] = { -1, -1, -1, -1 }; // Colonnes de x, y, width et height (lues dans l'en-tête)
+    bool headerRead = false;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trimmed(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const std::vector<std::string> fields = splitFields(line);
+        if (!headerRead) {
+            const char* names[4] = { "x", "y", "width", "height" };
+            for (int k = 0; k < 4; ++k) {
+                const auto found = std::find(fields.begin(), fields.end(), names[k]);
+                if (found == fields.end()) {
+                    if (error) *error = path + ":" + std::to_string(lineNumber) + ": header has no '" + names[k] + "' column";
+                    return false;
+                }
+                columns[k] = static_cast<int>(found - fields.begin());
+            }
+            headerRead = true;
+            continue;
+        }
+        int values[4] = { 0, 0, 0, 0 };
+        for (int k = 0; k < 4; ++k) {
+            std::istringstream value(columns[k] < static_cast<int>(fields.size()) ? fields[columns[k]] : std::string());
+            char extra = 0;
+            if (!(value >> values[k]) || (value >> extra)) {
+                // Valeur absente, non entière ou suivie d'autres caractères ("12abc", "3.7")
+                if (error) *error = path + ":" + std::to_string(lineNumber) + ": invalid line '" + line + "'";
+                return false;
+            }
+        }
+        if (values[2] <= 0 || values[3] <= 0) {
+            if (error) *error = path + ":" + std::to_string(lineNumber) + ": empty rectangle in '" + line + "'";
+            return false;
+        }
+        loaded.emplace_back(values[0], values[1], values[2], values[3]);
+    }
+    rects = loaded;
+    return true;
+}
+
+bool saveAnnotations(const std::string& path, const std::vector<cv::Rect>& rects)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "id,x,y,width,height\n";
+    for (std::size_t i = 0; i < rects.size(); ++i) {
+        const cv::Rect& box = rects[i];
+        file << i << ',' << box.x << ',' << box.y << ',' << box.width << ',' << box.height << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+std::string annotationPathFor(const std::string& imagePath)
+{
+    const std::size_t slash = imagePath.find_last_of("/\\");
+    const std::size_t dot = imagePath.find_last_of('.');
+    const std::size_t stemEnd = (dot != std::string::npos && (slash == std::string::npos || dot > slash)) ? dot : imagePath.size();
+    return imagePath.substr(0, stemEnd) + "_annotations.csv";
+}
+
+/**
+ * @brief Parcourt le répertoire avec les surcharges à error_code (construction et incrément) : un répertoire
+ * absent ou illisible donne une liste vide (ou partielle) au lieu de lever filesystem_error.
+ */
+std::vector<AnnotatedImage> findAnnotatedImages(const std::string& directory)
+{
+    std::vector<AnnotatedImage> images;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code fileError;
+        const std::string imagePath = it->path().string();
+        if (!it->is_regular_file(fileError) || !isImageFile(imagePath)) {
+            continue;
+        }
+        const std::string annotations = annotationPathFor(imagePath);
+        if (fs::exists(annotations, fileError)) {
+            images.push_back({ imagePath, annotations });
+        }
+    }
+    std::sort(images.begin(), images.end(), [](const AnnotatedImage& a, const AnnotatedImage& b) {
+        return a.imagePath < b.imagePath;
+    });
+    return images;
+}
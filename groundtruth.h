@@ -0,0 +1,113 @@
+// groundtruth.h
+#ifndef GROUNDTRUTH_H
+#define GROUNDTRUTH_H
+
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "spatialindex.h"
+
+/**
+ * @brief Bilan de l'appariement des détections avec les annotations d'une ou plusieurs images.
+ * Les bilans de plusieurs images s'additionnent (+=) : précision et rappel sont alors ceux de l'ensemble.
+ */
+struct MatchCounts
+{
+    int truePositives = 0;   // Détections appariées à une annotation
+    int falsePositives = 0;  // Détections sans annotation correspondante
+    int falseNegatives = 0;  // Annotations sans détection correspondante
+    double iouSum = 0.0;     // Somme des IoU des paires appariées
+
+    /**
+     * @brief Part des détections qui sont justes (1 s'il n'y a ni détection ni annotation).
+     */
+    double precision() const;
+
+    /**
+     * @brief Part des annotations retrouvées (1 s'il n'y a aucune annotation).
+     */
+    double recall() const;
+
+    /**
+     * @brief Moyenne harmonique de la précision et du rappel.
+     */
+    double f1() const;
+
+    /**
+     * @brief IoU moyen des paires appariées (0 si aucune paire).
+     */
+    double meanIoU() const;
+
+    MatchCounts& operator+=(const MatchCounts& other);
+};
+
+/**
+ * @brief Rapport aire de l'intersection / aire de l'union de deux rectangles (0 si l'un est vide).
+ */
+double intersectionOverUnion(const cv::Rect& a, const cv::Rect& b);
+
+/**
+ * @brief La classe GroundTruth contient les annotations d'une image (rectangles dessinés dans ImageViewer)
+ * et apparie des détections avec elles.
+ *
+ * Une détection et une annotation forment une paire possible si leur IoU atteint le seuil ; les paires sont
+ * retenues de la meilleure à la moins bonne, chaque boîte n'étant appariée qu'une fois. Les annotations sont
+ * indexées une fois pour toutes (SpatialIndex) : un appariement ne compare chaque détection qu'aux annotations
+ * qui la chevauchent, ce qui permet d'évaluer des milliers de jeux de paramètres sur la même image.
+ * Indépendante de Qt.
+ */
+class GroundTruth
+{
+public:
+    GroundTruth() = default;
+    explicit GroundTruth(const std::vector<cv::Rect>& annotations);
+
+    const std::vector<cv::Rect>& annotations() const { return m_annotations; }
+
+    /**
+     * @brief Apparie des détections avec les annotations.
+     * @param detections Boîtes détectées (DetectionResult::rects).
+     * @param minIoU IoU minimal d'une paire.
+     */
+    MatchCounts match(const std::vector<cv::Rect>& detections, double minIoU = 0.5) const;
+
+private:
+    std::vector<cv::Rect> m_annotations;
+    SpatialIndex m_index; // Annotations, identifiant = indice dans m_annotations
+};
+
+/**
+ * @brief Lit un fichier d'annotations CSV : une ligne d'en-tête nommant les colonnes, puis un rectangle par ligne.
+ * Les colonnes x, y, width et height sont lues quelle que soit leur place et les autres sont ignorées :
+ * une liste de composants de pcb_batch (id,x,y,width,height,area), corrigée à la main, est aussi acceptée.
+ * Les lignes vides et celles commençant par '#' sont ignorées.
+ * @return false si le fichier est illisible ou mal formé (`rects` n'est alors pas modifié).
+ */
+bool loadAnnotations(const std::string& path, std::vector<cv::Rect>& rects, std::string* error = nullptr);
+
+/**
+ * @brief Écrit des annotations lisibles par loadAnnotations() (colonnes id,x,y,width,height).
+ */
+bool saveAnnotations(const std::string& path, const std::vector<cv::Rect>& rects);
+
+/**
+ * @brief Fichier d'annotations associé à une image : board.png -> board_annotations.csv, dans le même répertoire.
+ */
+std::string annotationPathFor(const std::string& imagePath);
+
+/**
+ * @brief Image d'un jeu de données et son fichier d'annotations.
+ */
+struct AnnotatedImage
+{
+    std::string imagePath;
+    std::string annotationPath;
+};
+
+/**
+ * @brief Images d'un répertoire (voir isImageFile(), imagefiles.h) qui ont un fichier d'annotations
+ * (voir annotationPathFor()), par ordre de nom. Les images sans annotations sont ignorées.
+ */
+std::vector<AnnotatedImage> findAnnotatedImages(const std::string& directory);
+
+#endif // GROUNDTRUTH_H
@@ -0,0 +1,12 @@
+// imagefiles.cpp
+#include "imagefiles.h"
+#include <algorithm> // std::transform
+#include <cctype>    // std::tolower
+#include <filesystem>
+
+bool isImageFile(const std::string& path)
+{
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tif" || ext == ".tiff";
+}
@@ -0,0 +1,13 @@
+// imagefiles.h
+#ifndef IMAGEFILES_H
+#define IMAGEFILES_H
+
+#include <string>
+
+/**
+ * @brief Vrai si l'extension du fichier (sans tenir compte de la casse) est celle d'un format d'image
+ * pris en charge : .png .jpg .jpeg .bmp .tif .tiff.
+ */
+bool isImageFile(const std::string& path);
+
+#endif // IMAGEFILES_H
@@ -0,0 +1,42 @@
+// imagepyramid.cpp
+#include "imagepyramid.h"
+#include <algorithm>             // std::max
+#include <cmath>                 // std::floor, std::log2
+#include <opencv2/imgproc.hpp>   // resize
+#include "pipelineprofiler.h"    // Mesure de la construction de la pyramide (ScopedStageTimer)
+
+/**
+ * @brief Construit les niveaux par réductions successives de moitié.
+ * Chaque réduction part du niveau précédent (et non de la source) : le coût total est celui d'une lecture
+ * de la source plus un tiers, et la moyenne INTER_AREA évite le crénelage des niveaux réduits.
+ */
+void ImagePyramid::build(const cv::Mat& image, int minSide)
+{
+    ScopedStageTimer timer("ImagePyramid::build");
+    m_levels.clear();
+    if (image.empty()) {
+        return;
+    }
+    minSide = std::max(1, minSide);
+    m_levels.push_back(image);
+    while (std::max(m_levels.back().cols, m_levels.back().rows) > minSide) {
+        const cv::Mat& previous = m_levels.back();
+        const cv::Size half((previous.cols + 1) / 2, (previous.rows + 1) / 2);
+        cv::Mat next;
+        cv::resize(previous, next, half, 0, 0, cv::INTER_AREA);
+        m_levels.push_back(next);
+    }
+}
+
+/**
+ * @brief Choisit le niveau 2^-L le plus petit tel que 2^-L >= scale : l'affichage réduit ce niveau
+ * d'un facteur compris entre 1 et 2, sans jamais l'agrandir (sauf au niveau 0).
+ */
+int ImagePyramid::levelForScale(double scale) const
+{
+    if (m_levels.empty() || scale >= 1.0 || scale <= 0.0) {
+        return 0;
+    }
+    const int level = static_cast<int>(std::floor(std::log2(1.0 / scale)));
+    return std::min(level, levelCount() - 1);
+}
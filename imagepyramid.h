@@ -0,0 +1,50 @@
+// imagepyramid.h
+#ifndef IMAGEPYRAMID_H
+#define IMAGEPYRAMID_H
+
+#include <vector>
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Pyramide d'images (mip-maps) : chaque niveau est le précédent réduit de moitié (INTER_AREA).
+ *
+ * Le niveau 0 partage les pixels de l'image source (aucune copie) ; les niveaux suivants ajoutent au plus
+ * un tiers de sa taille. Le dernier niveau est le premier dont le plus grand côté tient dans `minSide`.
+ * Sert à l'affichage zoomable (ImageViewer) : à chaque facteur de zoom correspond un niveau dont on
+ * ne lit que les tuiles visibles.
+ */
+class ImagePyramid
+{
+public:
+    /**
+     * @brief Construit la pyramide d'une image (remplace la précédente).
+     * @param image L'image source (partagée, ne doit plus être modifiée).
+     * @param minSide Plus grand côté du dernier niveau.
+     */
+    void build(const cv::Mat& image, int minSide = 256);
+
+    /**
+     * @brief Libère tous les niveaux.
+     */
+    void clear() { m_levels.clear(); }
+
+    bool empty() const { return m_levels.empty(); }
+    int levelCount() const { return static_cast<int>(m_levels.size()); }
+
+    /**
+     * @brief Niveau `index` (0 : pleine résolution), de taille ceil(taille source / 2^index).
+     */
+    const cv::Mat& level(int index) const { return m_levels[index]; }
+
+    /**
+     * @brief Niveau le plus réduit dont la résolution reste au moins égale à celle de l'affichage.
+     * @param scale Pixels affichés par pixel de l'image source.
+     * @return L'indice du niveau (0 si scale >= 1 ou si la pyramide est vide).
+     */
+    int levelForScale(double scale) const;
+
+private:
+    std::vector<cv::Mat> m_levels;
+};
+
+#endif // IMAGEPYRAMID_H
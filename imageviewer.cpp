@@ -5,11 +5,25 @@
 #include <QCursor>         // Inclut la classe QCursor pour obtenir la position du curseur
 #include <QSize>           // Inclut la classe QSize pour gérer les dimensions
 #include <QtMath>          // Inclut des fonctions mathématiques de Qt (comme qBound)
+#include "matimage.h"      // Conversion cv::Mat -> QPixmap sans copie intermédiaire
+#include <QResizeEvent>    // Inclut l'événement de redimensionnement (ajustement de la vue)
+#include <QPaintEvent>     // Inclut l'événement de peinture (zone à repeindre)
+#include <algorithm>       // Inclut std::min et std::max
+#include <cmath>           // Inclut std::floor et std::pow (tuiles visibles, facteur de zoom)
+
+namespace {
+// Côté des tuiles lues dans les niveaux de la pyramide
+constexpr int kTileSize = 256;
+// Zoom maximal : 16 pixels affichés par pixel de l'image
+constexpr double kMaxScale = 16.0;
+}
 
 // Constructeur de la classe ImageViewer
 // Initialise le widget avec un parent, et met le drapeau 'drawing' à false (pas de dessin en cours)
 ImageViewer::ImageViewer(QWidget *parent)
-    : QWidget(parent), drawing(false) {
+    : QWidget(parent), hovered_annotation(-1), hovered_detection(-1), drawing(false),
+      tile_cache(64 * 1024), view_scale(1.0),
+      fit_mode(true), panning(false) {
     // Définit la taille minimale du widget pour assurer une visibilité de base
     setMinimumSize(400, 300);
     // Active le suivi de la souris même sans bouton enfoncé, nécessaire pour dessiner en temps réel
@@ -18,16 +32,17 @@ ImageViewer::ImageViewer(QWidget *parent)
 
 // Définit l'image originale à afficher dans l'ImageViewer
 void ImageViewer::setImage(const cv::Mat& image) {
-    // Clone l'image OpenCV fournie pour ne pas modifier l'originale extérieurement
-    original_image_cv = image.clone();
+    // Partage les pixels sans copie : l'image n'est jamais modifiée en place (getImageWithRectangles dessine sur une copie)
+    original_image_cv = image;
     // Vérifie si l'image n'est pas vide
     if (!original_image_cv.empty()) {
-        // Convertit l'image OpenCV du format BGR (utilisé par OpenCV par défaut) en RGB (préféré par Qt)
-        cv::cvtColor(original_image_cv, original_image_cv, cv::COLOR_BGR2RGB);
-        // Convertit l'image OpenCV (cv::Mat) en QImage pour l'affichage avec Qt
-        current_image_qt = cvMatToQImage(original_image_cv);
-        // Efface tous les rectangles déjà dessinés lorsque une nouvelle image est chargée
-        drawn_rectangles.clear();
+        // Construit la pyramide (une fois par image) et affiche l'image entière
+        pyramid.build(original_image_cv, kTileSize);
+        tile_cache.clear();
+        fitToWindow();
+        // Efface tous les rectangles déjà dessinés et les détections lorsque une nouvelle image est chargée
+        setDrawnRectangles({});
+        setDetections({});
         // Vide l'historique d'annulation pour la nouvelle image
         while (!undo_history.empty()) {
             undo_history.pop();
@@ -37,10 +52,12 @@ void ImageViewer::setImage(const cv::Mat& image) {
     } else {
         // Affiche un avertissement si l'image fournie est vide
         qWarning() << "ImageViewer received empty image.";
-        // Efface la QImage si l'image OpenCV est vide
-        current_image_qt = QImage();
-        // Efface les rectangles et l'historique dans ce cas également
-        drawn_rectangles.clear();
+        // Efface l'image affichée si l'image OpenCV est vide
+        pyramid.clear();
+        tile_cache.clear();
+        // Efface les rectangles, les détections et l'historique dans ce cas également
+        setDrawnRectangles({});
+        setDetections({});
         while (!undo_history.empty()) {
             undo_history.pop();
         }
@@ -49,25 +66,6 @@ void ImageViewer::setImage(const cv::Mat& image) {
     }
 }
 
-// Convertit une image OpenCV (cv::Mat) en QImage
-QImage ImageViewer::cvMatToQImage(const cv::Mat &mat) {
-    // Gère le cas des images couleur (3 canaux, 8 bits par canal, non signés)
-    if (mat.type() == CV_8UC3) {
-        // Crée une QImage directement à partir des données de la cv::Mat
-        return QImage(mat.data, mat.cols, mat.rows, mat.step, QImage::Format_RGB888);
-    }
-    // Gère le cas des images en niveaux de gris (1 canal, 8 bits par canal, non signés)
-    else if (mat.type() == CV_8UC1) {
-        // Crée une QImage à partir des données de la cv::Mat pour le format niveaux de gris
-        return QImage(mat.data, mat.cols, mat.rows, mat.step, QImage::Format_Grayscale8);
-    }
-    // Gère les types d'images non supportés
-    else {
-        qWarning("Unsupported cv::Mat type for QImage conversion");
-        return QImage(); // Retourne une QImage nulle
-    }
-}
-
 // Retourne l'image originale avec tous les rectangles dessinés par l'utilisateur
 cv::Mat ImageViewer::getImageWithRectangles() const {
     // Vérifie si l'image originale est vide
@@ -77,9 +75,6 @@ cv::Mat ImageViewer::getImageWithRectangles() const {
     }
     // Clone l'image originale pour y dessiner les rectangles sans la modifier directement
     cv::Mat image_with_rects = original_image_cv.clone();
-    // Reconvertit l'image de RGB à BGR avant de dessiner avec OpenCV et de la retourner
-    cv::cvtColor(image_with_rects, image_with_rects, cv::COLOR_RGB2BGR);
-
     // Parcourt tous les rectangles stockés
     for (const auto& rect : drawn_rectangles) {
         // Dessine chaque rectangle sur l'image avec une couleur bleue (0,0,255) et une épaisseur de 2
@@ -88,135 +83,315 @@ cv::Mat ImageViewer::getImageWithRectangles() const {
     return image_with_rects; // Retourne l'image avec les rectangles dessinés
 }
 
-// Gère l'événement de peinture, responsable du dessin de l'image et des rectangles
+// Ajuste la vue pour afficher l'image entière, centrée (équivalent à Qt::KeepAspectRatio)
+void ImageViewer::applyFitView() {
+    if (original_image_cv.empty() || width() <= 0 || height() <= 0) {
+        view_scale = 1.0;
+        view_offset = QPointF();
+        return;
+    }
+    view_scale = std::min(static_cast<double>(width()) / original_image_cv.cols,
+                          static_cast<double>(height()) / original_image_cv.rows);
+    view_offset = QPointF((width() - original_image_cv.cols * view_scale) / 2.0,
+                          (height() - original_image_cv.rows * view_scale) / 2.0);
+}
+
+// Revient à l'image entière ajustée au widget
+void ImageViewer::fitToWindow() {
+    fit_mode = true;
+    applyFitView();
+    update();
+}
+
+// Convertit un point du widget en coordonnées de l'image originale
+QPoint ImageViewer::widgetToImage(const QPoint& widget_point) const {
+    return QPoint(static_cast<int>(std::floor((widget_point.x() - view_offset.x()) / view_scale)),
+                  static_cast<int>(std::floor((widget_point.y() - view_offset.y()) / view_scale)));
+}
+
+// Convertit un rectangle de l'image originale en coordonnées du widget
+QRect ImageViewer::imageToWidget(const cv::Rect& image_rect_cv) const {
+    const QPoint top_left(qRound(view_offset.x() + image_rect_cv.x * view_scale),
+                          qRound(view_offset.y() + image_rect_cv.y * view_scale));
+    const QPoint bottom_right(qRound(view_offset.x() + (image_rect_cv.x + image_rect_cv.width) * view_scale),
+                              qRound(view_offset.y() + (image_rect_cv.y + image_rect_cv.height) * view_scale));
+    return QRect(top_left, bottom_right - QPoint(1, 1));
+}
+
+// Rectangle en cours de dessin, en coordonnées du widget
+QRect ImageViewer::rubberBandRect() const {
+    const QRect image_widget = imageToWidget(cv::Rect(0, 0, original_image_cv.cols, original_image_cv.rows));
+    const QPoint start(qRound(view_offset.x() + start_point.x() * view_scale),
+                       qRound(view_offset.y() + start_point.y() * view_scale));
+    // Limite la position actuelle de la souris aux bords de l'image affichée
+    const QPoint current(qBound(image_widget.left(), current_point.x(), image_widget.right() + 1),
+                         qBound(image_widget.top(), current_point.y(), image_widget.bottom() + 1));
+    return QRect(start, current).normalized();
+}
+
+// Retourne une tuile d'un niveau de la pyramide. Seules les tuiles affichées sont converties en QPixmap ;
+// le cache les garde pour les repeintures suivantes et évince les moins récemment utilisées.
+QPixmap ImageViewer::tilePixmap(int level, int tx, int ty) {
+    const quint64 key = (static_cast<quint64>(level) << 48) | (static_cast<quint64>(ty) << 24) | static_cast<quint64>(tx);
+    if (const QPixmap* cached = tile_cache.object(key)) {
+        return *cached;
+    }
+    const cv::Mat& source = pyramid.level(level);
+    const cv::Rect tile_rect = cv::Rect(tx * kTileSize, ty * kTileSize, kTileSize, kTileSize)
+                               & cv::Rect(0, 0, source.cols, source.rows);
+    QPixmap* pixmap = new QPixmap(matToQPixmap(source(tile_rect)));
+    const QPixmap result = *pixmap;
+    const int cost = std::max(1, pixmap->width() * pixmap->height() * std::max(1, pixmap->depth() / 8) / 1024);
+    tile_cache.insert(key, pixmap, cost); // Le cache devient propriétaire
+    return result;
+}
+
+// Zone de l'image qui correspond à une zone du widget, élargie d'une marge couvrant l'épaisseur du stylo
+cv::Rect ImageViewer::widgetToImageArea(const QRect& widget_rect) const {
+    const int margin = static_cast<int>(std::ceil(4.0 / view_scale)) + 1;
+    const QPoint top_left = widgetToImage(widget_rect.topLeft());
+    const QPoint bottom_right = widgetToImage(widget_rect.bottomRight());
+    return cv::Rect(cv::Point(top_left.x() - margin, top_left.y() - margin),
+                    cv::Point(bottom_right.x() + margin + 1, bottom_right.y() + margin + 1));
+}
+
+// Remplace les annotations. L'index n'est modifié que pour la différence : annuler un ajout ne retire
+// que le dernier rectangle, et seul un état sans préfixe commun (annulation d'un effacement) est réindexé.
+void ImageViewer::setDrawnRectangles(const std::vector<cv::Rect>& rectangles) {
+    size_t common = 0;
+    while (common < rectangles.size() && common < drawn_rectangles.size()
+           && rectangles[common] == drawn_rectangles[common]) {
+        ++common;
+    }
+    for (size_t id = common; id < drawn_rectangles.size(); ++id) {
+        annotation_index.remove(static_cast<int>(id));
+    }
+    for (size_t id = common; id < rectangles.size(); ++id) {
+        annotation_index.insert(static_cast<int>(id), rectangles[id]);
+    }
+    drawn_rectangles = rectangles;
+    if (hovered_annotation >= static_cast<int>(drawn_rectangles.size())) {
+        hovered_annotation = -1;
+        emit hoverChanged(hovered_annotation, hovered_detection);
+    }
+}
+
+// Remplace les boîtes des composants détectés (nouveau résultat du pipeline)
+void ImageViewer::setDetections(const std::vector<cv::Rect>& new_detections) {
+    detections = new_detections;
+    detection_index.clear();
+    for (size_t id = 0; id < detections.size(); ++id) {
+        detection_index.insert(static_cast<int>(id), detections[id]);
+    }
+    if (hovered_detection != -1) {
+        hovered_detection = -1;
+        emit hoverChanged(hovered_annotation, hovered_detection);
+    }
+    update();
+}
+
+// Détections qui chevauchent une annotation : une recherche dans l'index au lieu d'un parcours de toutes les boîtes
+std::vector<int> ImageViewer::detectionsOverlappingAnnotation(int annotation) const {
+    if (annotation < 0 || annotation >= static_cast<int>(drawn_rectangles.size())) {
+        return {};
+    }
+    return detection_index.queryRect(drawn_rectangles[annotation]);
+}
+
+// Met à jour l'annotation et la détection sous le curseur ; seules les boîtes concernées sont repeintes
+void ImageViewer::updateHover(const QPoint& widget_point) {
+    const QPoint point = widgetToImage(widget_point);
+    const cv::Point image_point(point.x(), point.y());
+    const std::vector<int> annotations = annotation_index.queryPoint(image_point);
+    const std::vector<int> found = detection_index.queryPoint(image_point);
+    const int annotation = annotations.empty() ? -1 : annotations.back(); // La plus récente est dessinée au-dessus
+    const int detection = found.empty() ? -1 : found.back();
+    if (annotation == hovered_annotation && detection == hovered_detection) {
+        return;
+    }
+    // Repeint l'ancienne et la nouvelle boîte survolée
+    const auto repaint = [this](const std::vector<cv::Rect>& rects, int id) {
+        if (id >= 0 && id < static_cast<int>(rects.size())) {
+            update(imageToWidget(rects[id]).adjusted(-3, -3, 3, 3));
+        }
+    };
+    repaint(drawn_rectangles, hovered_annotation);
+    repaint(detections, hovered_detection);
+    hovered_annotation = annotation;
+    hovered_detection = detection;
+    repaint(drawn_rectangles, hovered_annotation);
+    repaint(detections, hovered_detection);
+    emit hoverChanged(hovered_annotation, hovered_detection);
+}
+
+// Le curseur quitte le widget : plus rien n'est survolé
+void ImageViewer::leaveEvent(QEvent *event) {
+    QWidget::leaveEvent(event);
+    if (hovered_annotation != -1 || hovered_detection != -1) {
+        update();
+        hovered_annotation = -1;
+        hovered_detection = -1;
+        emit hoverChanged(hovered_annotation, hovered_detection);
+    }
+}
+
+// Gère le redimensionnement : la vue reste ajustée au widget tant que l'utilisateur n'a pas zoomé
+void ImageViewer::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    if (fit_mode) {
+        applyFitView();
+    }
+}
+
+// Gère l'événement de peinture, responsable du dessin de l'image et des rectangles.
+// Seules les tuiles visibles du niveau adapté au zoom sont dessinées : le coût dépend de la taille du widget,
+// pas de celle de l'image.
 void ImageViewer::paintEvent(QPaintEvent *event) {
-    Q_UNUSED(event); // Marque l'argument 'event' comme inutilisé pour éviter les avertissements de compilation
     QPainter painter(this); // Crée un objet QPainter pour dessiner sur ce widget
-
-    // Si une image Qt est disponible (non nulle)
-    if (!current_image_qt.isNull()) {
-        QSize widgetSize = size(); // Obtient la taille actuelle du widget
-        // Redimensionne l'image pour qu'elle s'adapte au widget, en conservant le ratio et en lissant
-        QImage scaledImage = current_image_qt.scaled(widgetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-
-        // Calcule les décalages (offsets) pour centrer l'image dans le widget
-        int x_offset = (widgetSize.width() - scaledImage.width()) / 2;
-        int y_offset = (widgetSize.height() - scaledImage.height()) / 2;
-
-        // Dessine l'image redimensionnée et centrée sur le widget
-        painter.drawImage(x_offset, y_offset, scaledImage);
-
-        // Dessine les rectangles déjà tracés
-        for (const auto& rect_cv : drawn_rectangles) {
-            // Calcule les facteurs d'échelle pour convertir les coordonnées de l'image originale
-            // aux coordonnées de l'image redimensionnée affichée
-            double scale_w = (double)scaledImage.width() / original_image_cv.cols;
-            double scale_h = (double)scaledImage.height() / original_image_cv.rows;
-
-            // Convertit les coordonnées et la taille du rectangle de l'espace de l'image originale
-            // à l'espace de l'image affichée (en tenant compte du centrage)
-            int rect_x = x_offset + static_cast<int>(rect_cv.x * scale_w);
-            int rect_y = y_offset + static_cast<int>(rect_cv.y * scale_h);
-            int rect_width = static_cast<int>(rect_cv.width * scale_w);
-            int rect_height = static_cast<int>(rect_cv.height * scale_h);
-
-            // Définit le stylo pour dessiner le rectangle (rouge, épaisseur 2)
-            painter.setPen(QPen(Qt::red, 2));
-            // Dessine le rectangle
-            painter.drawRect(rect_x, rect_y, rect_width, rect_height);
+    if (pyramid.empty()) {
+        return;
+    }
+    const QRect dirty = event->rect(); // Zone à repeindre (seulement autour du rectangle en cours pendant le dessin)
+
+    // Niveau de la pyramide et échelle d'affichage de ses pixels (entre 0,5 et 1 sauf au niveau 0)
+    const int level = pyramid.levelForScale(view_scale);
+    const cv::Mat& source = pyramid.level(level);
+    const double level_scale = view_scale * (1 << level);
+
+    // Partie visible du niveau, en tuiles
+    const double left = (dirty.left() - view_offset.x()) / level_scale;
+    const double top = (dirty.top() - view_offset.y()) / level_scale;
+    const double right = (dirty.right() + 1 - view_offset.x()) / level_scale;
+    const double bottom = (dirty.bottom() + 1 - view_offset.y()) / level_scale;
+    const int tiles_x = (source.cols + kTileSize - 1) / kTileSize;
+    const int tiles_y = (source.rows + kTileSize - 1) / kTileSize;
+    const int tx0 = std::max(0, static_cast<int>(std::floor(left / kTileSize)));
+    const int ty0 = std::max(0, static_cast<int>(std::floor(top / kTileSize)));
+    const int tx1 = std::min(tiles_x - 1, static_cast<int>(std::floor(right / kTileSize)));
+    const int ty1 = std::min(tiles_y - 1, static_cast<int>(std::floor(bottom / kTileSize)));
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, level_scale < 1.0);
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            const QPixmap tile = tilePixmap(level, tx, ty);
+            // Bords arrondis de la même façon pour deux tuiles voisines : pas de joint visible entre elles
+            const int x0 = qRound(view_offset.x() + tx * kTileSize * level_scale);
+            const int y0 = qRound(view_offset.y() + ty * kTileSize * level_scale);
+            const int x1 = qRound(view_offset.x() + (tx * kTileSize + tile.width()) * level_scale);
+            const int y1 = qRound(view_offset.y() + (ty * kTileSize + tile.height()) * level_scale);
+            painter.drawPixmap(QRect(x0, y0, x1 - x0, y1 - y0), tile);
         }
+    }
 
-        // Si l'utilisateur est en train de dessiner un nouveau rectangle
-        if (drawing) {
-            QPoint current_mouse_pos = mapFromGlobal(QCursor::pos()); // Obtient la position actuelle de la souris (globale puis convertie en locale)
+    // Seuls les rectangles qui touchent la zone à repeindre sont dessinés (recherche dans les index spatiaux)
+    const cv::Rect dirty_image = widgetToImageArea(dirty);
 
-            // Recalcule les facteurs d'échelle (identiques à ceux utilisés pour les rectangles existants)
-            double scale_w = (double)scaledImage.width() / original_image_cv.cols;
-            double scale_h = (double)scaledImage.height() / original_image_cv.rows;
+    // Dessine les boîtes des composants détectés (vert, épaisseur 1) sous les annotations
+    painter.setPen(QPen(Qt::green, 1));
+    for (int id : detection_index.queryRect(dirty_image)) {
+        painter.drawRect(imageToWidget(detections[id]));
+    }
 
-            // Convertit le point de départ du dessin (qui est en coordonnées de l'image originale)
-            // en coordonnées de l'image affichée
-            int draw_start_x_scaled = x_offset + static_cast<int>(start_point.x() * scale_w);
-            int draw_start_y_scaled = y_offset + static_cast<int>(start_point.y() * scale_h);
+    // Dessine les rectangles déjà tracés (rouge, épaisseur 2)
+    painter.setPen(QPen(Qt::red, 2));
+    for (int id : annotation_index.queryRect(dirty_image)) {
+        painter.drawRect(imageToWidget(drawn_rectangles[id]));
+    }
 
-            // Coordonnées actuelles de la souris, déjà en coordonnées du widget
-            int draw_current_x_scaled = current_mouse_pos.x();
-            int draw_current_y_scaled = current_mouse_pos.y();
+    // Met en évidence la détection et l'annotation survolées (jaune, épaisseur 3)
+    painter.setPen(QPen(Qt::yellow, 3));
+    if (hovered_detection >= 0) {
+        painter.drawRect(imageToWidget(detections[hovered_detection]));
+    }
+    if (hovered_annotation >= 0) {
+        painter.drawRect(imageToWidget(drawn_rectangles[hovered_annotation]));
+    }
+    painter.setPen(QPen(Qt::red, 2));
 
-            // Limite les coordonnées actuelles de la souris à l'intérieur des bords de l'image affichée
-            draw_current_x_scaled = qBound(x_offset, draw_current_x_scaled, x_offset + scaledImage.width());
-            draw_current_y_scaled = qBound(y_offset, draw_current_y_scaled, y_offset + scaledImage.height());
+    // Si l'utilisateur est en train de dessiner un nouveau rectangle, dessine-le par-dessus
+    if (drawing) {
+        painter.drawRect(rubberBandRect());
+    }
+}
 
-            // Définit le stylo pour dessiner le rectangle en cours (rouge, épaisseur 2)
-            painter.setPen(QPen(Qt::red, 2));
-            // Dessine le rectangle temporaire pendant le dessin
-            painter.drawRect(QRect(QPoint(draw_start_x_scaled, draw_start_y_scaled), QPoint(draw_current_x_scaled, draw_current_y_scaled)));
-        }
+// Gère la molette : zoom centré sur le curseur (le point de l'image sous le curseur ne bouge pas)
+void ImageViewer::wheelEvent(QWheelEvent *event) {
+    if (pyramid.empty() || event->angleDelta().y() == 0) {
+        return;
+    }
+    const double factor = std::pow(1.25, event->angleDelta().y() / 120.0);
+    // Zoom arrière borné à l'image entière (ou à la taille réelle si elle est plus petite que le widget)
+    const double min_scale = std::min(1.0, std::min(static_cast<double>(width()) / original_image_cv.cols,
+                                                    static_cast<double>(height()) / original_image_cv.rows));
+    const double new_scale = qBound(min_scale, view_scale * factor, kMaxScale);
+    if (new_scale == view_scale) {
+        return;
     }
+    const QPointF cursor = event->position();
+    view_offset = cursor - (cursor - view_offset) * (new_scale / view_scale);
+    view_scale = new_scale;
+    fit_mode = false;
+    update();
 }
 
 // Gère l'événement de pression du bouton de la souris
 void ImageViewer::mousePressEvent(QMouseEvent *event) {
-    // Vérifie si le bouton gauche de la souris est pressé et si une image est chargée
-    if (event->button() == Qt::LeftButton && !original_image_cv.empty()) {
-        QPoint mouse_pos_widget = event->pos(); // Obtient la position de la souris relative au widget
-
-        QSize widgetSize = size(); // Obtient la taille actuelle du widget
-        QImage scaledImage = current_image_qt.scaled(widgetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        int offset_x = (widgetSize.width() - scaledImage.width()) / 2; // Offset X de l'image affichée
-        int offset_y = (widgetSize.height() - scaledImage.height()) / 2; // Offset Y de l'image affichée
-
-        // Vérifie si la position de la souris est à l'intérieur de l'image affichée
-        if (mouse_pos_widget.x() >= offset_x && mouse_pos_widget.x() < offset_x + scaledImage.width() &&
-            mouse_pos_widget.y() >= offset_y && mouse_pos_widget.y() < offset_y + scaledImage.height()) {
-
-            // Calcule les facteurs d'échelle pour convertir les coordonnées de l'image affichée
-            // aux coordonnées de l'image originale
-            double scale_w = (double)original_image_cv.cols / scaledImage.width();
-            double scale_h = (double)original_image_cv.rows / scaledImage.height();
-
-            // Convertit la position de la souris (en coordonnées du widget)
-            // en coordonnées de l'image originale et la définit comme point de départ
-            start_point.setX(static_cast<int>((mouse_pos_widget.x() - offset_x) * scale_w));
-            start_point.setY(static_cast<int>((mouse_pos_widget.y() - offset_y) * scale_h));
-
-            drawing = true; // Indique qu'un dessin est en cours
-        }
+    if (original_image_cv.empty()) {
+        return;
+    }
+    // Bouton du milieu ou bouton droit : déplacement de la vue
+    if (event->button() == Qt::MiddleButton || event->button() == Qt::RightButton) {
+        panning = true;
+        pan_last = event->pos();
+        setCursor(Qt::ClosedHandCursor);
+        return;
+    }
+    // Bouton gauche à l'intérieur de l'image affichée : début d'un rectangle
+    const QPoint image_point = widgetToImage(event->pos());
+    if (event->button() == Qt::LeftButton && image_point.x() >= 0 && image_point.y() >= 0
+        && image_point.x() < original_image_cv.cols && image_point.y() < original_image_cv.rows) {
+        // La position de la souris en coordonnées de l'image originale est le point de départ
+        start_point = image_point;
+        current_point = event->pos();
+        drawing = true; // Indique qu'un dessin est en cours
     }
 }
 
 // Gère l'événement de mouvement de la souris
 void ImageViewer::mouseMoveEvent(QMouseEvent *event) {
-    Q_UNUSED(event); // Marque l'argument 'event' comme inutilisé
-    // Si un dessin est en cours, force le rafraîchissement pour que le rectangle temporaire soit mis à jour
-    if (drawing) {
+    if (panning) {
+        view_offset += QPointF(event->pos() - pan_last);
+        pan_last = event->pos();
+        fit_mode = false;
         update();
+        return;
+    }
+    // Si un dessin est en cours, ne repeint que l'ancien et le nouveau rectangle temporaire (plus la marge du stylo)
+    if (drawing) {
+        const QRect old_band = rubberBandRect();
+        current_point = event->pos();
+        update(old_band.united(rubberBandRect()).adjusted(-2, -2, 2, 2));
+        return;
+    }
+    // Sinon, recherche ce qui se trouve sous le curseur
+    if (!original_image_cv.empty()) {
+        updateHover(event->pos());
     }
 }
 
 // Gère l'événement de relâchement du bouton de la souris
 void ImageViewer::mouseReleaseEvent(QMouseEvent *event) {
+    if (panning && (event->button() == Qt::MiddleButton || event->button() == Qt::RightButton)) {
+        panning = false;
+        unsetCursor();
+        return;
+    }
     // Vérifie si le bouton gauche est relâché, si un dessin était en cours et si une image est chargée
     if (event->button() == Qt::LeftButton && drawing && !original_image_cv.empty()) {
         drawing = false; // Arrête le mode dessin
 
-        QPoint end_point_widget = event->pos(); // Obtient la position de la souris lors du relâchement
-
-        QSize widgetSize = size(); // Obtient la taille actuelle du widget
-        QImage scaledImage = current_image_qt.scaled(widgetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        int offset_x = (widgetSize.width() - scaledImage.width()) / 2; // Offset X de l'image affichée
-        int offset_y = (widgetSize.height() - scaledImage.height()) / 2; // Offset Y de l'image affichée
-
-        // Calcule les facteurs d'échelle pour convertir les coordonnées de l'image affichée
-        // aux coordonnées de l'image originale
-        double scale_w = (double)original_image_cv.cols / scaledImage.width();
-        double scale_h = (double)original_image_cv.rows / scaledImage.height();
-
-        QPoint end_point_original;
-        // Convertit la position de la souris (en coordonnées du widget)
-        // en coordonnées de l'image originale et la définit comme point de fin
-        end_point_original.setX(static_cast<int>((end_point_widget.x() - offset_x) * scale_w));
-        end_point_original.setY(static_cast<int>((end_point_widget.y() - offset_y) * scale_h));
+        // Convertit la position de la souris en coordonnées de l'image originale : c'est le point de fin
+        QPoint end_point_original = widgetToImage(event->pos());
 
         // Normalise les coordonnées de début et de fin pour s'assurer qu'elles sont dans les limites de l'image
         // et que le rectangle a une largeur/hauteur positive.
@@ -236,8 +411,9 @@ void ImageViewer::mouseReleaseEvent(QMouseEvent *event) {
         if (new_rect.width > 0 && new_rect.height > 0) {
             saveStateToUndoHistory(); // Sauvegarde l'état actuel (rectangles avant l'ajout) pour l'annulation
             drawn_rectangles.push_back(new_rect); // Ajoute le nouveau rectangle à la liste
-            update(); // Rafraîchit l'affichage pour montrer le nouveau rectangle
+            annotation_index.insert(static_cast<int>(drawn_rectangles.size()) - 1, new_rect); // Et à l'index
         }
+        update(); // Rafraîchit l'affichage (nouveau rectangle, ou effacement du rectangle temporaire)
     }
 }
 
@@ -255,25 +431,32 @@ void ImageViewer::saveStateToUndoHistory() {
 void ImageViewer::undoLastRectangle() {
     // Vérifie si l'historique d'annulation n'est pas vide
     if (!undo_history.empty()) {
-        drawn_rectangles = undo_history.top(); // Rétablit la liste des rectangles à l'état précédent (le haut de la pile)
+        setDrawnRectangles(undo_history.top()); // Rétablit la liste des rectangles à l'état précédent (le haut de la pile)
         undo_history.pop(); // Retire cet état de la pile d'historique
         update(); // Redessine l'image avec les rectangles mis à jour
     } else {
         qDebug() << "Undo history is empty. Cannot undo further."; // Message si l'historique est vide
         // Optionnel : si drawn_rectangles n'est pas vide mais l'historique l'est (cas où il n'y a plus rien à annuler)
         if (!drawn_rectangles.empty()) {
-            drawn_rectangles.clear(); // Efface l'état actuel si l'historique est vide
+            setDrawnRectangles({}); // Efface l'état actuel si l'historique est vide
             update(); // Redessine
         }
     }
 }
 
+// Remplace toutes les annotations, par exemple par celles d'un fichier ; l'état précédent reste annulable
+void ImageViewer::replaceDrawnRectangles(const std::vector<cv::Rect>& rectangles) {
+    saveStateToUndoHistory();
+    setDrawnRectangles(rectangles);
+    update();
+}
+
 // Implémentation de la fonction pour effacer tous les rectangles
 void ImageViewer::clearAllRectangles() {
     // Vérifie s'il y a des rectangles à effacer
     if (!drawn_rectangles.empty()) {
         saveStateToUndoHistory(); // Sauvegarde l'état actuel avant d'effacer, pour permettre une annulation
-        drawn_rectangles.clear(); // Efface tous les rectangles de la liste
+        setDrawnRectangles({}); // Efface tous les rectangles de la liste (et de l'index)
         update(); // Rafraîchit l'affichage
         qDebug() << "All rectangles cleared."; // Message de débogage
     } else {
@@ -3,9 +3,14 @@
 
 #include <QWidget>
 #include <QImage>
+#include <QPixmap>
 #include <QPainter>
 #include <QMouseEvent>
+#include <QWheelEvent>
+#include <QCache>
 #include <opencv2/opencv.hpp>
+#include "imagepyramid.h" // Niveaux réduits de l'image pour le zoom (bibliothèque pcb_core)
+#include "spatialindex.h" // Recherche des rectangles sous le curseur ou dans une zone (bibliothèque pcb_core)
 #include <vector>
 #include <stack> // ADDED: For undo history
 
@@ -17,31 +22,84 @@ public:
     void setImage(const cv::Mat& image);
     cv::Mat getImageWithRectangles() const;
     const std::vector<cv::Rect>& getDrawnRectangles() const { return drawn_rectangles; }
+    const cv::Mat& getImage() const { return original_image_cv; }
+    // Remplace toutes les annotations (fichier d'annotations chargé) ; l'opération peut être annulée
+    void replaceDrawnRectangles(const std::vector<cv::Rect>& rectangles);
+
+    // Boîtes des composants détectés, affichées sous les annotations (remplacées à chaque nouveau résultat)
+    void setDetections(const std::vector<cv::Rect>& detections);
+    const std::vector<cv::Rect>& getDetections() const { return detections; }
+
+    // Index spatiaux des annotations (identifiant : indice dans getDrawnRectangles()) et des détections
+    // (identifiant : indice dans getDetections()), tenus à jour à chaque ajout, annulation ou résultat
+    const SpatialIndex& annotationIndex() const { return annotation_index; }
+    const SpatialIndex& detectionIndex() const { return detection_index; }
+    // Détections qui chevauchent une annotation (indices dans getDetections())
+    std::vector<int> detectionsOverlappingAnnotation(int annotation) const;
+
+    // Annotation et détection sous le curseur (-1 : aucune)
+    int hoveredAnnotation() const { return hovered_annotation; }
+    int hoveredDetection() const { return hovered_detection; }
+
+signals:
+    // Émis quand l'annotation ou la détection sous le curseur change (-1 : aucune)
+    void hoverChanged(int annotation, int detection);
 
     // ADDED: Public slot for undo
 public slots:
     void undoLastRectangle();
     void clearAllRectangles(); // ADDED: To clear all drawn rectangles
+    void fitToWindow(); // Revient à l'image entière ajustée au widget
 
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void leaveEvent(QEvent *event) override;
 
 private:
     cv::Mat original_image_cv;
-    QImage current_image_qt;
     std::vector<cv::Rect> drawn_rectangles;
-    QPoint start_point;
+    std::vector<cv::Rect> detections;
+    SpatialIndex annotation_index;
+    SpatialIndex detection_index;
+    int hovered_annotation;
+    int hovered_detection;
+    QPoint start_point;   // Début du rectangle en cours (coordonnées de l'image originale)
+    QPoint current_point; // Position courante de la souris pendant le dessin (coordonnées du widget)
     bool drawing;
 
+    // Vue : zoom et déplacement. L'image est dessinée par tuiles, lues au niveau de la pyramide adapté au zoom.
+    ImagePyramid pyramid;
+    QCache<quint64, QPixmap> tile_cache; // Tuiles déjà converties (clé : niveau et position), bornées en mémoire
+    double view_scale;   // Pixels affichés par pixel de l'image originale
+    QPointF view_offset; // Position dans le widget du coin supérieur gauche de l'image
+    bool fit_mode;       // Vrai tant que l'utilisateur n'a ni zoomé ni déplacé la vue (suivi du redimensionnement)
+    bool panning;        // Vrai pendant un déplacement de la vue (bouton du milieu ou bouton droit)
+    QPoint pan_last;     // Dernière position de la souris pendant le déplacement
+
+    // Ajuste la vue pour afficher l'image entière, centrée
+    void applyFitView();
+    // Conversions entre coordonnées du widget et de l'image originale (via view_offset et view_scale)
+    QPoint widgetToImage(const QPoint& widget_point) const;
+    QRect imageToWidget(const cv::Rect& image_rect_cv) const;
+    // Remplace les annotations en ne mettant à jour dans l'index que les rectangles ajoutés ou retirés
+    void setDrawnRectangles(const std::vector<cv::Rect>& rectangles);
+    // Recherche l'annotation et la détection sous un point du widget (les plus récentes si plusieurs)
+    void updateHover(const QPoint& widget_point);
+    // Zone de l'image (avec une marge pour l'épaisseur du stylo) qui correspond à une zone du widget
+    cv::Rect widgetToImageArea(const QRect& widget_rect) const;
+    // Retourne la tuile (tx, ty) d'un niveau de la pyramide, convertie au besoin
+    QPixmap tilePixmap(int level, int tx, int ty);
+    // Rectangle en cours de dessin, en coordonnées du widget (limité à l'image affichée)
+    QRect rubberBandRect() const;
+
     // ADDED: Stack to store history of rectangle states for undo
     std::stack<std::vector<cv::Rect>> undo_history;
 
-    // Helper to convert cv::Mat to QImage
-    QImage cvMatToQImage(const cv::Mat &mat);
-
     // ADDED: Helper to save current state to undo history
     void saveStateToUndoHistory();
 };
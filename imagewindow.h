@@ -6,7 +6,15 @@
 #include <opencv2/opencv.hpp>
 #include <QPixmap>
 #include <QList>
+#include <QVector>
+#include <QTimer>
+#include <QThread>
+#include <QString>
+#include <memory>
 #include "composant.h" // Incluez Composant.h pour la classe Composant
+#include "pcbpipeline.h" // Pipeline de détection indépendant de Qt (bibliothèque pcb_core)
+#include "pipelineworker.h" // Exécution du pipeline dans un thread dédié
+#include "componentexporter.h" // Export asynchrone des images de composants (bibliothèque pcb_core)
 
 // Déclaration anticipée de la classe Ui::ImageWindow pour éviter les dépendances circulaires
 namespace Ui {
@@ -15,9 +23,8 @@ class ImageWindow;
 
 /**
  * @brief La classe ImageWindow est une fenêtre utilitaire pour afficher des images
- * brutes, masquées ou traitées. Elle contient également la logique de traitement
- * d'image OpenCV et la détection de composants, et émet des signaux
- * vers MainWindow avec les résultats.
+ * brutes, masquées ou traitées. Elle pilote le pipeline de détection (PcbPipeline)
+ * et émet des signaux vers MainWindow avec les résultats.
  */
 class ImageWindow : public QMainWindow
 {
@@ -36,7 +43,7 @@ public:
     ~ImageWindow();
 
     /**
-     * @brief Définit l'image originale à traiter et lance le pipeline complet.
+     * @brief Définit l'image originale à traiter et planifie le pipeline complet.
      * @param originalImage L'image OpenCV d'entrée.
      */
     void setOriginalImage(const cv::Mat& originalImage);
@@ -69,7 +76,26 @@ public:
     void showPixmap(const QPixmap& pixmap); // Nouvelle méthode pour afficher un QPixmap
 
 
-    // Slots publics pour définir les paramètres du pipeline de traitement (connectés aux sliders de MainWindow)
+    /**
+     * @brief Applique les six paramètres du pipeline en une seule fois.
+     * Un seul traitement est planifié (et aucun si les paramètres n'ont pas changé).
+     * @param params Les nouveaux paramètres du pipeline.
+     */
+    void applyParameters(const PipelineParams& params);
+
+    /**
+     * @brief Retourne les paramètres du pipeline actuellement appliqués.
+     */
+    PipelineParams parameters() const { return m_params; }
+
+    /**
+     * @brief Planifie un traitement différé : toutes les demandes reçues pendant la même trame
+     * (environ 16 ms) sont regroupées en un seul appel à updateImageProcessing().
+     */
+    void scheduleReprocess();
+
+    // Slots publics pour définir les paramètres du pipeline de traitement un par un.
+    // Chaque setter planifie un traitement différé (voir scheduleReprocess()).
     void setBlurKsize(int value);
     void setSigmaX(int value);
     void setClaheClipLimit(int value);
@@ -79,7 +105,9 @@ public:
 
     /**
      * @brief Lance le pipeline complet de traitement d'image et de détection de composants.
-     * Cette fonction est appelée chaque fois qu'un paramètre est modifié ou un traitement est déclenché.
+     * Le traitement s'exécute dans un thread dédié ; les résultats arrivent plus tard via les signaux
+     * `imageProcessed`, `extractedComponentsImageReady` et `componentsDetected`.
+     * Les changements de paramètres passent plutôt par scheduleReprocess().
      */
     void updateImageProcessing();
 
@@ -95,12 +123,26 @@ public:
      */
     cv::Mat getContoursImage() const;
 
+    /**
+     * @brief Exporte les composants du dernier résultat affiché (un fichier par composant).
+     * L'export s'exécute en arrière-plan ; sa fin est signalée par `componentsExported`.
+     * @param options Répertoire, format et niveau de compression.
+     * @return false si aucun résultat n'est encore disponible.
+     */
+    bool exportComponents(const ExportOptions& options);
+
+    /**
+     * @brief Demande l'export des composants du prochain résultat reçu (paramètres définitifs).
+     * @param options Répertoire, format et niveau de compression.
+     */
+    void exportComponentsOnNextResult(const ExportOptions& options);
+
 signals:
     /**
      * @brief Signal émis lorsque la liste des composants détectés est prête.
-     * @param components La liste des objets Composant détectés.
+     * @param components La liste des objets Composant détectés (vignettes générées à la demande).
      */
-    void componentsDetected(const QList<Composant>& components);
+    void componentsDetected(const QVector<Composant>& components);
 
     /**
      * @brief Signal émis lorsque l'image des contours est prête.
@@ -114,42 +156,70 @@ signals:
      */
     void extractedComponentsImageReady(const QPixmap& extractedComponentsPixmap);
 
+    /**
+     * @brief Signal émis (thread GUI) à la fin d'un export de composants.
+     * @param written Nombre de fichiers écrits.
+     * @param failed Nombre de composants non écrits.
+     * @param directory Répertoire de destination.
+     */
+    void componentsExported(int written, int failed, const QString& directory);
+
 private slots:
     /**
      * @brief Slot pour sauvegarder l'image actuellement affichée dans cette fenêtre.
      */
     void saveImage();
 
+    /**
+     * @brief Slot appelé (dans le thread GUI) lorsque le worker a terminé une demande.
+     * Les résultats obsolètes sont ignorés ; sinon ils sont convertis en objets Qt et émis.
+     * @param generation Le numéro de génération de la demande.
+     * @param result Le résultat de la détection.
+     */
+    void onPipelineResult(quint64 generation, const DetectionResult& result);
+
 private:
     Ui::ImageWindow *ui; // Pointeur vers l'UI générée pour cette fenêtre
 
     cv::Mat m_originalImage;        // L'image originale non modifiée
+    ComponentSourcePtr m_componentSource; // Image originale partagée avec les composants émis (nulle sans image)
     cv::Mat m_currentProcessedImage; // L'image résultante du dernier traitement, affichée dans cette fenêtre
     cv::Mat m_preprocessedMaskImage; // Stocke l'image grise du "masque" pour getPreprocessedGray()
     cv::Mat m_processedContoursImage; // Image avec les contours et BBoxes, émise via imageProcessed
     cv::Mat m_extractedComponentsOnBlank; // Image des composants extraits sur fond blanc, émise via extractedComponentsImageReady
 
-    // Membres pour les paramètres du pipeline de traitement des composants
-    int m_blurKsize;
-    int m_sigmaX;
-    int m_claheClipLimit;
-    int m_separationKsize;
-    int m_fillHolesKsize;
-    int m_contourMinArea;
+    PipelineParams m_params; // Paramètres du pipeline de traitement des composants (valeurs des sliders)
+    PipelineParams m_submittedParams; // Paramètres de la dernière demande soumise au worker
+    QThread m_workerThread;   // Thread dédié au pipeline de détection (démarré à la première demande)
+    PipelineWorker *m_worker; // Worker exécutant PcbPipeline dans m_workerThread (nul tant qu'aucun traitement n'a été demandé)
+    QTimer *m_reprocessTimer; // Minuteur mono-coup qui regroupe les demandes de traitement d'une même trame
 
-    // Fonctions de Segmentation (internes au pipeline)
-    void segmentByAdaptiveThresholding(const cv::Mat& img_gray, cv::Mat& thresholded, bool& inverted);
-    void segmentByGlobalThresholding(const cv::Mat& img_gray, cv::Mat& simple_thresholded, cv::Mat& otsu_thresholded, double& otsu_thresh);
+    cv::Mat m_lastResultImage;           // Image source du dernier résultat appliqué (pixels partagés, jamais modifiés)
+    std::vector<cv::Rect> m_lastRects;   // Boîtes englobantes du dernier résultat appliqué
+    std::vector<double> m_lastAreas;     // Aires des contours du dernier résultat appliqué
+    PipelineParams m_lastResultParams;   // Paramètres avec lesquels le dernier résultat appliqué a été obtenu
+    bool m_exportOnNextResult;           // Vrai si le prochain résultat doit être exporté
+    ExportOptions m_nextResultExportOptions; // Options de cet export différé
+    std::unique_ptr<ComponentExporter> m_exporter; // Exporteur (créé au premier export)
 
     /**
-     * @brief Helper pour convertir une cv::Mat en QPixmap.
-     * @param mat La cv::Mat à convertir.
-     * @return La QPixmap résultante.
+     * @brief Crée le worker et démarre son thread au premier traitement demandé.
+     * Les fenêtres utilisées seulement pour afficher une image ne créent ainsi aucun thread.
      */
-    QPixmap cvMatToQPixmap(const cv::Mat& mat);
+    void ensureWorker();
 public:
     cv::Mat getExtractedComponentsOnBlankMat() const;
 
+    /**
+     * @brief Boîtes du dernier résultat appliqué, si elles ont été détectées sur `image` avec `params`.
+     * Évite de relancer la détection sur l'image déjà affichée (comparaison à une carte de référence).
+     * @param image L'image attendue (mêmes pixels que l'image originale de la fenêtre).
+     * @param params Les paramètres attendus.
+     * @param rects Reçoit les boîtes englobantes.
+     * @return false si aucun résultat ne correspond (autre image, autres paramètres ou aucun résultat).
+     */
+    bool lastDetection(const cv::Mat& image, const PipelineParams& params, std::vector<cv::Rect>& rects) const;
+
 };
 
 #endif // IMAGEWINDOW_H
@@ -12,9 +12,21 @@
 #include <QFrame>             // Widget générique pour grouper ou encadrer d'autres widgets
 #include <QAction>          // Actions dans les menus ou barres d'outils
 #include <QKeySequence>     // Pour définir des raccourcis clavier
-#include <QListWidget>       // Widget pour afficher une liste d'éléments
+#include <QListView>         // Vue de la liste des composants (seules les lignes visibles sont dessinées)
 #include <QVBoxLayout>      // Gestionnaire de mise en page vertical
 #include <QSlider>         // Widget slider pour ajuster des valeurs
+#include <QSignalBlocker>  // Déplacer les six sliders sans relancer le pipeline à chaque fois
+#include <QInputDialog>    // Pour choisir le format et le niveau de compression de l'export
+#include <QMenu>           // Menu "Tools" de la barre de menus
+#include <QStatusBar>      // Barre d'état (décomposition du profileur)
+#include <QFileInfo>       // Nom d'une image pour en déduire le motif de la suite
+#include <QDir>
+#include <QRegularExpression> // Numéro à la fin du nom d'une image de suite
+#include "pipelineprofiler.h" // Mesure de la durée des étapes (pipeline et affichage)
+#include "pcbpipeline.h"   // Détection sur la carte de référence et sur l'image courante
+#include "tiledpipeline.h" // Même détection, par tuiles, pour les très grandes images
+#include "boardcomparison.h" // Recalage et comparaison à une carte de référence
+#include "matimage.h"      // Conversion cv::Mat -> QPixmap sans copie intermédiaire
 #include "composant.h"     // Votre classe personnalisée 'Composant' pour représenter les composants détectés
 #include <QDebug>         // Pour les messages de débogage dans la console
 #include <QPushButton> // Required for QPushButton (already there, keep it)
@@ -28,11 +40,21 @@ MainWindow::MainWindow(QWidget *parent)
     , ui(new Ui::MainWindow)       // Initialise l'interface utilisateur générée par Qt Designer
     , maskWindow(nullptr)     // Pointeur vers la fenêtre du masque, initialisé à nul
     , resultWindow(nullptr)      // Pointeur vers la fenêtre des résultats, initialisé à nul
-    , m_componentListWidget(nullptr)    // Pointeur vers le QListWidget des composants, initialisé à nul (à vérifier si utilisé ou si ui->listWidgetComponents est directement utilisé)
     , m_componentCountLabel(nullptr)     // Pointeur vers le QLabel pour le compte des composants, initialisé à nul (à vérifier si utilisé)
     , m_lastExtractedComponentsPixmap(QPixmap())    // Initialise le QPixmap stocké pour les composants extraits
-    , m_lastDetectedComponents(QList<Composant>())     // Initialise la liste stockée des composants détectés
+    , m_lastDetectedComponents(QVector<Composant>())   // Initialise la liste stockée des composants détectés
+    , m_componentModel(new ComponentListModel(this)) // Modèle de la liste des composants (détruit avec la fenêtre)
     , m_displayFullResults(false) // **Flag important** : Initialisé à false. Les résultats complets ne s'affichent pas par défaut.
+    , m_profilerLabel(nullptr)    // Créé ci-dessous dans la barre d'état
+    , m_profilerRefreshTimer(new QTimer(this)) // Démarré seulement quand le profileur est actif
+    , m_connectedComponentsAction(nullptr) // Créée ci-dessous avec le menu Tools
+    , m_streamTimer(new QTimer(this)) // Démarré seulement pendant un flux
+    , m_streamLabel(nullptr)      // Créé ci-dessous dans la barre d'état
+    , m_tuningGeneration(0)
+    , m_tuningRunning(false)
+    , m_cancelTuningAction(nullptr) // Créée ci-dessous avec le menu Tools
+    , m_compareGeneration(0)
+    , m_compareRunning(false)
 {
     ui->setupUi(this);    // Configure l'interface utilisateur à partir du fichier .ui
     ui->centralwidget->setToolTip("");
@@ -53,6 +75,77 @@ MainWindow::MainWindow(QWidget *parent)
     connect(SelectedImageAction, &QAction::triggered, this, &MainWindow::loadImageFromFile);
     this->addAction(SelectedImageAction); // Ajoute l'action à la fenêtre principale
 
+    // Action d'export des composants détectés (Ctrl+E) : choix du répertoire, du format et du niveau
+    QAction *exportAction = new QAction(tr("Export components..."), this);
+    exportAction->setShortcut(QKeySequence("Ctrl+E"));
+    connect(exportAction, &QAction::triggered, this, &MainWindow::onExportComponents);
+    this->addAction(exportAction);
+
+    // Profileur du pipeline (Ctrl+Shift+P) : durée de chaque étape dans la barre d'état, percentiles en JSON.
+    // Désactivé par défaut ; il ne coûte alors qu'une lecture atomique par étape.
+    QAction *profilerAction = new QAction(tr("Pipeline profiler"), this);
+    profilerAction->setCheckable(true);
+    profilerAction->setShortcut(QKeySequence("Ctrl+Shift+P"));
+    connect(profilerAction, &QAction::toggled, this, &MainWindow::onProfilerToggled);
+    this->addAction(profilerAction);
+    QAction *saveProfileAction = new QAction(tr("Save profiler statistics..."), this);
+    connect(saveProfileAction, &QAction::triggered, this, &MainWindow::onSaveProfilerStatistics);
+
+    // Méthode d'extraction des composants : contours (par défaut) ou composantes connexes, plus rapide sur
+    // les cartes denses. Changer de méthode relance le pipeline ; seule la dernière étape est recalculée.
+    m_connectedComponentsAction = new QAction(tr("Connected-components extractor"), this);
+    m_connectedComponentsAction->setCheckable(true);
+    m_connectedComponentsAction->setToolTip(tr("Extract components by connected-component labeling instead of contours"));
+    connect(m_connectedComponentsAction, &QAction::toggled, this, &MainWindow::updateComponentsView);
+
+    // Flux de trames (vidéo, suite d'images, caméra) : décodage, prétraitement, segmentation et rendu tournent
+    // en parallèle sur des trames successives ; la fenêtre affiche la dernière trame rendue. Les sliders
+    // s'appliquent aux trames suivantes.
+    QAction *openVideoAction = new QAction(tr("Open video stream..."), this);
+    connect(openVideoAction, &QAction::triggered, this, &MainWindow::onOpenVideoStream);
+    QAction *openCameraAction = new QAction(tr("Open camera..."), this);
+    connect(openCameraAction, &QAction::triggered, this, &MainWindow::onOpenCamera);
+    QAction *stopStreamAction = new QAction(tr("Stop stream"), this);
+    connect(stopStreamAction, &QAction::triggered, this, &MainWindow::onStopStream);
+
+    // Comparaison à une carte de référence : composants manquants, en trop ou décalés sur l'image courante
+    QAction *compareAction = new QAction(tr("Compare with golden board..."), this);
+    connect(compareAction, &QAction::triggered, this, &MainWindow::onCompareWithGoldenBoard);
+
+    // Réglage automatique lancé depuis la fenêtre de dessin : il peut être interrompu d'ici
+    m_cancelTuningAction = new QAction(tr("Cancel parameter tuning"), this);
+    m_cancelTuningAction->setEnabled(false);
+    connect(m_cancelTuningAction, &QAction::triggered, this, &MainWindow::onCancelTuning);
+
+    if (ui->menubar) {
+        QMenu *toolsMenu = ui->menubar->addMenu(tr("&Tools"));
+        toolsMenu->addAction(exportAction);
+        toolsMenu->addSeparator();
+        toolsMenu->addAction(profilerAction);
+        toolsMenu->addAction(saveProfileAction);
+        toolsMenu->addSeparator();
+        toolsMenu->addAction(m_connectedComponentsAction);
+        toolsMenu->addSeparator();
+        toolsMenu->addAction(openVideoAction);
+        toolsMenu->addAction(openCameraAction);
+        toolsMenu->addAction(stopStreamAction);
+        toolsMenu->addSeparator();
+        toolsMenu->addAction(compareAction);
+        toolsMenu->addAction(m_cancelTuningAction);
+    }
+    if (ui->statusbar) {
+        m_profilerLabel = new QLabel(this);
+        ui->statusbar->addPermanentWidget(m_profilerLabel);
+        m_profilerLabel->hide();
+        m_streamLabel = new QLabel(this);
+        ui->statusbar->addPermanentWidget(m_streamLabel);
+        m_streamLabel->hide();
+    }
+    m_profilerRefreshTimer->setInterval(250);
+    connect(m_profilerRefreshTimer, &QTimer::timeout, this, &MainWindow::refreshProfilerStatus);
+    m_streamTimer->setInterval(33);
+    connect(m_streamTimer, &QTimer::timeout, this, &MainWindow::onStreamTick);
+
     // Configuration des textes de remplacement initiaux pour les QLabel d'images
     QLabel *originalImageDisplayLabel = ui->labelImage->findChild<QLabel*>("labelImage_2");
     if (originalImageDisplayLabel) {
@@ -78,13 +171,18 @@ MainWindow::MainWindow(QWidget *parent)
         ui->labelResult_2->setAlignment(Qt::AlignCenter);
     }
 
-    // Configuration du QListWidget pour les composants
-    if (ui->listWidgetComponents) {
-        ui->listWidgetComponents->setAlternatingRowColors(true); // Active les couleurs alternées pour une meilleure lisibilité
-        ui->listWidgetComponents->setViewMode(QListView::ListMode); // Affiche les éléments en liste
-        ui->listWidgetComponents->setMovement(QListView::Static); // Les éléments ne peuvent pas être déplacés par l'utilisateur
-        ui->listWidgetComponents->setResizeMode(QListView::Adjust); // Le redimensionnement ajuste la taille des éléments
-        ui->listWidgetComponents->setFlow(QListView::TopToBottom); // Les éléments s'affichent de haut en bas
+    // Configuration de la vue de la liste des composants
+    if (ui->listViewComponents) {
+        ui->listViewComponents->setAlternatingRowColors(true); // Active les couleurs alternées pour une meilleure lisibilité
+        ui->listViewComponents->setViewMode(QListView::ListMode); // Affiche les éléments en liste
+        ui->listViewComponents->setMovement(QListView::Static); // Les éléments ne peuvent pas être déplacés par l'utilisateur
+        ui->listViewComponents->setResizeMode(QListView::Adjust); // Le redimensionnement ajuste la taille des éléments
+        ui->listViewComponents->setFlow(QListView::TopToBottom); // Les éléments s'affichent de haut en bas
+        ui->listViewComponents->setIconSize(QSize(48, 48)); // Taille des vignettes
+        // Lignes de hauteur identique : la vue calcule sa mise en page sans interroger chaque ligne (10 000+ composants)
+        ui->listViewComponents->setUniformItemSizes(true);
+        ui->listViewComponents->setModel(m_componentModel);
+        m_componentModel->setIconSize(ui->listViewComponents->iconSize());
     }
 
     // Configuration du bouton de sélection d'image
@@ -222,12 +320,11 @@ MainWindow::MainWindow(QWidget *parent)
 
         cv::Mat gray = maskWindow->getPreprocessedGray(); // Obtient l'image pré-traitée en niveaux de gris
         if (!gray.empty()) {
-            QImage imgGray(gray.data, gray.cols, gray.rows, gray.step, QImage::Format_Grayscale8); // Convertit cv::Mat en QImage
             QLabel *maskDisplayLabel = ui->labelImage_Mask->findChild<QLabel*>("labelImage_Mask_2");
             if (maskDisplayLabel) {
-                maskDisplayLabel->setPixmap(QPixmap::fromImage(imgGray).scaled(maskDisplayLabel->size(),
-                                                                               Qt::KeepAspectRatio,
-                                                                               Qt::SmoothTransformation)); // Affiche l'image
+                maskDisplayLabel->setPixmap(matToQPixmap(gray).scaled(maskDisplayLabel->size(),
+                                                                      Qt::KeepAspectRatio,
+                                                                      Qt::SmoothTransformation)); // Affiche l'image
             }
             afficherMessage(this, "Preprocessed image displayed!", "Info", QMessageBox::Information, 1000);
         } else {
@@ -248,22 +345,19 @@ MainWindow::MainWindow(QWidget *parent)
         connect(resultWindow, &ImageWindow::componentsDetected, this, &MainWindow::displayDetectedComponentsInList);
         connect(resultWindow, &ImageWindow::imageProcessed, this, &MainWindow::displayContoursImage);
         connect(resultWindow, &ImageWindow::extractedComponentsImageReady, this, &MainWindow::displayExtractedComponentsImage);
+        connect(resultWindow, &ImageWindow::componentsExported, this, &MainWindow::onComponentsExported);
 
         // Réinitialise le flag d'affichage complet.
         // Cela signifie que même si les calculs sont faits, l'image finale des composants
         // et la liste ne seront PAS affichées tant que `TraitementButton_2` n'est pas cliqué.
         m_displayFullResults = false;
 
-        // Définit les paramètres de traitement dans `resultWindow` à partir des valeurs des sliders
-        if (ui->sliderBlurKsize) resultWindow->setBlurKsize(ui->sliderBlurKsize->value());
-        if (ui->sliderSigmaX) resultWindow->setSigmaX(ui->sliderSigmaX->value());
-        if (ui->sliderClaheClipLimit) resultWindow->setClaheClipLimit(ui->sliderClaheClipLimit->value());
-        if (ui->sliderSeparationKsize) resultWindow->setSeparationKsize(ui->sliderSeparationKsize->value());
-        if (ui->sliderFillHolesKsize) resultWindow->setFillHolesKsize(ui->sliderFillHolesKsize->value());
-        if (ui->sliderContourMinArea) resultWindow->setContourMinArea(ui->sliderContourMinArea->value());
+        // Définit les paramètres de traitement dans `resultWindow` à partir des valeurs des sliders (en un seul lot)
+        resultWindow->applyParameters(currentPipelineParams());
 
         resultWindow->setOriginalImage(image); // Lance le traitement dans ImageWindow
-        // (Cela déclenchera `updateImageProcessing()` dans `ImageWindow` et enverra les signaux `imageProcessed`, `componentsDetected`, `extractedComponentsImageReady`).
+        // (Paramètres et image sont regroupés en un seul `updateImageProcessing()`, qui enverra les signaux
+        // `imageProcessed`, `componentsDetected`, `extractedComponentsImageReady`).
 
         afficherMessage(this, "Full processing started. Displaying outlines.", "Info", QMessageBox::Information, 1000);
     });
@@ -280,6 +374,11 @@ MainWindow::MainWindow(QWidget *parent)
 // Destructeur de la classe MainWindow
 // Libère la mémoire allouée dynamiquement.
 MainWindow::~MainWindow() {
+    m_stream.reset(); // Arrête et rejoint les threads du flux avant de détruire la fenêtre
+    ++m_tuningGeneration; // Annule le réglage en cours : il s'arrête à la fin de ses tâches en cours
+    if (m_tuningThread.joinable()) m_tuningThread.join();
+    ++m_compareGeneration; // Annule la comparaison en cours : elle s'arrête entre deux tuiles ou deux étapes
+    if (m_compareThread.joinable()) m_compareThread.join();
     delete ui; // Supprime l'objet UI
     if (maskWindow) delete maskWindow; // Supprime la fenêtre du masque si elle existe
     if (resultWindow) delete resultWindow; // Supprime la fenêtre des résultats si elle existe
@@ -296,15 +395,13 @@ void MainWindow::loadImageFromFile() {
 
         image = cv::imread(fileName.toStdString()); // Charge l'image avec OpenCV
         if (!image.empty()) { // Si l'image a été chargée avec succès
-            // Convertit l'image OpenCV (BGR888) en QImage
-            QImage imgQ(image.data, image.cols, image.rows, image.step, QImage::Format_BGR888);
-
+            m_imagePath = fileName;
             QLabel *originalImageDisplayLabel = ui->labelImage->findChild<QLabel*>("labelImage_2");
             if (originalImageDisplayLabel) {
                 // Affiche l'image originale dans le QLabel approprié, redimensionnée pour s'adapter.
-                originalImageDisplayLabel->setPixmap(QPixmap::fromImage(imgQ).scaled(originalImageDisplayLabel->size(),
-                                                                                     Qt::KeepAspectRatio,
-                                                                                     Qt::SmoothTransformation));
+                originalImageDisplayLabel->setPixmap(matToQPixmap(image).scaled(originalImageDisplayLabel->size(),
+                                                                                Qt::KeepAspectRatio,
+                                                                                Qt::SmoothTransformation));
             }
             afficherMessage(this, "Image loaded successfully!", "Info", QMessageBox::Information, 2000);
         } else {
@@ -318,6 +415,64 @@ void MainWindow::loadImageFromFile() {
     }
 }
 
+/**
+ * @brief Retourne les boîtes englobantes de la dernière liste de composants détectés.
+ * @return Une boîte par composant, dans l'ordre de la liste.
+ */
+std::vector<cv::Rect> MainWindow::lastDetectionRects() const {
+    std::vector<cv::Rect> rects;
+    rects.reserve(m_lastDetectedComponents.size());
+    for (const Composant& comp : m_lastDetectedComponents) {
+        rects.push_back(comp.getBoundingBox());
+    }
+    return rects;
+}
+
+/**
+ * @brief Lit les valeurs actuelles des six sliders de paramètres et la méthode d'extraction (menu Tools).
+ * Un slider absent de l'UI conserve la valeur par défaut de PipelineParams.
+ * @return Les paramètres du pipeline correspondant à l'état des sliders.
+ */
+PipelineParams MainWindow::currentPipelineParams() const {
+    PipelineParams params;
+    if (ui->sliderBlurKsize) params.blurKsize = ui->sliderBlurKsize->value();
+    if (ui->sliderSigmaX) params.sigmaX = ui->sliderSigmaX->value();
+    if (ui->sliderClaheClipLimit) params.claheClipLimit = ui->sliderClaheClipLimit->value();
+    if (ui->sliderSeparationKsize) params.separationKsize = ui->sliderSeparationKsize->value();
+    if (ui->sliderFillHolesKsize) params.fillHolesKsize = ui->sliderFillHolesKsize->value();
+    if (ui->sliderContourMinArea) params.contourMinArea = ui->sliderContourMinArea->value();
+    if (m_connectedComponentsAction && m_connectedComponentsAction->isChecked()) {
+        params.extractor = ComponentExtractor::ConnectedComponents;
+    }
+    return params;
+}
+
+/**
+ * @brief Place les six sliders et la méthode d'extraction sur `params`, puis relance le pipeline une seule fois.
+ */
+void MainWindow::setPipelineParams(const PipelineParams& params) {
+    const std::pair<QSlider*, int> sliders[] = {
+        { ui->sliderBlurKsize, params.blurKsize }, { ui->sliderSigmaX, params.sigmaX },
+        { ui->sliderClaheClipLimit, params.claheClipLimit }, { ui->sliderSeparationKsize, params.separationKsize },
+        { ui->sliderFillHolesKsize, params.fillHolesKsize }, { ui->sliderContourMinArea, params.contourMinArea } };
+    for (const auto& slider : sliders) {
+        if (!slider.first) continue;
+        QSignalBlocker blocker(slider.first); // Un seul passage du pipeline pour les six changements (voir plus bas)
+        slider.first->setValue(slider.second);
+    }
+    if (m_connectedComponentsAction) {
+        QSignalBlocker blocker(m_connectedComponentsAction);
+        m_connectedComponentsAction->setChecked(params.extractor == ComponentExtractor::ConnectedComponents);
+    }
+    if (ui->sliderBlurKsize) updateSliderValue1(ui->sliderBlurKsize->value());
+    if (ui->sliderSigmaX) updateSliderValue2(ui->sliderSigmaX->value());
+    if (ui->sliderClaheClipLimit) updateSliderValue3(ui->sliderClaheClipLimit->value());
+    if (ui->sliderSeparationKsize) updateSliderValue4(ui->sliderSeparationKsize->value());
+    if (ui->sliderFillHolesKsize) updateSliderValue5(ui->sliderFillHolesKsize->value());
+    if (ui->sliderContourMinArea) updateSliderValue6(ui->sliderContourMinArea->value());
+    updateComponentsView();
+}
+
 // Slots pour mettre à jour les valeurs affichées à côté de chaque slider.
 // Simplement met à jour le texte d'un QLabel avec la valeur du slider.
 void MainWindow::updateSliderValue1(int value) { if (ui->value) ui->value->setText(QString::number(value)); }
@@ -334,6 +489,9 @@ void MainWindow::updateSliderValue6(int value) { if (ui->value_6) ui->value_6->s
  */
 void MainWindow::updateComponentsView() {
     qDebug() << "updateComponentsView appelé (par slider).";
+    if (m_stream) {
+        m_stream->setParams(currentPipelineParams()); // Pris en compte dès la prochaine trame décodée
+    }
     if (!resultWindow || image.empty()) { // Vérifie si `resultWindow` est initialisé et si une image est chargée
         qDebug() << "resultWindow uninitialized or empty image. Do not process.";
         return; // N'effectue pas le traitement si les prérequis ne sont pas remplis
@@ -344,18 +502,11 @@ void MainWindow::updateComponentsView() {
     // Cependant, le traitement sous-jacent est toujours effectué pour mettre à jour les données
     // (pixmap et liste de composants) en arrière-plan, afin qu'elles soient prêtes lorsque l'utilisateur clique.
 
-    // Définit les paramètres de traitement dans `resultWindow` avec les valeurs actuelles des sliders.
-    if (ui->sliderBlurKsize) resultWindow->setBlurKsize(ui->sliderBlurKsize->value());
-    if (ui->sliderSigmaX) resultWindow->setSigmaX(ui->sliderSigmaX->value());
-    if (ui->sliderClaheClipLimit) resultWindow->setClaheClipLimit(ui->sliderClaheClipLimit->value());
-    if (ui->sliderSeparationKsize) resultWindow->setSeparationKsize(ui->sliderSeparationKsize->value());
-    if (ui->sliderFillHolesKsize) resultWindow->setFillHolesKsize(ui->sliderFillHolesKsize->value());
-    if (ui->sliderContourMinArea) resultWindow->setContourMinArea(ui->sliderContourMinArea->value());
-
-    // Déclenche le traitement de l'image dans l'objet `resultWindow`.
-    // Cela entraînera l'émission des signaux `componentsDetected` et `extractedComponentsImageReady`
+    // Applique les valeurs actuelles des sliders à `resultWindow` en un seul lot.
+    // `ImageWindow` regroupe les demandes : pendant un glissement de slider, le pipeline tourne au plus
+    // une fois par trame, puis émet les signaux `componentsDetected` et `extractedComponentsImageReady`
     // (qui sont connectés aux slots `displayDetectedComponentsInList` et `displayExtractedComponentsImage`).
-    resultWindow->updateImageProcessing();
+    resultWindow->applyParameters(currentPipelineParams());
 
     // Conditionnel : Affiche un message d'information si les résultats sont déjà visibles.
     // Cela évite d'afficher un message à chaque déplacement de slider si l'utilisateur n'a pas encore demandé l'affichage des résultats finaux.
@@ -370,6 +521,7 @@ void MainWindow::updateComponentsView() {
  * @param resultPixmap Le QPixmap de l'image traitée avec les contours.
  */
 void MainWindow::displayContoursImage(const QPixmap& resultPixmap) {
+    ScopedStageTimer timer("MainWindow::displayContoursImage");
     QLabel *contoursDisplayLabel = ui->labelImage_contours->findChild<QLabel*>("labelImage_contours_2");
     if (contoursDisplayLabel) {
         // Redimensionne et affiche le pixmap dans le QLabel.
@@ -387,6 +539,7 @@ void MainWindow::displayContoursImage(const QPixmap& resultPixmap) {
  * @param extractedComponentsPixmap Le QPixmap de l'image des composants extraits.
  */
 void MainWindow::displayExtractedComponentsImage(const QPixmap& extractedComponentsPixmap) {
+    ScopedStageTimer timer("MainWindow::displayExtractedComponentsImage");
     m_lastExtractedComponentsPixmap = extractedComponentsPixmap; // Stocke toujours le pixmap, qu'il soit affiché ou non
 
     if (m_displayFullResults) { // Affichage conditionnel basé sur le flag
@@ -412,35 +565,26 @@ void MainWindow::displayExtractedComponentsImage(const QPixmap& extractedCompone
 }
 
 /**
- * @brief Slot pour afficher la liste des composants détectés dans le QListWidget.
+ * @brief Slot pour afficher la liste des composants détectés dans la vue de la liste.
  * Ce slot est connecté au signal `componentsDetected` de `ImageWindow`.
  * Il stocke toujours la liste, mais ne l'affiche que si `m_displayFullResults` est vrai.
- * @param components La QList de `Composant` détectés.
+ * @param components La liste des `Composant` détectés.
  */
-void MainWindow::displayDetectedComponentsInList(const QList<Composant>& components) {
+void MainWindow::displayDetectedComponentsInList(const QVector<Composant>& components) {
+    ScopedStageTimer timer("MainWindow::displayDetectedComponentsInList");
     m_lastDetectedComponents = components; // Stocke toujours la liste des composants, qu'elle soit affichée ou non
+    if (m_drawingWindow) {
+        m_drawingWindow->setDetections(lastDetectionRects()); // Met à jour l'index des détections de la fenêtre de dessin
+    }
 
     if (m_displayFullResults) { // Affichage conditionnel basé sur le flag
         qDebug() << "displayDetectedComponentsInList: m_displayFullResults est TRUE. Affichage de la liste et du compteur.";
-        if (ui->listWidgetComponents) {
-            ui->listWidgetComponents->clear(); // Efface les éléments précédents de la liste
-
-            // Ajoute chaque composant à la liste
-            for (const Composant& comp : components) {
-                QListWidgetItem* item = new QListWidgetItem();
-                item->setText(comp.getDetails()); // Définit le texte de l'élément (détails du composant)
-                item->setIcon(QIcon(comp.getImage())); // Définit l'icône de l'élément (image du composant)
-                ui->listWidgetComponents->addItem(item); // Ajoute l'élément à la liste
-            }
-        } else {
-            qWarning() << "QListWidget 'listWidgetComponents' non initialized in MainWindow.";
-        }
+        // Seuls les changements par rapport au résultat affiché sont appliqués à la vue
+        m_componentModel->setComponents(components);
     } else {
         qDebug() << "displayDetectedComponentsInList: m_displayFullResults is FALSE. Clearing list and counter.";
         // Si l'affichage complet n'est pas actif, vide la liste.
-        if (ui->listWidgetComponents) {
-            ui->listWidgetComponents->clear();
-        }
+        m_componentModel->clear();
     }
 }
 
@@ -470,6 +614,7 @@ void MainWindow::showExtractedComponentsImageAndList() {
             connect(resultWindow, &ImageWindow::componentsDetected, this, &MainWindow::displayDetectedComponentsInList);
             connect(resultWindow, &ImageWindow::imageProcessed, this, &MainWindow::displayContoursImage);
             connect(resultWindow, &ImageWindow::extractedComponentsImageReady, this, &MainWindow::displayExtractedComponentsImage);
+            connect(resultWindow, &ImageWindow::componentsExported, this, &MainWindow::onComponentsExported);
         }
         if (image.empty()) {
             QMessageBox::information(this, "Info", "Please load an image first before displaying components.");
@@ -479,12 +624,7 @@ void MainWindow::showExtractedComponentsImageAndList() {
         }
 
         // Applique les paramètres actuels des sliders à `resultWindow` avant de lancer le traitement.
-        if (ui->sliderBlurKsize) resultWindow->setBlurKsize(ui->sliderBlurKsize->value());
-        if (ui->sliderSigmaX) resultWindow->setSigmaX(ui->sliderSigmaX->value());
-        if (ui->sliderClaheClipLimit) resultWindow->setClaheClipLimit(ui->sliderClaheClipLimit->value());
-        if (ui->sliderSeparationKsize) resultWindow->setSeparationKsize(ui->sliderSeparationKsize->value());
-        if (ui->sliderFillHolesKsize) resultWindow->setFillHolesKsize(ui->sliderFillHolesKsize->value());
-        if (ui->sliderContourMinArea) resultWindow->setContourMinArea(ui->sliderContourMinArea->value());
+        resultWindow->applyParameters(currentPipelineParams());
 
         resultWindow->setOriginalImage(image); // Lance le traitement (ce qui déclenchera les signaux connectés)
     } else {
@@ -492,9 +632,13 @@ void MainWindow::showExtractedComponentsImageAndList() {
         // il suffit de déclencher une mise à jour du traitement.
         // Cela forcera `ImageWindow` à recalculer et à émettre à nouveau ses signaux,
         // ce qui mettra à jour les affichages puisque `m_displayFullResults` est maintenant vrai.
-        resultWindow->updateImageProcessing();
+        resultWindow->scheduleReprocess();
     }
 
+    // Les paramètres sont considérés comme définitifs : les composants du résultat à venir sont exportés
+    // (en arrière-plan, avec les options du dernier export explicite).
+    resultWindow->exportComponentsOnNextResult(m_exportOptions);
+
     afficherMessage(this,"Display of extracted components and list updated!", "Info", QMessageBox::Information, 1000);
 }
 
@@ -511,6 +655,10 @@ void MainWindow::onOpenDrawingWindow() {
     // Crée une nouvelle instance de DrawingWindow
     DrawingWindow *drawingWindow = new DrawingWindow(this); // Set 'this' as parent for proper memory management
     drawingWindow->setOriginalImage(image); // Passe l'image originale chargée dans MainWindow à la nouvelle fenêtre
+    drawingWindow->setImagePath(m_imagePath); // Emplacement proposé pour ses annotations (<image>_annotations.csv)
+    drawingWindow->setDetections(lastDetectionRects()); // Et les composants déjà détectés (survol, croisement avec les annotations)
+    m_drawingWindow = drawingWindow; // Les résultats suivants lui seront transmis (voir displayDetectedComponentsInList)
+    connect(drawingWindow, &DrawingWindow::tuneRequested, this, &MainWindow::onTuneRequested);
     drawingWindow->show(); // Affiche la nouvelle fenêtre
 
     // IMPORTANT: Make sure the new window is deleted when closed to prevent memory leaks.
@@ -519,6 +667,464 @@ void MainWindow::onOpenDrawingWindow() {
 }
 
 
+/**
+ * @brief Slot de l'action "Export components..." (Ctrl+E).
+ * Demande le répertoire, le format et le niveau de compression, puis lance l'export des composants
+ * du dernier résultat. L'export est asynchrone : la fin est signalée par onComponentsExported().
+ */
+void MainWindow::onExportComponents() {
+    if (!resultWindow) {
+        QMessageBox::information(this, "Info", "Please click 'Show Edges' first.");
+        return;
+    }
+
+    QString directory = QFileDialog::getExistingDirectory(this, "Export components to",
+                                                          QString::fromStdString(m_exportOptions.directory));
+    if (directory.isEmpty()) {
+        return; // Annulé par l'utilisateur
+    }
+
+    const QStringList formats = { "PNG", "JPEG", "WebP", "Raw pixels (archive only)" };
+    bool ok = false;
+    QString format = QInputDialog::getItem(this, "Export components", "Format:", formats,
+                                           static_cast<int>(m_exportOptions.codec), false, &ok);
+    if (!ok) {
+        return;
+    }
+    ExportOptions options;
+    options.directory = directory.toStdString();
+    options.codec = static_cast<ExportCodec>(formats.indexOf(format));
+
+    // Destination : un fichier par composant ou une archive unique (données + index), toujours utilisée en Raw
+    if (options.codec == ExportCodec::Raw) {
+        options.archive = true;
+    } else {
+        const QStringList destinations = { "One file per component", "Single indexed archive" };
+        QString destination = QInputDialog::getItem(this, "Export components", "Destination:", destinations,
+                                                    m_exportOptions.archive ? 1 : 0, false, &ok);
+        if (!ok) {
+            return;
+        }
+        options.archive = (destination == destinations.at(1));
+    }
+
+    // Le niveau n'a pas le même sens selon le format : compression pour PNG, qualité pour JPEG/WebP
+    int level = 0;
+    if (options.codec == ExportCodec::Raw) {
+        // Pas de niveau : les pixels sont copiés tels quels
+    } else if (options.codec == ExportCodec::Png) {
+        int current = (m_exportOptions.codec == ExportCodec::Png) ? m_exportOptions.level : 3;
+        level = QInputDialog::getInt(this, "Export components", "PNG compression level (0 = fastest, 9 = smallest):",
+                                     current, 0, 9, 1, &ok);
+    } else {
+        int current = (m_exportOptions.codec == options.codec) ? m_exportOptions.level : 90;
+        level = QInputDialog::getInt(this, "Export components", "Quality (1 = smallest, 100 = best):",
+                                     current, 1, 100, 1, &ok);
+    }
+    if (!ok) {
+        return;
+    }
+    options.level = level;
+    m_exportOptions = options; // Réutilisé pour les exports automatiques suivants
+
+    if (resultWindow->exportComponents(options)) {
+        afficherMessage(this, "Exporting components...", "Info", QMessageBox::Information, 700);
+    } else {
+        QMessageBox::information(this, "Info", "No results to export yet.");
+    }
+}
+
+/**
+ * @brief Slot appelé à la fin d'un export de composants.
+ * @param written Nombre de fichiers écrits.
+ * @param failed Nombre de composants non écrits.
+ * @param directory Répertoire de destination.
+ */
+void MainWindow::onComponentsExported(int written, int failed, const QString& directory) {
+    if (failed > 0) {
+        QMessageBox::warning(this, "Export", QString("%1 components exported to %2, %3 failed.")
+                                                 .arg(written).arg(directory).arg(failed));
+    } else {
+        afficherMessage(this, QString("%1 components exported to %2").arg(written).arg(directory),
+                        "Info", QMessageBox::Information, 1500);
+    }
+}
+
+/**
+ * @brief Active ou désactive le profileur. Actif, la barre d'état affiche la durée de chaque étape
+ * du dernier passage (les étapes servies par le cache n'apparaissent pas).
+ * @param enabled Nouvel état du profileur.
+ */
+void MainWindow::onProfilerToggled(bool enabled) {
+    PipelineProfiler::instance().setEnabled(enabled);
+    if (enabled) {
+        m_profilerRefreshTimer->start();
+        refreshProfilerStatus();
+    } else {
+        m_profilerRefreshTimer->stop();
+        if (m_profilerLabel) m_profilerLabel->hide();
+    }
+}
+
+/**
+ * @brief Met à jour la barre d'état avec la décomposition du dernier passage.
+ */
+void MainWindow::refreshProfilerStatus() {
+    if (!m_profilerLabel) {
+        return;
+    }
+    const std::vector<StageSample> lastRun = PipelineProfiler::instance().lastRun();
+    QStringList parts;
+    for (const StageSample& sample : lastRun) {
+        parts << QString("%1 %2 ms").arg(QString::fromStdString(sample.stage)).arg(sample.ms, 0, 'f', 1);
+    }
+    m_profilerLabel->setText(parts.isEmpty() ? QString("Profiler: waiting for a run...") : parts.join(" | "));
+    m_profilerLabel->show();
+}
+
+/**
+ * @brief Écrit les statistiques glissantes du profileur (p50/p95/p99 par étape) dans un fichier JSON.
+ */
+void MainWindow::onSaveProfilerStatistics() {
+    if (!PipelineProfiler::instance().isEnabled()) {
+        QMessageBox::information(this, "Info", "Enable the pipeline profiler first (Ctrl+Shift+P).");
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(this, "Save profiler statistics", "pipeline_profile.json",
+                                                    "JSON (*.json)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    std::string error;
+    if (PipelineProfiler::instance().writeJson(fileName.toStdString(), &error)) {
+        afficherMessage(this, "Profiler statistics saved.", "Info", QMessageBox::Information, 1000);
+    } else {
+        QMessageBox::warning(this, "Error", QString::fromStdString(error));
+    }
+}
+
+/**
+ * @brief Slot de l'action "Open video stream..." : fichier vidéo, ou première image d'une suite numérotée.
+ * Pour une suite, la première image choisie (par exemple board_0001.png) est transformée en motif
+ * (board_%04d.png) : cv::VideoCapture lit alors toutes les images suivantes.
+ */
+void MainWindow::onOpenVideoStream() {
+    QString fileName = QFileDialog::getOpenFileName(this, "Choose a video or the first image of a sequence", "",
+                                                    "Videos and image sequences (*.mp4 *.avi *.mkv *.mov *.png *.jpg *.bmp *.tif)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QFileInfo info(fileName);
+    const QString suffix = info.suffix().toLower();
+    const bool isImage = suffix == "png" || suffix == "jpg" || suffix == "bmp" || suffix == "tif";
+    QRegularExpressionMatch number = QRegularExpression("(\\d+)$").match(info.completeBaseName());
+    if (isImage && number.hasMatch()) {
+        const QString base = info.completeBaseName().left(number.capturedStart(1));
+        fileName = info.dir().filePath(QString("%1%%2d.%3").arg(base, QString("0%1").arg(number.capturedLength(1)),
+                                                               info.suffix()));
+    }
+    startStream(fileName.toStdString());
+}
+
+/**
+ * @brief Slot de l'action "Open camera..." : demande le numéro de la caméra.
+ */
+void MainWindow::onOpenCamera() {
+    bool ok = false;
+    int index = QInputDialog::getInt(this, "Open camera", "Camera index:", 0, 0, 16, 1, &ok);
+    if (ok) {
+        startStream(std::to_string(index));
+    }
+}
+
+void MainWindow::startStream(const std::string& source) {
+    onStopStream();
+    std::unique_ptr<FrameStream> stream(new FrameStream());
+    std::string error;
+    if (!stream->open(source, &error)) {
+        QMessageBox::warning(this, "Error", QString::fromStdString(error));
+        return;
+    }
+    stream->start(currentPipelineParams());
+    m_stream = std::move(stream);
+    m_streamTimer->start();
+    if (m_streamLabel) {
+        m_streamLabel->setText("Stream: starting...");
+        m_streamLabel->show();
+    }
+}
+
+/**
+ * @brief Slot de l'action "Stop stream" : arrête le flux. La dernière trame affichée reste l'image courante,
+ * sur laquelle les autres outils (traitement complet, dessin) peuvent travailler.
+ */
+void MainWindow::onStopStream() {
+    m_streamTimer->stop();
+    m_stream.reset();
+    if (m_streamLabel) m_streamLabel->hide();
+}
+
+/**
+ * @brief Affiche la trame rendue la plus récente et l'état du flux (débit, latence, files, trames jetées).
+ * Les trames rendues depuis le dernier appel sont toutes retirées, seule la plus récente est affichée :
+ * si l'affichage prend du retard, il saute des trames plutôt que de s'éloigner du direct.
+ */
+void MainWindow::onStreamTick() {
+    if (!m_stream) {
+        return;
+    }
+    StreamFrame frame;
+    bool received = false;
+    while (m_stream->next(frame)) {
+        received = true;
+    }
+    if (received) {
+        image = frame.image; // Image courante : "Show edges", la fenêtre de dessin, etc. travaillent sur cette trame
+        m_imagePath.clear(); // Trame d'un flux : pas de fichier à côté duquel enregistrer les annotations
+        QLabel *originalImageDisplayLabel = ui->labelImage->findChild<QLabel*>("labelImage_2");
+        if (originalImageDisplayLabel) {
+            originalImageDisplayLabel->setPixmap(matToQPixmap(frame.image).scaled(originalImageDisplayLabel->size(),
+                                                                                  Qt::KeepAspectRatio,
+                                                                                  Qt::FastTransformation));
+        }
+        QLabel *contoursDisplayLabel = ui->labelImage_contours->findChild<QLabel*>("labelImage_contours_2");
+        if (contoursDisplayLabel) {
+            contoursDisplayLabel->setPixmap(matToQPixmap(frame.result.contoursImage).scaled(contoursDisplayLabel->size(),
+                                                                                            Qt::KeepAspectRatio,
+                                                                                            Qt::FastTransformation));
+        }
+    }
+
+    const StreamStats stats = m_stream->stats();
+    if (m_streamLabel) {
+        QStringList queues;
+        for (const StreamStageStats& stage : stats.stages) {
+            queues << QString("%1 %2/%3").arg(stage.name).arg(stage.queueDepth).arg(stage.queueCapacity);
+        }
+        m_streamLabel->setText(QString("Stream: %1 frames received | %2 fps, latency %3 ms | queues %4 | dropped %5")
+                                   .arg(stats.delivered).arg(stats.fps, 0, 'f', 1).arg(stats.latencyMs, 0, 'f', 0)
+                                   .arg(queues.join(", ")).arg(stats.dropped));
+    }
+    if (stats.finished) {
+        const QString error = QString::fromStdString(m_stream->lastError());
+        m_streamTimer->stop();
+        m_stream.reset();
+        if (!error.isEmpty()) {
+            QMessageBox::warning(this, "Stream", error);
+        } else {
+            afficherMessage(this, QString("Stream finished: %1 frames, %2 dropped, %3 fps on average.")
+                                      .arg(stats.decoded).arg(stats.dropped).arg(stats.averageFps, 0, 'f', 1),
+                            "Info", QMessageBox::Information, 2000);
+        }
+    }
+}
+
+/**
+ * @brief Slot de l'action "Compare with golden board..." : l'image courante est comparée à une carte de référence
+ * choisie par l'utilisateur. Les composants sont détectés avec les paramètres des sliders (sur l'image courante,
+ * le dernier résultat affiché est réutilisé s'il correspond à ces paramètres), puis les deux cartes sont recalées
+ * et comparées dans un thread de fond. Les différences sont dessinées sur l'image courante dans une nouvelle
+ * fenêtre (onGoldenComparisonFinished()).
+ */
+void MainWindow::onCompareWithGoldenBoard() {
+    if (image.empty()) {
+        QMessageBox::information(this, "Info", "Load the board to inspect first.");
+        return;
+    }
+    if (m_compareRunning) {
+        QMessageBox::information(this, "Comparison", "A comparison is already running.");
+        return;
+    }
+    QString fileName = QFileDialog::getOpenFileName(this, "Choose the golden board image", "",
+                                                    "Images (*.png *.jpg *.jpeg *.bmp *.tif)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    const cv::Mat reference = cv::imread(fileName.toStdString());
+    if (reference.empty()) {
+        QMessageBox::warning(this, "Error", "Failed to load the golden board image!");
+        return;
+    }
+    if (m_compareThread.joinable()) {
+        m_compareThread.join(); // Comparaison précédente terminée : son thread n'a plus rien à faire
+    }
+
+    const PipelineParams params = currentPipelineParams();
+    const cv::Mat test = image; // En-tête partagé : les pixels restent valides si une autre image est chargée
+    std::vector<cv::Rect> testRects;
+    const bool haveTestRects = resultWindow && resultWindow->lastDetection(test, params, testRects);
+    const QString referenceName = QFileInfo(fileName).fileName();
+    const std::uint64_t generation = ++m_compareGeneration;
+    m_compareRunning = true;
+    if (ui->statusbar) {
+        ui->statusbar->showMessage(QString("Comparing with %1...").arg(referenceName));
+    }
+
+    m_compareThread = std::thread([this, reference, test, testRects, haveTestRects, params, referenceName, generation]() {
+        const CancellationToken token(&m_compareGeneration, generation);
+        // Même choix que PipelineWorker : les très grands scans passent par le mode tuilé (mémoire bornée)
+        const auto detect = [&params, &token](const cv::Mat& bgr) {
+            if (static_cast<double>(bgr.total()) >= TiledPipeline::kAutoTilingPixels) {
+                return TiledPipeline::run(bgr, params, TilingOptions(), token).rects;
+            }
+            PcbPipeline pipeline;
+            pipeline.setImage(bgr);
+            return pipeline.run(params, token).rects;
+        };
+        BoardComparison comparison;
+        cv::Mat overlay;
+        QString error;
+        try {
+            const std::vector<cv::Rect> referenceRects = detect(reference);
+            const std::vector<cv::Rect> rects = haveTestRects || token.isCancelled() ? testRects : detect(test);
+            if (token.isCancelled()) {
+                return; // Fenêtre fermée : aucun résultat à afficher
+            }
+            GoldenBoard golden;
+            golden.setReference(reference, referenceRects);
+            comparison = golden.compare(test, rects);
+            overlay = golden.renderOverlay(test, rects, comparison);
+        } catch (const cv::Exception& e) {
+            error = QString::fromStdString(e.what());
+        }
+        if (token.isCancelled()) {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, comparison, overlay, referenceName, error]() {
+            onGoldenComparisonFinished(comparison, overlay, referenceName, error);
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Reçoit le résultat d'une comparaison (thread GUI) : ouvre l'image annotée et affiche le décompte.
+ */
+void MainWindow::onGoldenComparisonFinished(const BoardComparison& comparison, const cv::Mat& overlay,
+                                            const QString& referenceName, const QString& error) {
+    m_compareRunning = false;
+    if (ui->statusbar) ui->statusbar->clearMessage();
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, "Error", error);
+        return;
+    }
+
+    ImageWindow *overlayWindow = new ImageWindow(this);
+    overlayWindow->setWindowTitle("Comparison with " + referenceName);
+    overlayWindow->showRawImage(overlay);
+    overlayWindow->show();
+
+    const BoardRegistration& registration = comparison.registration;
+    const QString summary = QString("Missing: %1, extra: %2, shifted: %3, matched: %4\n"
+                                    "Registration: (%5, %6) px, %7 deg, %8 ms; diff: %9 ms")
+                                .arg(comparison.missing.size()).arg(comparison.extra.size())
+                                .arg(comparison.shifted.size()).arg(comparison.matched.size())
+                                .arg(registration.testToReference(0, 2), 0, 'f', 1)
+                                .arg(registration.testToReference(1, 2), 0, 'f', 1)
+                                .arg(registration.angleDegrees(), 0, 'f', 2)
+                                .arg(comparison.registrationMs, 0, 'f', 0).arg(comparison.diffMs, 0, 'f', 1);
+    if (comparison.identical()) {
+        afficherMessage(this, "The board matches the golden board.\n" + summary, "Comparison",
+                        QMessageBox::Information, 2500);
+    } else {
+        QMessageBox::warning(this, "Comparison", summary);
+    }
+}
+
+/**
+ * @brief Slot du bouton "Tune Parameters" de la fenêtre de dessin : cherche, dans un thread de fond, les valeurs
+ * des sliders dont les détections retrouvent le mieux les rectangles dessinés (ParameterTuner, tous les cœurs).
+ * Sur une seule image, les combinaisons sont tirées au hasard (quelques centaines au lieu de la grille entière,
+ * voir pcb_tune pour une recherche exhaustive). L'avancement s'affiche dans la barre d'état et le réglage peut
+ * être interrompu (Tools > Cancel parameter tuning) ; à la fin, le meilleur jeu est proposé (onTuningFinished()).
+ */
+void MainWindow::onTuneRequested(const cv::Mat& boardImage, const std::vector<cv::Rect>& annotations) {
+    if (m_tuningRunning) {
+        QMessageBox::information(this, "Tune Parameters", "A parameter search is already running.");
+        return;
+    }
+    if (m_tuningThread.joinable()) {
+        m_tuningThread.join(); // Réglage précédent terminé : son thread n'a plus rien à faire
+    }
+    TunerOptions options;
+    options.space.extractor = currentPipelineParams().extractor; // Méthode d'extraction choisie dans le menu Tools
+    options.strategy = SearchStrategy::Random; // La grille complète (des dizaines de milliers de candidats) est trop longue ici
+    std::shared_ptr<ParameterTuner> tuner = std::make_shared<ParameterTuner>(options);
+    tuner->addSample(boardImage, annotations);
+    const std::uint64_t generation = ++m_tuningGeneration;
+    m_tuningRunning = true;
+    m_cancelTuningAction->setEnabled(true);
+    if (ui->statusbar) {
+        ui->statusbar->showMessage(QString("Tuning: %1 candidates against %2 rectangles...")
+                                       .arg(tuner->candidates().size()).arg(annotations.size()));
+    }
+
+    m_tuningThread = std::thread([this, tuner, generation]() {
+        const CancellationToken token(&m_tuningGeneration, generation);
+        TuningResult result;
+        QString error;
+        try {
+            result = tuner->run([this](const TuningProgress& progress) {
+                // Appelé depuis un thread du pool : la barre d'état est mise à jour dans le thread GUI
+                QMetaObject::invokeMethod(this, [this, progress]() {
+                    if (ui->statusbar) {
+                        ui->statusbar->showMessage(QString("Tuning: %1 / %2 blur settings evaluated (%3 candidates)")
+                                                       .arg(progress.tasksDone).arg(progress.tasksTotal)
+                                                       .arg(progress.candidates));
+                    }
+                }, Qt::QueuedConnection);
+            }, token);
+        } catch (const cv::Exception& e) {
+            error = QString::fromStdString(e.what());
+        }
+        QMetaObject::invokeMethod(this, [this, result, error]() { onTuningFinished(result, error); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Slot de l'action "Cancel parameter tuning" : le réglage en cours s'arrête à la fin de ses tâches en cours,
+ * puis onTuningFinished() reçoit un résultat annulé (rien n'est proposé).
+ */
+void MainWindow::onCancelTuning() {
+    if (!m_tuningRunning) {
+        return;
+    }
+    ++m_tuningGeneration;
+    m_cancelTuningAction->setEnabled(false);
+    if (ui->statusbar) ui->statusbar->showMessage("Tuning: cancelling...");
+}
+
+/**
+ * @brief Reçoit le résultat d'un réglage (thread GUI) et propose d'appliquer le meilleur jeu aux sliders.
+ */
+void MainWindow::onTuningFinished(const TuningResult& result, const QString& error) {
+    m_tuningRunning = false;
+    m_cancelTuningAction->setEnabled(false);
+    if (ui->statusbar) ui->statusbar->clearMessage();
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, "Tune Parameters", error);
+        return;
+    }
+    if (result.cancelled || result.ranking.empty()) {
+        return;
+    }
+    const PipelineParams& best = result.best;
+    const MatchCounts& counts = result.bestCounts;
+    const QString summary = QString("Best values: blur %1, sigma %2, CLAHE %3, separation %4, fill holes %5, min area %6\n"
+                                    "F1 %7 (precision %8, recall %9), mean IoU %10\n"
+                                    "%11 candidates in %12 s (%13 blur/CLAHE runs shared between them)\n\n"
+                                    "Apply these values to the sliders?")
+                                .arg(best.blurKsize).arg(best.sigmaX).arg(best.claheClipLimit)
+                                .arg(best.separationKsize).arg(best.fillHolesKsize).arg(best.contourMinArea)
+                                .arg(counts.f1(), 0, 'f', 3).arg(counts.precision(), 0, 'f', 3)
+                                .arg(counts.recall(), 0, 'f', 3).arg(counts.meanIoU(), 0, 'f', 3)
+                                .arg(result.candidateCount).arg(result.elapsedSeconds, 0, 'f', 1)
+                                .arg(result.preprocessingRuns);
+    if (QMessageBox::question(this, "Tune Parameters", summary, QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
+        setPipelineParams(best);
+    }
+}
+
 /**
  * @brief Gestionnaire de l'événement de redimensionnement de la fenêtre.
  * Permet de redimensionner l'image de fond pour qu'elle s'adapte à la nouvelle taille de la fenêtre.
@@ -561,6 +1167,9 @@ void MainWindow::afficherMessage(QWidget *parent, const QString &texte,
  */
 void MainWindow::clearProcessedImageDisplays() {
     qDebug() << "clearProcessedImageDisplays appelé. Réinitialisation des affichages.";
+    if (m_stream) {
+        onStopStream(); // Le flux écrirait à nouveau dans les affichages
+    }
 
     // Réinitialise les QLabel d'affichage des images avec leurs placeholders
     QLabel *maskDisplayLabel = ui->labelImage_Mask->findChild<QLabel*>("labelImage_Mask_2");
@@ -588,10 +1197,8 @@ void MainWindow::clearProcessedImageDisplays() {
     }
     m_lastExtractedComponentsPixmap = QPixmap(); // Efface le pixmap stocké en mémoire
 
-    // Efface le QListWidget des composants
-    if (ui->listWidgetComponents) {
-        ui->listWidgetComponents->clear();
-    }
+    // Efface la liste des composants et ses vignettes (elles concernent l'image précédente)
+    m_componentModel->clear(true);
     m_lastDetectedComponents.clear(); // Efface la liste stockée des objets Composant
 
     // **MODIFIÉ : Réinitialise le flag d'affichage complet à `false`.**
@@ -611,4 +1218,5 @@ void MainWindow::clearProcessedImageDisplays() {
     }
 
     image.release(); // Libère la mémoire de l'image OpenCV originale
+    m_imagePath.clear();
 }
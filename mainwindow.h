@@ -7,9 +7,20 @@
 #include <opencv2/opencv.hpp>
 #include "drawingwindow.h" // ADD THIS LINE: Include our new drawing window class
 #include"imagewindow.h"
-#include<QListWidget>
+#include "pipelineparams.h" // Paramètres du pipeline de détection (bibliothèque pcb_core)
+#include "componentlistmodel.h" // Modèle de la liste des composants (lignes visibles seulement)
+#include "framestream.h" // Détection sur un flux de trames (caméra, vidéo), étages en parallèle
+#include "parametertuner.h" // Réglage automatique des paramètres d'après des rectangles annotés
+#include "boardcomparison.h" // Recalage et comparaison à une carte de référence
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include<QListView>
 #include<QLabel>
 #include<QMessageBox>
+#include<QTimer>
+#include<QPointer>
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
@@ -46,25 +57,72 @@ private slots:
     // Slots pour l'affichage des résultats du traitement par ImageWindow
     void displayContoursImage(const QPixmap& resultPixmap);
     void displayExtractedComponentsImage(const QPixmap& extractedComponentsPixmap);
-    void displayDetectedComponentsInList(const QList<Composant>& components);
+    void displayDetectedComponentsInList(const QVector<Composant>& components);
 
     void showExtractedComponentsImageAndList(); // Nouveau slot pour le bouton "TraitementButton_2"
     void clearProcessedImageDisplays(); // Slot pour effacer les affichages
     void onOpenDrawingWindow(); // ADD THIS LINE: New slot for opening the drawing window
+    void onExportComponents(); // Slot pour exporter les composants détectés (Ctrl+E)
+    void onComponentsExported(int written, int failed, const QString& directory); // Fin d'un export
+    void onProfilerToggled(bool enabled); // Active/désactive le profileur du pipeline
+    void onSaveProfilerStatistics(); // Écrit les percentiles du profileur dans un fichier JSON
+    void refreshProfilerStatus(); // Affiche la décomposition du dernier passage dans la barre d'état
+    void onOpenVideoStream(); // Lance la détection sur un fichier vidéo ou une suite d'images
+    void onOpenCamera(); // Lance la détection sur une caméra
+    void onStopStream(); // Arrête le flux en cours
+    void onStreamTick(); // Affiche la dernière trame rendue et l'état du flux
+    void onCompareWithGoldenBoard(); // Compare l'image courante à une carte de référence choisie
+    void onTuneRequested(const cv::Mat& boardImage, const std::vector<cv::Rect>& annotations); // Bouton "Tune Parameters"
+    void onCancelTuning(); // Arrête le réglage automatique en cours
 
 private:
     Ui::MainWindow *ui; // Pointeur vers l'interface utilisateur générée par Qt Designer
     cv::Mat image; // L'image OpenCV originale chargée (votre variable 'image' est ici)
+    QString m_imagePath; // Fichier d'où vient `image` (vide pour une trame de flux)
     ImageWindow *maskWindow; // Fenêtre pour le masque/image pré-traitée
     ImageWindow *resultWindow; // Fenêtre pour les résultats complets (contours, composants)
 
-    QListWidget *m_componentListWidget; // Pointeur vers le QListWidget pour la liste des composants
     QLabel *m_componentCountLabel; // Pointeur vers le QLabel pour le compte des composants
 
     QPixmap m_lastExtractedComponentsPixmap; // Stocke le dernier pixmap des composants extraits
-    QList<Composant> m_lastDetectedComponents; // Stocke la dernière liste de composants détectés
+    QVector<Composant> m_lastDetectedComponents; // Stocke la dernière liste de composants détectés
+    QPointer<DrawingWindow> m_drawingWindow; // Dernière fenêtre de dessin ouverte (nulle une fois fermée), reçoit les détections
+    ComponentListModel *m_componentModel; // Modèle affiché par ui->listViewComponents (vignettes générées à la demande)
 
     bool m_displayFullResults; // Flag pour contrôler l'affichage complet des résultats
+    ExportOptions m_exportOptions; // Répertoire, format et niveau utilisés pour l'export des composants
+    QLabel *m_profilerLabel; // Décomposition du dernier passage, dans la barre d'état (profileur actif)
+    QTimer *m_profilerRefreshTimer; // Rafraîchit m_profilerLabel tant que le profileur est actif
+    QAction *m_connectedComponentsAction; // Cochée : extraction des composants par composantes connexes
+    std::unique_ptr<FrameStream> m_stream; // Flux en cours (nul sans flux)
+    QTimer *m_streamTimer; // Relève les trames rendues du flux, ~30 fois par seconde
+    QLabel *m_streamLabel; // Débit, latence et profondeur des files du flux, dans la barre d'état
+    std::thread m_tuningThread; // Réglage automatique en cours (ou terminé, pas encore rejoint)
+    std::atomic<std::uint64_t> m_tuningGeneration; // Incrémenté à chaque réglage ; à la fermeture, annule celui en cours
+    bool m_tuningRunning; // Vrai du lancement d'un réglage à la réception de son résultat (thread GUI)
+    QAction *m_cancelTuningAction; // Menu Tools : active seulement pendant un réglage
+    std::thread m_compareThread; // Comparaison à une carte de référence en cours (ou terminée, pas encore rejointe)
+    std::atomic<std::uint64_t> m_compareGeneration; // Incrémenté à chaque comparaison ; à la fermeture, annule celle en cours
+    bool m_compareRunning; // Vrai du lancement d'une comparaison à la réception de son résultat (thread GUI)
+
+    // Démarre un flux sur `source` (voir FrameStream::open()) avec les paramètres des sliders
+    void startStream(const std::string& source);
+
+    // Affiche le résultat d'un réglage automatique et propose de l'appliquer aux sliders
+    void onTuningFinished(const TuningResult& result, const QString& error);
+
+    // Affiche le résultat d'une comparaison à une carte de référence (image annotée et décompte des différences)
+    void onGoldenComparisonFinished(const BoardComparison& comparison, const cv::Mat& overlay,
+                                    const QString& referenceName, const QString& error);
+
+    // Place les sliders (et la méthode d'extraction) sur les valeurs d'un jeu de paramètres
+    void setPipelineParams(const PipelineParams& params);
+
+    // Boîtes englobantes de la dernière liste de composants détectés
+    std::vector<cv::Rect> lastDetectionRects() const;
+
+    // Lit les valeurs actuelles des six sliders (et la méthode d'extraction) dans une structure PipelineParams
+    PipelineParams currentPipelineParams() const;
 
     // Fonction utilitaire pour afficher des messages temporaires
     void afficherMessage(QWidget *parent, const QString &texte,
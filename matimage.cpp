@@ -0,0 +1,80 @@
+// matimage.cpp
+#include "matimage.h"
+#include <QDebug>                // Avertissement pour les types non pris en charge
+#include <QtEndian>              // Q_BYTE_ORDER (disposition mémoire de Format_ARGB32)
+#include <opencv2/imgproc.hpp>   // cvtColor (images 16 bits en couleur)
+#include "pipelineprofiler.h"    // Mesure de la durée des conversions (ScopedStageTimer)
+
+namespace {
+
+/**
+ * @brief Fonction de nettoyage de la QImage : libère la référence sur la Mat enveloppée.
+ */
+void releaseMat(void* info)
+{
+    delete static_cast<cv::Mat*>(info);
+}
+
+/**
+ * @brief Crée une QImage qui partage les pixels de `mat` (la Mat est conservée jusqu'au nettoyage de la QImage).
+ */
+QImage wrap(const cv::Mat& mat, QImage::Format format)
+{
+    cv::Mat* owner = new cv::Mat(mat); // Copie d'en-tête : incrémente le compteur de références, pas les pixels
+    return QImage(static_cast<const uchar*>(owner->data), owner->cols, owner->rows,
+                  static_cast<int>(owner->step), format, releaseMat, owner);
+}
+
+} // namespace
+
+/**
+ * @brief Enveloppe une cv::Mat dans une QImage (voir matimage.h).
+ */
+QImage matToQImage(const cv::Mat& mat)
+{
+    if (mat.empty()) {
+        return QImage();
+    }
+
+    switch (mat.type()) {
+    case CV_8UC1:
+        return wrap(mat, QImage::Format_Grayscale8);
+    case CV_16UC1:
+        return wrap(mat, QImage::Format_Grayscale16);
+    case CV_8UC3:
+        return wrap(mat, QImage::Format_BGR888);
+    case CV_8UC4: {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        // Format_ARGB32 est un mot 0xAARRGGBB : en mémoire petit-boutiste, les octets sont B, G, R, A comme dans OpenCV
+        return wrap(mat, QImage::Format_ARGB32);
+#else
+        cv::Mat rgba;
+        cv::cvtColor(mat, rgba, cv::COLOR_BGRA2RGBA);
+        return wrap(rgba, QImage::Format_RGBA8888);
+#endif
+    }
+    case CV_16UC3:
+    case CV_16UC4: {
+        // Qt n'a pas de format 16 bits dans l'ordre BGR : une conversion vers RGBA 16 bits est inévitable
+        cv::Mat rgba;
+        cv::cvtColor(mat, rgba, mat.channels() == 3 ? cv::COLOR_BGR2RGBA : cv::COLOR_BGRA2RGBA);
+        return wrap(rgba, QImage::Format_RGBA64);
+    }
+    default:
+        qWarning() << "matToQImage: type de cv::Mat non pris en charge :" << mat.type();
+        return QImage();
+    }
+}
+
+/**
+ * @brief Convertit une cv::Mat en QPixmap (voir matimage.h).
+ */
+QPixmap matToQPixmap(const cv::Mat& mat)
+{
+    ScopedStageTimer timer("matToQPixmap");
+    const QImage image = matToQImage(mat);
+    if (image.isNull()) {
+        return QPixmap();
+    }
+    return QPixmap::fromImage(image);
+}
@@ -0,0 +1,35 @@
+// matimage.h
+#ifndef MATIMAGE_H
+#define MATIMAGE_H
+
+#include <QImage>
+#include <QPixmap>
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Enveloppe une cv::Mat dans une QImage, sans copie des pixels quand le format le permet.
+ *
+ * La QImage pointe directement sur les données de la Mat et garde une référence sur elle : la Mat est libérée
+ * par la fonction de nettoyage de la QImage (dernière copie détruite), jamais avant. Les données sont passées
+ * en lecture seule : une écriture dans la QImage la détache (copie) au lieu de modifier la Mat.
+ *
+ * Formats pris en charge :
+ * - CV_8UC1 -> Format_Grayscale8 et CV_16UC1 -> Format_Grayscale16 (sans copie) ;
+ * - CV_8UC3 (BGR) -> Format_BGR888 (sans copie) ;
+ * - CV_8UC4 (BGRA) -> Format_ARGB32 (sans copie sur les processeurs petit-boutistes) ;
+ * - CV_16UC3 / CV_16UC4 -> Format_RGBA64 (une conversion BGR(A) -> RGBA est nécessaire).
+ * Une ROI (Mat non continue) est prise en charge : le pas de ligne de la Mat est transmis à la QImage.
+ * @param mat L'image OpenCV à envelopper.
+ * @return La QImage, ou une QImage nulle si la Mat est vide ou d'un type non pris en charge.
+ */
+QImage matToQImage(const cv::Mat& mat);
+
+/**
+ * @brief Convertit une cv::Mat en QPixmap pour l'affichage dans un widget.
+ * Passe par matToQImage() : la seule copie est celle de QPixmap::fromImage vers le format d'affichage.
+ * @param mat L'image OpenCV à convertir.
+ * @return La QPixmap, ou une QPixmap nulle si la Mat est vide ou d'un type non pris en charge.
+ */
+QPixmap matToQPixmap(const cv::Mat& mat);
+
+#endif // MATIMAGE_H
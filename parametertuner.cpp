@@ -0,0 +1,297 @@
+// parametertuner.cpp
+#include "parametertuner.h"
+#include <algorithm>   // std::sort, std::shuffle, std::min
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>      // std::mt19937 (tirage des candidats, ordre des images)
+#include <set>
+#include <string>
+#include <tuple>
+#include <opencv2/imgproc.hpp>
+#include "pcbpipeline.h"
+#include "threadpool.h"
+
+using namespace cv;
+
+namespace {
+
+// Clé d'un jeu de paramètres (dédoublonnage du tirage aléatoire)
+std::tuple<int, int, int, int, int, int> keyOf(const PipelineParams& p)
+{
+    return std::make_tuple(p.blurKsize, p.sigmaX, p.claheClipLimit, p.fillHolesKsize, p.separationKsize, p.contourMinArea);
+}
+
+// Meilleur candidat d'abord : F1, puis IoU moyen, puis ordre de la grille
+bool betterThan(const CandidateScore& a, int indexA, const CandidateScore& b, int indexB)
+{
+    const double fa = a.counts.f1(), fb = b.counts.f1();
+    if (fa != fb) return fa > fb;
+    const double ia = a.counts.meanIoU(), ib = b.counts.meanIoU();
+    if (ia != ib) return ia > ib;
+    return indexA < indexB;
+}
+
+} // namespace
+
+std::vector<int> ParameterRange::values() const
+{
+    std::vector<int> result;
+    const int increment = std::max(1, step);
+    for (int value = min; value <= max; value += increment) {
+        result.push_back(value);
+    }
+    if (result.empty()) {
+        result.push_back(min); // Plage inversée : la borne basse seule
+    }
+    return result;
+}
+
+long long TuningSpace::gridSize() const
+{
+    return static_cast<long long>(blurKsize.values().size()) * sigmaX.values().size() * claheClipLimit.values().size()
+           * separationKsize.values().size() * fillHolesKsize.values().size() * contourMinArea.values().size();
+}
+
+ParameterTuner::ParameterTuner(const TunerOptions& options)
+    : m_options(options)
+{
+}
+
+void ParameterTuner::addSample(const cv::Mat& bgr, const std::vector<cv::Rect>& annotations)
+{
+    CV_Assert(!bgr.empty() && bgr.type() == CV_8UC3);
+    m_samples.push_back({ bgr, GroundTruth(annotations) });
+}
+
+/**
+ * @brief Grille complète, ou tirage sans doublon si la grille dépasse randomCandidates.
+ * Un flou de noyau 1x1 (blurKsize = 0) laisse l'image intacte quel que soit sigmaX : ces candidats ne gardent
+ * que la première valeur de sigmaX.
+ */
+std::vector<PipelineParams> ParameterTuner::candidates() const
+{
+    const TuningSpace& space = m_options.space;
+    const std::vector<int> blurs = space.blurKsize.values(), sigmas = space.sigmaX.values(),
+                           clahes = space.claheClipLimit.values(), fills = space.fillHolesKsize.values(),
+                           separations = space.separationKsize.values(), areas = space.contourMinArea.values();
+    auto make = [&](int blur, int sigma, int clahe, int fill, int separation, int area) {
+        PipelineParams p;
+        p.blurKsize = blur;
+        p.sigmaX = blur == 0 ? sigmas.front() : sigma;
+        p.claheClipLimit = clahe;
+        p.fillHolesKsize = fill;
+        p.separationKsize = separation;
+        p.contourMinArea = area;
+        p.extractor = space.extractor;
+        return p;
+    };
+
+    std::vector<PipelineParams> result;
+    if (m_options.strategy == SearchStrategy::Random && space.gridSize() > m_options.randomCandidates) {
+        std::mt19937 rng(m_options.seed);
+        auto pick = [&rng](const std::vector<int>& values) {
+            return values[std::uniform_int_distribution<std::size_t>(0, values.size() - 1)(rng)];
+        };
+        std::set<std::tuple<int, int, int, int, int, int>> seen;
+        const int wanted = std::max(1, m_options.randomCandidates);
+        for (int attempt = 0; static_cast<int>(result.size()) < wanted && attempt < 50 * wanted; ++attempt) {
+            const PipelineParams p = make(pick(blurs), pick(sigmas), pick(clahes), pick(fills), pick(separations), pick(areas));
+            if (seen.insert(keyOf(p)).second) {
+                result.push_back(p);
+            }
+        }
+        return result;
+    }
+
+    for (int blur : blurs) {
+        for (int sigma : sigmas) {
+            if (blur == 0 && sigma != sigmas.front()) {
+                continue;
+            }
+            for (int clahe : clahes) {
+                for (int fill : fills) {
+                    for (int separation : separations) {
+                        for (int area : areas) {
+                            result.push_back(make(blur, sigma, clahe, fill, separation, area));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Réduction successive sur les images (voir la description de la classe).
+ * Les tours évaluent 1, f, f², ... images (f = halvingFactor) puis toutes ; chaque tour n'évalue les survivants
+ * que sur les images qu'ils n'ont pas encore vues, leurs bilans se cumulent d'un tour à l'autre.
+ */
+TuningResult ParameterTuner::run(const std::function<void(const TuningProgress&)>& progress,
+                                 const CancellationToken& token) const
+{
+    CV_Assert(!m_samples.empty());
+    const auto start = std::chrono::steady_clock::now();
+    TuningResult result;
+    const std::vector<PipelineParams> params = candidates();
+    result.candidateCount = static_cast<int>(params.size());
+    std::vector<CandidateScore> scores(params.size());
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        scores[i].params = params[i];
+    }
+
+    ThreadPool pool(m_options.threadCount);
+    std::mutex mutex; // Protège scores, les compteurs de result et firstError
+    std::string firstError;
+
+    // Niveaux de gris et zones sombres de chaque image : ne dépendent d'aucun paramètre
+    const int sampleCount = static_cast<int>(m_samples.size());
+    std::vector<Mat> grays(sampleCount), darkMasks(sampleCount);
+    for (int s = 0; s < sampleCount; ++s) {
+        pool.submit([&, s]() {
+            if (token.isCancelled()) return;
+            try {
+                Mat darkPixels;
+                PcbPipeline::toGrayAndDarkPixels(m_samples[s].image, grays[s], darkPixels);
+                PcbPipeline::closeDarkAreas(darkPixels, darkMasks[s]);
+            } catch (const cv::Exception& e) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (firstError.empty()) firstError = e.what();
+            }
+        });
+    }
+    pool.waitIdle();
+
+    // Ordre des images (tiré une fois) et nombre d'images évaluées à la fin de chaque tour
+    std::vector<int> order(sampleCount);
+    for (int s = 0; s < sampleCount; ++s) order[s] = s;
+    std::shuffle(order.begin(), order.end(), std::mt19937(m_options.seed));
+    std::vector<int> budgets;
+    if (m_options.halvingFactor >= 2) {
+        for (long long budget = 1; budget < sampleCount; budget *= m_options.halvingFactor) {
+            budgets.push_back(static_cast<int>(budget));
+        }
+    }
+    budgets.push_back(sampleCount);
+
+    std::vector<int> alive(params.size());
+    for (std::size_t i = 0; i < params.size(); ++i) alive[i] = static_cast<int>(i);
+    auto rankAlive = [&]() {
+        std::sort(alive.begin(), alive.end(), [&](int a, int b) { return betterThan(scores[a], a, scores[b], b); });
+    };
+
+    int evaluated = 0; // Images déjà évaluées par les survivants
+    for (std::size_t round = 0; round < budgets.size() && firstError.empty() && !token.isCancelled(); ++round) {
+        // Candidats regroupés par flou : une tâche par (image, flou)
+        std::map<std::pair<int, int>, std::vector<int>> groups;
+        for (int i : alive) {
+            groups[std::make_pair(params[i].blurKsize, params[i].sigmaX)].push_back(i);
+        }
+        TuningProgress state;
+        state.round = static_cast<int>(round);
+        state.roundCount = static_cast<int>(budgets.size());
+        state.candidates = static_cast<int>(alive.size());
+        state.tasksTotal = static_cast<int>(groups.size()) * (budgets[round] - evaluated);
+        std::atomic<int> tasksDone(0);
+
+        for (int k = evaluated; k < budgets[round]; ++k) {
+            const int s = order[k];
+            for (const auto& group : groups) {
+                const std::vector<int>* members = &group.second;
+                pool.submit([&, s, members]() {
+                    if (token.isCancelled()) return;
+                    // Membres triés selon les dépendances : CLAHE, fermeture, ouverture, puis aire minimale
+                    std::vector<int> sorted = *members;
+                    std::sort(sorted.begin(), sorted.end(), [&](int a, int b) {
+                        const PipelineParams& x = params[a];
+                        const PipelineParams& y = params[b];
+                        return std::make_tuple(x.claheClipLimit, x.fillHolesKsize, x.separationKsize, x.contourMinArea)
+                               < std::make_tuple(y.claheClipLimit, y.fillHolesKsize, y.separationKsize, y.contourMinArea);
+                    });
+                    std::vector<std::pair<int, MatchCounts>> local;
+                    local.reserve(sorted.size());
+                    long long preprocessingRuns = 0, morphologyRuns = 0;
+                    try {
+                        const Sample& sample = m_samples[s];
+                        PipelineWorkspace workspace; // CLAHE et images intermédiaires de la morphologie de cette tâche
+                        Mat blurred, preprocessed, threshold, closed, opened;
+                        std::vector<Rect> candidateRects, rects;
+                        std::vector<double> candidateAreas, areas;
+                        PcbPipeline::applyGaussianBlur(grays[s], blurred, params[sorted.front()]);
+                        ++preprocessingRuns;
+                        const PipelineParams* previous = nullptr;
+                        for (int i : sorted) {
+                            const PipelineParams& p = params[i];
+                            bool changed = !previous || previous->claheClipLimit != p.claheClipLimit;
+                            if (changed) {
+                                if (token.isCancelled()) return;
+                                workspace.clahe(p.claheClipLimit / 10.0)->apply(blurred, preprocessed); // Comme applyClahe()
+                                PcbPipeline::segment(preprocessed, threshold);
+                                ++preprocessingRuns;
+                            }
+                            changed = changed || previous->fillHolesKsize != p.fillHolesKsize;
+                            if (changed) {
+                                bitwise_or(threshold, darkMasks[s], closed);
+                                PcbPipeline::applyFillHoles(closed, p, &workspace.morphology());
+                            }
+                            changed = changed || previous->separationKsize != p.separationKsize;
+                            if (changed) {
+                                closed.copyTo(opened);
+                                PcbPipeline::applySeparation(opened, p, &workspace.morphology());
+                                PcbPipeline::findComponentCandidates(opened, p.extractor, candidateRects, candidateAreas);
+                                ++morphologyRuns;
+                            }
+                            PcbPipeline::filterComponents(candidateRects, candidateAreas, p.contourMinArea,
+                                                          sample.image.size(), rects, areas);
+                            local.emplace_back(i, sample.truth.match(rects, m_options.minIoU));
+                            previous = &p;
+                        }
+                    } catch (const cv::Exception& e) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (firstError.empty()) firstError = e.what();
+                        return;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        for (const auto& entry : local) {
+                            scores[entry.first].counts += entry.second;
+                            ++scores[entry.first].samples;
+                        }
+                        result.evaluations += static_cast<long long>(local.size());
+                        result.preprocessingRuns += preprocessingRuns;
+                        result.morphologyRuns += morphologyRuns;
+                    }
+                    if (progress) {
+                        TuningProgress done = state;
+                        done.tasksDone = ++tasksDone;
+                        progress(done);
+                    }
+                });
+            }
+        }
+        pool.waitIdle();
+        evaluated = budgets[round];
+
+        rankAlive();
+        if (round + 1 < budgets.size()) {
+            const std::size_t keep = (alive.size() + m_options.halvingFactor - 1) / m_options.halvingFactor;
+            alive.resize(std::max<std::size_t>(1, keep));
+        }
+    }
+
+    if (!firstError.empty()) {
+        CV_Error(Error::StsError, "parameter tuning: " + firstError);
+    }
+    result.cancelled = token.isCancelled();
+    for (int i : alive) {
+        result.ranking.push_back(scores[i]);
+    }
+    if (!result.ranking.empty()) {
+        result.best = result.ranking.front().params;
+        result.bestCounts = result.ranking.front().counts;
+    }
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,153 @@
+// parametertuner.h
+#ifndef PARAMETERTUNER_H
+#define PARAMETERTUNER_H
+
+#include <functional>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "cancellationtoken.h"
+#include "groundtruth.h"
+#include "pipelineparams.h"
+
+/**
+ * @brief Valeurs essayées pour un paramètre : de `min` à `max` par pas de `step` (valeurs brutes des sliders).
+ */
+struct ParameterRange
+{
+    int min = 0;
+    int max = 0;
+    int step = 1;
+
+    std::vector<int> values() const;
+};
+
+/**
+ * @brief Espace de recherche du réglage automatique : une plage par slider.
+ * Les plages par défaut couvrent les réglages utiles des sliders de MainWindow avec un pas grossier.
+ */
+struct TuningSpace
+{
+    ParameterRange blurKsize { 0, 3, 1 };
+    ParameterRange sigmaX { 0, 20, 5 };
+    ParameterRange claheClipLimit { 5, 40, 5 };
+    ParameterRange separationKsize { 0, 6, 1 };
+    ParameterRange fillHolesKsize { 0, 4, 1 };
+    ParameterRange contourMinArea { 0, 300, 25 };
+    ComponentExtractor extractor = ComponentExtractor::Contours; // Pas réglé : même méthode pour tous les candidats
+
+    /**
+     * @brief Nombre de combinaisons de la grille complète.
+     */
+    long long gridSize() const;
+};
+
+enum class SearchStrategy
+{
+    Grid,   // Toutes les combinaisons de l'espace
+    Random  // `randomCandidates` combinaisons tirées au hasard dans l'espace
+};
+
+struct TunerOptions
+{
+    TuningSpace space;
+    SearchStrategy strategy = SearchStrategy::Grid;
+    int randomCandidates = 400; // Recherche aléatoire : nombre de combinaisons tirées
+    unsigned seed = 1;          // Graine du tirage (et de l'ordre des images pour la réduction successive)
+    double minIoU = 0.5;        // IoU minimal d'une détection appariée à une annotation
+    int halvingFactor = 2;      // Réduction successive : seul 1 candidat sur halvingFactor passe au tour suivant
+    unsigned threadCount = 0;   // 0 : nombre de cœurs
+};
+
+/**
+ * @brief Score d'un jeu de paramètres sur les images où il a été évalué.
+ */
+struct CandidateScore
+{
+    PipelineParams params;
+    MatchCounts counts;  // Cumul sur les images évaluées
+    int samples = 0;     // Nombre d'images évaluées
+};
+
+/**
+ * @brief Avancement d'un réglage, transmis pendant run().
+ */
+struct TuningProgress
+{
+    int round = 0;         // Tour de réduction successive (à partir de 0)
+    int roundCount = 1;
+    int candidates = 0;    // Candidats encore en lice pendant ce tour
+    int tasksDone = 0;     // Tâches (image x flou) terminées pendant ce tour
+    int tasksTotal = 0;
+};
+
+struct TuningResult
+{
+    PipelineParams best;                  // Meilleur jeu de paramètres (F1 puis IoU moyen)
+    MatchCounts bestCounts;               // Son bilan sur toutes les images
+    std::vector<CandidateScore> ranking;  // Candidats du dernier tour, du meilleur au moins bon
+    long long evaluations = 0;            // Appariements candidat x image effectués
+    long long preprocessingRuns = 0;      // Flous et CLAHE calculés (les autres candidats les ont réutilisés)
+    long long morphologyRuns = 0;         // Ouvertures calculées (chacune sert à toutes les aires minimales)
+    int candidateCount = 0;               // Candidats du premier tour
+    double elapsedSeconds = 0.0;
+    bool cancelled = false;               // Vrai si le jeton a été annulé (résultat à ignorer)
+};
+
+/**
+ * @brief La classe ParameterTuner cherche les paramètres du pipeline qui retrouvent le mieux des composants
+ * annotés à la main (rectangles dessinés dans DrawingWindow / ImageViewer, ou fichiers d'annotations).
+ *
+ * Chaque candidat est noté par le F1 de l'appariement de ses détections avec les annotations (IoU >= minIoU,
+ * voir GroundTruth), cumulé sur les images ; l'IoU moyen départage les égalités.
+ *
+ * Les candidats suivent les dépendances du cache de PcbPipeline : pour une image et un flou (blurKsize,
+ * sigmaX), le flou est calculé une fois, puis chaque CLAHE et son seuillage une fois pour tous les candidats
+ * qui les partagent, chaque fermeture une fois par taille, chaque ouverture une fois par taille, et les
+ * contours une fois pour toutes les aires minimales (un simple filtrage). Les zones sombres ne dépendent
+ * que de l'image et sont calculées une seule fois. Une tâche (image, flou) est confiée à un ThreadPool :
+ * les images et les flous sont traités en parallèle sur tous les cœurs.
+ *
+ * Avec plusieurs images, les candidats sont départagés par réduction successive : au premier tour, tous
+ * sont évalués sur une image, puis seule la meilleure part (1 / halvingFactor) passe au tour suivant, évaluée
+ * sur deux fois plus d'images, et ainsi de suite jusqu'à toutes les images. Indépendante de Qt.
+ */
+class ParameterTuner
+{
+public:
+    explicit ParameterTuner(const TunerOptions& options = TunerOptions());
+
+    /**
+     * @brief Ajoute une image annotée.
+     * @param bgr Image couleur (partagée, ne doit plus être modifiée).
+     * @param annotations Rectangles des composants attendus.
+     */
+    void addSample(const cv::Mat& bgr, const std::vector<cv::Rect>& annotations);
+
+    int sampleCount() const { return static_cast<int>(m_samples.size()); }
+    const TunerOptions& options() const { return m_options; }
+
+    /**
+     * @brief Candidats du premier tour, dans l'ordre de la grille (ou du tirage).
+     */
+    std::vector<PipelineParams> candidates() const;
+
+    /**
+     * @brief Lance la recherche (bloquant).
+     * @param progress Appelé après chaque tâche, depuis un thread du pool (optionnel).
+     * @param token Consulté entre les étapes : une fois annulé, la recherche s'arrête au plus tôt.
+     */
+    TuningResult run(const std::function<void(const TuningProgress&)>& progress = {},
+                     const CancellationToken& token = CancellationToken()) const;
+
+private:
+    struct Sample
+    {
+        cv::Mat image;
+        GroundTruth truth;
+    };
+
+    TunerOptions m_options;
+    std::vector<Sample> m_samples;
+};
+
+#endif // PARAMETERTUNER_H
@@ -0,0 +1,204 @@
+// pcb_batch.cpp
+// Outil en ligne de commande : applique le pipeline de détection à toutes les images d'un répertoire,
+// en parallèle, sans interface graphique. Pour chaque image, il écrit la liste des composants (CSV)
+// et l'image annotée, puis affiche le débit global (images par seconde).
+//
+// Usage : pcb_batch <input_dir> <params_file> <output_dir> [--threads N] [--tiled [--tile-size N]]
+//
+// Avec --tiled (scans de panneaux de plusieurs gigapixels), les images sont traitées une à une et ce sont
+// les tuiles de chaque image qui sont réparties sur les threads (mémoire bornée, voir TiledPipeline).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "imagefiles.h"
+#include "pcbpipeline.h"
+#include "pipelineparams.h"
+#include "threadpool.h"
+#include "tiledpipeline.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Affiche l'aide de la commande
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <input_dir> <params_file> <output_dir> [--threads N] [--tiled [--tile-size N]]\n"
+              << "  input_dir    directory containing board images (.png .jpg .jpeg .bmp .tif .tiff)\n"
+              << "  params_file  pipeline parameters, one 'key = value' per line\n"
+              << "               ('extractor = connected_components' selects connected-component labeling)\n"
+              << "  output_dir   receives <name>_components.csv and <name>_annotated.png per image\n"
+              << "  --threads N  number of worker threads (default: number of cores)\n"
+              << "  --tiled      process one image at a time, split into overlapping tiles (gigapixel scans);\n"
+              << "               annotated images are downscaled previews\n"
+              << "  --tile-size N  tile side in pixels for --tiled (default: 2048)\n";
+}
+
+// Écrit la liste des composants : une ligne par composant (identifiant, boîte englobante, aire)
+bool writeComponentList(const fs::path& path, const DetectionResult& result)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "id,x,y,width,height,area\n";
+    for (int i = 0; i < result.componentCount(); ++i) {
+        const cv::Rect& box = result.rects[i];
+        file << i << ',' << box.x << ',' << box.y << ',' << box.width << ',' << box.height << ','
+             << result.areas[i] << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // --- Lecture des arguments ---
+    std::vector<std::string> positional;
+    unsigned threadCount = 0; // 0 : nombre de cœurs
+    bool tiled = false;
+    TilingOptions tiling;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threadCount = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--tiled") {
+            tiled = true;
+        } else if (arg == "--tile-size" && i + 1 < argc) {
+            tiling.tileSize = std::max(64, std::atoi(argv[++i]));
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 3) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const fs::path inputDir = positional[0];
+    const fs::path outputDir = positional[2];
+
+    PipelineParams params;
+    std::string error;
+    if (!loadPipelineParams(positional[1], params, &error)) {
+        std::cerr << "Error: " << error << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // --- Liste des images à traiter (ordre stable) ---
+    std::error_code ec;
+    if (!fs::is_directory(inputDir, ec)) {
+        std::cerr << "Error: " << inputDir.string() << " is not a directory\n";
+        return EXIT_FAILURE;
+    }
+    std::vector<fs::path> images;
+    // Surcharges avec error_code : un répertoire illisible est signalé au lieu de lever filesystem_error
+    for (fs::directory_iterator it(inputDir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code typeError;
+        if (it->is_regular_file(typeError) && isImageFile(it->path().string())) {
+            images.push_back(it->path());
+        }
+    }
+    if (ec) {
+        std::cerr << "Error: cannot list " << inputDir.string() << ": " << ec.message() << "\n";
+        return EXIT_FAILURE;
+    }
+    std::sort(images.begin(), images.end());
+    if (images.empty()) {
+        std::cerr << "No images found in " << inputDir.string() << "\n";
+        return EXIT_FAILURE;
+    }
+    fs::create_directories(outputDir, ec); // Une seule fois, avant de lancer les threads
+    if (ec) {
+        std::cerr << "Error: cannot create " << outputDir.string() << ": " << ec.message() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // Le parallélisme se fait entre images (ou entre tuiles avec --tiled) : on désactive le parallélisme
+    // interne d'OpenCV pour éviter que chaque thread ne crée à son tour des threads (sur-souscription).
+    cv::setNumThreads(1);
+    tiling.threads = threadCount;
+
+    std::atomic<int> processed(0);
+    std::atomic<int> failed(0);
+    std::atomic<long long> totalComponents(0);
+    std::mutex outputMutex; // Évite que les messages de plusieurs threads ne s'entremêlent
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        // En mode tuilé, une seule image à la fois : ce sont ses tuiles qui occupent les threads
+        ThreadPool pool(tiled ? 1 : threadCount);
+        if (tiled) {
+            std::cout << "Processing " << images.size() << " images one at a time, in tiles of "
+                      << tiling.tileSize << " px...\n";
+        } else {
+            std::cout << "Processing " << images.size() << " images with " << pool.threadCount() << " threads...\n";
+        }
+
+        for (const fs::path& imagePath : images) {
+            pool.submit([&, imagePath]() {
+                try {
+                    cv::Mat image = cv::imread(imagePath.string(), cv::IMREAD_COLOR);
+                    if (image.empty()) {
+                        std::lock_guard<std::mutex> lock(outputMutex);
+                        std::cerr << "  [skip] cannot read " << imagePath.filename().string() << "\n";
+                        ++failed;
+                        return;
+                    }
+
+                    DetectionResult result;
+                    if (tiled) {
+                        result = TiledPipeline::run(image, params, tiling);
+                    } else {
+                        PcbPipeline pipeline; // Un pipeline par tâche : aucun état partagé entre threads
+                        pipeline.setImage(image);
+                        result = pipeline.run(params);
+                    }
+
+                    const std::string stem = imagePath.stem().string();
+                    const bool listOk = writeComponentList(outputDir / (stem + "_components.csv"), result);
+                    const bool imageOk = cv::imwrite((outputDir / (stem + "_annotated.png")).string(), result.contoursImage);
+
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    if (!listOk || !imageOk) {
+                        std::cerr << "  [error] cannot write results for " << imagePath.filename().string() << "\n";
+                        ++failed;
+                        return;
+                    }
+                    std::cout << "  " << imagePath.filename().string() << ": " << result.componentCount() << " components\n";
+                    totalComponents += result.componentCount();
+                    ++processed;
+                } catch (const cv::Exception& e) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::cerr << "  [error] " << imagePath.filename().string() << ": " << e.what() << "\n";
+                    ++failed;
+                }
+            });
+        }
+        pool.waitIdle();
+    } // Le pool est détruit ici : tous les threads sont rejoints
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // --- Bilan ---
+    std::cout << "\nProcessed " << processed.load() << " / " << images.size() << " images"
+              << " (" << failed.load() << " failed), " << totalComponents.load() << " components\n"
+              << "Elapsed: " << seconds << " s, throughput: "
+              << (seconds > 0.0 ? processed.load() / seconds : 0.0) << " images/s\n";
+
+    return failed.load() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
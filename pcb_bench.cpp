@@ -0,0 +1,1065 @@
+// pcb_bench.cpp
+// Micro-benchmark du pipeline de détection : chaque étape de PcbPipeline est chronométrée séparément
+// sur des cartes synthétiques de 1 à 50 mégapixels. Le résultat est affiché en ns/pixel et peut être
+// écrit en JSON pour suivre les régressions d'une version à l'autre.
+//
+// Usage : pcb_bench [--sizes 1,4,12,25,50] [--repeat N] [--params FILE] [--json FILE] [--verify-tiled [TILE]]
+//                   [--verify-kernels] [--compare-extractors] [--verify-morphology] [--allocations]
+//                   [--compare-boards [--budget-ms MS]] [--verify-archive] [--verify-blob-counts]
+//
+// --verify-kernels vérifie que le noyau fusionné niveaux de gris + pixels sombres (bgrkernels) donne,
+// pour chaque jeu d'instructions disponible, exactement cvtColor(BGR2GRAY) et cvtColor(BGR2HSV) + inRange.
+//
+// --verify-morphology vérifie que rectmorphology donne exactement cv::morphologyEx (rectangles de 3 à 101 pixels,
+// ellipse 5x5 des zones sombres) et affiche les durées des deux, pour montrer que le coût ne suit plus le noyau.
+//
+// --allocations simule un glissement de slider (un paramètre différent à chaque passage) et compte les tampons
+// d'image alloués par passage : tampons du pipeline (PipelineWorkspace) et toutes les cv::Mat, y compris celles
+// internes à OpenCV (allocateur comptant). Le premier passage donne le pic, les suivants le régime établi.
+//
+// --compare-boards plante des différences (composants retirés, déplacés, ajoutés) dans une copie tournée et
+// translatée d'une carte, puis vérifie que GoldenBoard retrouve la transformation et les trois listes, et que
+// le recalage et l'appariement tiennent dans le budget (--budget-ms, une seconde par défaut).
+//
+// --compare-extractors chronomètre les deux méthodes d'extraction des composants (findContours et étiquetage
+// en composantes connexes) sur des cartes denses, et vérifie qu'elles trouvent les mêmes boîtes, les mêmes aires
+// et, après filtrage par contourMinArea, les mêmes composants.
+//
+// --verify-blob-counts vérifie que le comptage des contours externes par plages et union-find (blobcounter)
+// donne les mêmes nombres que findContours(RETR_EXTERNAL), pour le masque et son inverse.
+//
+// --verify-archive fait l'aller-retour d'une archive de composants (écriture, réouverture après une écriture
+// interrompue, lecture projetée en mémoire) dans le répertoire temporaire ; --sizes est ignoré.
+//
+// --verify-tiled compare, pour chaque taille, les composants du pipeline par tuiles (TiledPipeline, tuiles
+// de TILE pixels, 512 par défaut pour multiplier les jointures) à ceux du pipeline complet, sans chronométrage.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "bgrkernels.h"
+#include "blobcounter.h"
+#include "boardcomparison.h"
+#include "componentarchive.h"
+#include "pcbpipeline.h"
+#include "pipelineparams.h"
+#include "rectmorphology.h"
+#include "spatialindex.h"
+#include "tiledpipeline.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Mesure d'une étape : temps médian et minimal sur toutes les répétitions.
+ */
+struct StageTiming
+{
+    std::string name;
+    double medianMs = 0.0;
+    double minMs = 0.0;
+    double nsPerPixel = 0.0; // Calculé à partir du temps médian
+};
+
+/**
+ * @brief Résultats pour une taille d'image.
+ */
+struct SizeResult
+{
+    double megapixels = 0.0;
+    int width = 0;
+    int height = 0;
+    int components = 0; // Nombre de composants détectés (contrôle de cohérence entre versions)
+    std::vector<StageTiming> stages;
+};
+
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--sizes 1,4,12,25,50] [--repeat N] [--params FILE] [--json FILE]"
+                 " [--verify-tiled [TILE]] [--verify-kernels] [--compare-extractors] [--verify-morphology]"
+                 " [--allocations] [--compare-boards [--budget-ms MS]] [--verify-archive] [--verify-blob-counts]\n"
+              << "  --sizes   comma-separated image sizes in megapixels (default: 1,4,12,25,50)\n"
+              << "  --repeat  timed runs per stage, the median is reported (default: 5)\n"
+              << "  --params  pipeline parameters file (default: slider defaults)\n"
+              << "  --json    also write the results to FILE as JSON\n"
+              << "  --verify-tiled  check that the tiled pipeline (TILE px tiles, default 512) finds exactly\n"
+              << "                  the same components as the full-image pipeline, then exit\n"
+              << "  --verify-kernels  check that the fused gray/dark-pixel kernel matches cvtColor + inRange\n"
+              << "                    bit for bit on every supported instruction set, then exit\n"
+              << "  --compare-extractors  time findContours against connected-component labeling on dense\n"
+              << "                        boards and check that both find the same boxes and areas and keep\n"
+              << "                        the same components after the contourMinArea filter, then exit\n"
+              << "  --verify-morphology  check that the constant-time morphology matches cv::morphologyEx for\n"
+              << "                       rectangles of 3 to 101 px and the 5x5 ellipse, time both, then exit\n"
+              << "  --allocations  count image buffers allocated per pipeline run during a simulated slider drag\n"
+              << "                 (first run = peak, following runs = steady state), then exit\n"
+              << "  --compare-boards  plant missing, shifted and extra parts in a rotated copy of a board, check that\n"
+              << "                    the golden-board comparison finds them, time registration + diff, then exit\n"
+              << "  --budget-ms MS  fail --compare-boards if registration + diff takes longer than MS (default: 1000,\n"
+              << "                  0 = report the time only)\n"
+              << "  --verify-archive  write a component archive, simulate an interrupted write, append to it again\n"
+              << "                    and read it back through the memory mapping (sizes ignored), then exit\n"
+              << "  --verify-blob-counts  check that the run-length blob counter finds as many external contours as\n"
+              << "                        findContours on thresholded and noise masks and their inverses, then exit\n";
+}
+
+/**
+ * @brief Génère une carte synthétique reproductible : substrat vert bruité, pistes cuivrées,
+ * boîtiers noirs (circuits intégrés) et composants clairs (résistances, condensateurs).
+ * @param megapixels Taille voulue ; le rapport largeur/hauteur est 4:3.
+ * @param partsPerMegapixel Densité des composants.
+ * @param maxPartSide Côté maximal d'un composant (à l'échelle d'une image de 1000 pixels de large).
+ */
+cv::Mat makeSyntheticBoard(double megapixels, int partsPerMegapixel = 200, int maxPartSide = 60)
+{
+    const int width = static_cast<int>(std::lround(std::sqrt(megapixels * 1e6 * 4.0 / 3.0)));
+    const int height = static_cast<int>(std::lround(width * 3.0 / 4.0));
+    cv::RNG rng(0x50CB); // Graine fixe : la même carte à chaque exécution
+
+    cv::Mat board(height, width, CV_8UC3, cv::Scalar(40, 110, 30)); // Vert de vernis épargne (BGR)
+    cv::Mat noise(height, width, CV_8UC3);
+    rng.fill(noise, cv::RNG::NORMAL, cv::Scalar::all(0), cv::Scalar::all(6));
+    board += noise;
+
+    // Pistes : environ une pour 20 000 pixels
+    const int scale = std::max(1, width / 1000);
+    const int traces = static_cast<int>(megapixels * 50);
+    for (int i = 0; i < traces; ++i) {
+        cv::Point a(rng.uniform(0, width), rng.uniform(0, height));
+        cv::Point b = rng.uniform(0, 2) ? cv::Point(rng.uniform(0, width), a.y) : cv::Point(a.x, rng.uniform(0, height));
+        cv::line(board, a, b, cv::Scalar(60, 150, 190), scale);
+    }
+
+    // Composants : par défaut environ 200 par mégapixel, de 10 à 60 pixels de côté (à l'échelle de l'image)
+    const int parts = static_cast<int>(megapixels * partsPerMegapixel);
+    const int minSide = std::min(10, maxPartSide / 2);
+    for (int i = 0; i < parts; ++i) {
+        const int w = rng.uniform(minSide, maxPartSide) * scale;
+        const int h = rng.uniform(minSide, maxPartSide) * scale;
+        const cv::Rect box(rng.uniform(0, std::max(1, width - w)), rng.uniform(0, std::max(1, height - h)), w, h);
+        if (rng.uniform(0, 3) == 0) {
+            cv::rectangle(board, box, cv::Scalar(20, 20, 20), cv::FILLED);       // Boîtier noir
+        } else {
+            cv::rectangle(board, box, cv::Scalar(170, 200, 215), cv::FILLED);    // Composant clair
+        }
+    }
+    return board;
+}
+
+/**
+ * @brief Chronomètre une étape : un passage d'échauffement puis `repeat` passages mesurés.
+ * `prepare` est exécuté avant chaque passage, hors chronométrage (copie des entrées modifiées sur place).
+ */
+StageTiming measureStage(const std::string& name, double pixels, int repeat,
+                         const std::function<void()>& prepare, const std::function<void()>& body)
+{
+    std::vector<double> samples;
+    samples.reserve(repeat);
+    for (int i = 0; i <= repeat; ++i) {
+        prepare();
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i > 0) {
+            samples.push_back(ms); // Le passage 0 sert d'échauffement (caches, allocations)
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+
+    StageTiming timing;
+    timing.name = name;
+    timing.minMs = samples.front();
+    timing.medianMs = samples[samples.size() / 2];
+    timing.nsPerPixel = timing.medianMs * 1e6 / pixels;
+    return timing;
+}
+
+/**
+ * @brief Chronomètre chaque étape du pipeline sur une image, avec les entrées que le pipeline lui donnerait.
+ */
+SizeResult benchmarkSize(double megapixels, const PipelineParams& params, int repeat)
+{
+    const cv::Mat bgr = makeSyntheticBoard(megapixels);
+    const double pixels = static_cast<double>(bgr.total());
+    const auto noPrepare = [] {};
+
+    SizeResult result;
+    result.megapixels = megapixels;
+    result.width = bgr.cols;
+    result.height = bgr.rows;
+
+    // Entrées de référence de chaque étape (calculées une fois, hors chronométrage)
+    const cv::Mat gray = PcbPipeline::toGray(bgr);
+    cv::Mat blurred = gray.clone();
+    PcbPipeline::applyGaussianBlur(blurred, params);
+    cv::Mat preprocessed = blurred.clone();
+    PcbPipeline::applyClahe(preprocessed, params);
+    cv::Mat combined;
+    cv::bitwise_or(PcbPipeline::segment(preprocessed), PcbPipeline::darkAreaMask(bgr), combined);
+    cv::Mat closed = combined.clone();
+    PcbPipeline::applyFillHoles(closed, params);
+    cv::Mat mask = closed.clone();
+    PcbPipeline::applySeparation(mask, params);
+    std::vector<cv::Rect> candidateRects, rects;
+    std::vector<double> candidateAreas, areas;
+    PcbPipeline::findContourCandidates(mask, candidateRects, candidateAreas);
+    PcbPipeline::filterComponents(candidateRects, candidateAreas, params.contourMinArea, bgr.size(), rects, areas);
+    result.components = static_cast<int>(rects.size());
+
+    cv::Mat work; // Copie de travail pour les étapes qui modifient leur entrée
+
+    result.stages.push_back(measureStage("gray", pixels, repeat, noPrepare, [&] {
+        cv::Mat out = PcbPipeline::toGray(bgr);
+    }));
+    result.stages.push_back(measureStage("gaussian_blur", pixels, repeat, [&] { work = gray.clone(); }, [&] {
+        PcbPipeline::applyGaussianBlur(work, params);
+    }));
+    result.stages.push_back(measureStage("clahe", pixels, repeat, [&] { work = blurred.clone(); }, [&] {
+        PcbPipeline::applyClahe(work, params);
+    }));
+    result.stages.push_back(measureStage("adaptive_threshold", pixels, repeat, noPrepare, [&] {
+        cv::Mat thresholded;
+        bool inverted = false;
+        PcbPipeline::segmentByAdaptiveThresholding(preprocessed, thresholded, inverted);
+    }));
+    result.stages.push_back(measureStage("global_threshold", pixels, repeat, noPrepare, [&] {
+        cv::Mat simple, otsu;
+        double otsuThresh = 0.0;
+        PcbPipeline::segmentByGlobalThresholding(preprocessed, simple, otsu, otsuThresh);
+    }));
+    result.stages.push_back(measureStage("dark_mask", pixels, repeat, noPrepare, [&] {
+        cv::Mat out = PcbPipeline::darkAreaMask(bgr);
+    }));
+    result.stages.push_back(measureStage("gray_dark_pixels_fused", pixels, repeat, noPrepare, [&] {
+        cv::Mat g, d;
+        PcbPipeline::toGrayAndDarkPixels(bgr, g, d);
+    }));
+    result.stages.push_back(measureStage("gray_dark_pixels_opencv", pixels, repeat, noPrepare, [&] {
+        cv::Mat g, hsv, d;
+        cv::cvtColor(bgr, g, cv::COLOR_BGR2GRAY);
+        cv::cvtColor(bgr, hsv, cv::COLOR_BGR2HSV);
+        cv::inRange(hsv, cv::Scalar(0, 0, 0), cv::Scalar(180, 255, PcbPipeline::kDarkMaxValue), d);
+    }));
+    result.stages.push_back(measureStage("morphology_fill_holes", pixels, repeat, [&] { work = combined.clone(); }, [&] {
+        PcbPipeline::applyFillHoles(work, params);
+    }));
+    result.stages.push_back(measureStage("morphology_separation", pixels, repeat, [&] { work = closed.clone(); }, [&] {
+        PcbPipeline::applySeparation(work, params);
+    }));
+    result.stages.push_back(measureStage("morphology_separation_opencv", pixels, repeat, [&] { work = closed.clone(); }, [&] {
+        const int k = params.separationKsize * 2 + 1;
+        cv::morphologyEx(work, work, cv::MORPH_OPEN, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(k, k)));
+    }));
+    result.stages.push_back(measureStage("find_contours", pixels, repeat, noPrepare, [&] {
+        std::vector<cv::Rect> r;
+        std::vector<double> a;
+        PcbPipeline::findContourCandidates(mask, r, a);
+    }));
+    result.stages.push_back(measureStage("connected_components", pixels, repeat, noPrepare, [&] {
+        std::vector<cv::Rect> r;
+        std::vector<double> a;
+        PcbPipeline::findConnectedComponentCandidates(mask, r, a);
+    }));
+    result.stages.push_back(measureStage("roi_extraction", pixels, repeat, noPrepare, [&] {
+        // Copie de chaque composant, comme pour les vignettes de la liste
+        for (const cv::Rect& box : rects) {
+            cv::Mat roi = bgr(box).clone();
+        }
+    }));
+    result.stages.push_back(measureStage("render_results", pixels, repeat, noPrepare, [&] {
+        cv::Mat contoursImage, extractedOnBlank;
+        PcbPipeline::renderResults(bgr, rects, contoursImage, extractedOnBlank);
+    }));
+    result.stages.push_back(measureStage("full_pipeline", pixels, repeat, noPrepare, [&] {
+        PcbPipeline pipeline; // Cache vide : toutes les étapes sont recalculées
+        pipeline.setImage(bgr);
+        DetectionResult r = pipeline.run(params);
+    }));
+    result.stages.push_back(measureStage("tiled_pipeline", pixels, repeat, noPrepare, [&] {
+        DetectionResult r = TiledPipeline::run(bgr, params);
+    }));
+    return result;
+}
+
+/**
+ * @brief Compare countExternalBlobs() (plages + union-find) à findContours(RETR_EXTERNAL) sur le masque
+ * et sur son inverse : masque du seuillage adaptatif d'une carte synthétique (celui que compte le pipeline),
+ * bruits uniformes de densités 10 %, 50 % et 90 % (objets imbriqués, contacts en diagonale, bords),
+ * le même bruit ouvert 3x3, puis les masques entièrement vides et entièrement pleins.
+ * @return true si les deux nombres sont identiques pour tous les masques.
+ */
+bool verifyBlobCounts(double megapixels)
+{
+    const cv::Mat bgr = makeSyntheticBoard(megapixels);
+    cv::Mat gray, darkPixels;
+    PcbPipeline::toGrayAndDarkPixels(bgr, gray, darkPixels);
+
+    std::vector<std::pair<std::string, cv::Mat>> masks;
+    cv::Mat adaptive;
+    cv::adaptiveThreshold(gray, adaptive, 255, cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY, 15, 10);
+    masks.emplace_back("adaptive threshold", adaptive);
+    cv::RNG rng(0xB10B);
+    for (int percent : { 10, 50, 90 }) {
+        cv::Mat values(gray.size(), CV_8UC1), noise;
+        rng.fill(values, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(100));
+        cv::compare(values, percent, noise, cv::CMP_LT);
+        masks.emplace_back("noise " + std::to_string(percent) + " %", noise);
+        if (percent == 50) {
+            cv::Mat opened;
+            cv::morphologyEx(noise, opened, cv::MORPH_OPEN, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)));
+            masks.emplace_back("noise 50 %, opened 3x3", opened);
+        }
+    }
+    masks.emplace_back("empty", cv::Mat::zeros(gray.size(), CV_8UC1));
+    masks.emplace_back("full", cv::Mat(gray.size(), CV_8UC1, cv::Scalar(255)));
+
+    auto externalContours = [](const cv::Mat& mask) {
+        std::vector<std::vector<cv::Point>> contours;
+        cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        return contours.size();
+    };
+
+    std::cout << megapixels << " MP (" << gray.cols << "x" << gray.rows << ")\n";
+    bool allIdentical = true;
+    for (const auto& entry : masks) {
+        const cv::Mat& mask = entry.second;
+        cv::Mat inverse;
+        cv::bitwise_not(mask, inverse);
+        const BlobCounts counts = countExternalBlobs(mask);
+        const std::size_t foreground = externalContours(mask);
+        const std::size_t background = externalContours(inverse);
+        const bool identical = counts.foreground == foreground && counts.background == background;
+        std::cout << "  " << std::left << std::setw(24) << entry.first << std::right << std::setw(9) << foreground
+                  << " / " << std::setw(9) << background << (identical ? "  identical\n" : "  MISMATCH (")
+                  << (identical ? "" : std::to_string(counts.foreground) + " / " + std::to_string(counts.background) + ")\n");
+        allIdentical = allIdentical && identical;
+    }
+    return allIdentical;
+}
+
+/**
+ * @brief Compare le noyau fusionné (chaque jeu d'instructions disponible) au chemin OpenCV de référence :
+ * cvtColor(BGR2GRAY) pour les niveaux de gris, cvtColor(BGR2HSV) + inRange pour les pixels sombres.
+ * L'image est une carte synthétique à laquelle on ajoute une colonne (largeur impaire, fin de ligne scalaire)
+ * et une bande de bruit uniforme (toutes les valeurs de B, G, R, dont les voisines du seuil).
+ * @return true si tous les chemins sont identiques à la référence.
+ */
+bool verifyKernels(double megapixels)
+{
+    const cv::Mat board = makeSyntheticBoard(megapixels);
+    cv::Mat bgr(board.rows + 64, board.cols + 1, CV_8UC3, cv::Scalar::all(0));
+    board.copyTo(bgr(cv::Rect(0, 0, board.cols, board.rows)));
+    cv::Mat noise = bgr(cv::Rect(0, board.rows, bgr.cols, 64));
+    cv::RNG rng(0xDA7C);
+    rng.fill(noise, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+
+    cv::Mat expectedGray, hsv, expectedDark;
+    cv::cvtColor(bgr, expectedGray, cv::COLOR_BGR2GRAY);
+    cv::cvtColor(bgr, hsv, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv, cv::Scalar(0, 0, 0), cv::Scalar(180, 255, PcbPipeline::kDarkMaxValue), expectedDark);
+
+    bool allIdentical = true;
+    for (SimdPath path : { SimdPath::Scalar, SimdPath::Ssse3, SimdPath::Avx2 }) {
+        std::cout << megapixels << " MP (" << bgr.cols << "x" << bgr.rows << "), " << simdPathName(path) << ": ";
+        if (!isSimdPathSupported(path)) {
+            std::cout << "not supported on this CPU, skipped\n";
+            continue;
+        }
+        cv::Mat gray, dark;
+        bgrToGrayAndDarkPixels(bgr, &gray, &dark, PcbPipeline::kDarkMaxValue, path);
+        const int grayDiff = cv::countNonZero(gray != expectedGray);
+        const int darkDiff = cv::countNonZero(dark != expectedDark);
+        if (grayDiff == 0 && darkDiff == 0) {
+            std::cout << "identical\n";
+        } else {
+            std::cout << "MISMATCH (" << grayDiff << " gray pixels, " << darkDiff << " dark-mask pixels differ)\n";
+            allIdentical = false;
+        }
+    }
+    return allIdentical;
+}
+
+/**
+ * @brief Allocateur de cv::Mat qui compte les tampons alloués et délègue à l'allocateur standard d'OpenCV.
+ * Installé comme allocateur par défaut par --allocations : il voit aussi les images temporaires d'OpenCV.
+ */
+class CountingMatAllocator : public cv::MatAllocator
+{
+public:
+    CountingMatAllocator() : m_std(cv::Mat::getStdAllocator()) {}
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override
+    {
+        if (!data) { // Un tampon fourni par l'appelant n'est pas une allocation
+            size_t bytes = CV_ELEM_SIZE(type);
+            for (int i = 0; i < dims; ++i) bytes *= static_cast<size_t>(sizes[i]);
+            ++m_count;
+            m_bytes += bytes;
+        }
+        return m_std->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return m_std->allocate(data, flags, usageFlags);
+    }
+    void deallocate(cv::UMatData* data) const override { m_std->deallocate(data); }
+
+    size_t count() const { return m_count; }
+    size_t bytes() const { return m_bytes; }
+
+private:
+    cv::MatAllocator* m_std;
+    mutable std::atomic<size_t> m_count{0};
+    mutable std::atomic<size_t> m_bytes{0};
+};
+
+/**
+ * @brief Compte les allocations par passage pendant un glissement de slider simulé : chaque passage change
+ * un paramètre (aire minimale, séparation, CLAHE, flou, à tour de rôle), comme le ferait l'interface.
+ * Deux scénarios : le résultat est lâché aussitôt (outil en ligne de commande), ou le résultat précédent
+ * reste détenu pendant le passage suivant (affichage de l'interface), ce qui empêche de réutiliser ses images.
+ */
+void reportAllocations(double megapixels, const PipelineParams& base, int runs)
+{
+    const cv::Mat bgr = makeSyntheticBoard(megapixels);
+    CountingMatAllocator counter;
+    cv::MatAllocator* previousAllocator = cv::Mat::getDefaultAllocator();
+    cv::Mat::setDefaultAllocator(&counter);
+
+    std::cout << megapixels << " MP (" << bgr.cols << "x" << bgr.rows << "), " << runs << " runs\n"
+              << "  " << std::left << std::setw(16) << "scenario" << std::right << std::setw(18) << "first run"
+              << std::setw(22) << "steady state (median)" << "\n";
+    for (bool holdPrevious : { false, true }) {
+        PcbPipeline pipeline;
+        pipeline.setImage(bgr);
+        DetectionResult held;
+        std::vector<size_t> buffers, mats, megabytes;
+        for (int i = 0; i < runs; ++i) {
+            PipelineParams params = base;
+            switch (i % 4) { // Un paramètre différent à chaque passage, jamais deux fois la même valeur de suite
+            case 0: params.contourMinArea += i; break;
+            case 1: params.separationKsize += (i / 4) % 2; break;
+            case 2: params.claheClipLimit += (i / 4) % 2 + 1; break;
+            default: params.blurKsize += (i / 4) % 2; break;
+            }
+            const size_t countBefore = counter.count(), bytesBefore = counter.bytes();
+            DetectionResult result = pipeline.run(params);
+            if (holdPrevious) {
+                held = result; // Affiché jusqu'au passage suivant
+            }
+            result = DetectionResult();
+            buffers.push_back(pipeline.workspace().stats().lastRunAllocations);
+            mats.push_back(counter.count() - countBefore);
+            megabytes.push_back((counter.bytes() - bytesBefore) >> 20);
+        }
+        auto steady = [](std::vector<size_t> values) {
+            values.erase(values.begin()); // Le premier passage est le pic
+            std::sort(values.begin(), values.end());
+            return values.empty() ? size_t(0) : values[values.size() / 2];
+        };
+        auto cell = [](size_t buffersCount, size_t matsCount, size_t mb) {
+            std::ostringstream text;
+            text << buffersCount << "/" << matsCount << " (" << mb << " MB)";
+            return text.str();
+        };
+        std::cout << "  " << std::left << std::setw(16) << (holdPrevious ? "result held" : "result dropped")
+                  << std::right << std::setw(18) << cell(buffers.front(), mats.front(), megabytes.front())
+                  << std::setw(22) << cell(steady(buffers), steady(mats), steady(megabytes)) << "\n";
+    }
+    std::cout << "  (pipeline buffers / all cv::Mat allocations per run)\n";
+    cv::Mat::setDefaultAllocator(previousAllocator);
+}
+
+/**
+ * @brief Compare rectmorphology à cv::morphologyEx sur le masque combiné d'une carte (avant fermeture),
+ * pour des rectangles de plus en plus grands et pour la fermeture des zones sombres (ellipse 5x5, 3 fois).
+ * @return true si tous les résultats sont identiques.
+ */
+bool verifyMorphology(double megapixels, int repeat)
+{
+    const cv::Mat bgr = makeSyntheticBoard(megapixels);
+    cv::Mat gray, darkPixels;
+    PcbPipeline::toGrayAndDarkPixels(bgr, gray, darkPixels);
+    cv::Mat mask;
+    cv::bitwise_or(PcbPipeline::segment(gray), darkPixels, mask);
+    const double pixels = static_cast<double>(mask.total());
+    const auto noPrepare = [] {};
+
+    std::cout << megapixels << " MP (" << mask.cols << "x" << mask.rows << ")\n"
+              << "  " << std::left << std::setw(22) << "operation" << std::right << std::setw(14) << "opencv ms"
+              << std::setw(14) << "vHGW ms" << "\n";
+    bool allIdentical = true;
+    auto check = [&](const std::string& name, const std::function<void(cv::Mat&)>& reference,
+                     const std::function<void(cv::Mat&)>& engine) {
+        cv::Mat expected, actual;
+        const StageTiming opencv = measureStage(name, pixels, repeat, noPrepare, [&] { reference(expected); });
+        const StageTiming fast = measureStage(name, pixels, repeat, noPrepare, [&] { engine(actual); });
+        const int diff = cv::countNonZero(expected != actual);
+        std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << opencv.medianMs << std::setw(14) << fast.medianMs
+                  << (diff == 0 ? "  identical\n" : "  MISMATCH (" + std::to_string(diff) + " pixels)\n");
+        std::cout.unsetf(std::ios::fixed);
+        allIdentical = allIdentical && diff == 0;
+    };
+    for (int k : { 3, 5, 7, 11, 21, 51, 101 }) {
+        for (cv::MorphTypes op : { cv::MORPH_OPEN, cv::MORPH_CLOSE }) {
+            const std::string name = std::string(op == cv::MORPH_OPEN ? "open " : "close ") + std::to_string(k) + "x" + std::to_string(k);
+            check(name, [&](cv::Mat& out) {
+                cv::morphologyEx(mask, out, op, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(k, k)));
+            }, [&](cv::Mat& out) {
+                morphologyRect(mask, out, op, cv::Size(k, k));
+            });
+        }
+    }
+    check("dark close ellipse x3", [&](cv::Mat& out) {
+        cv::morphologyEx(darkPixels, out, cv::MORPH_CLOSE, cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5)),
+                         cv::Point(-1, -1), 3);
+    }, [&](cv::Mat& out) {
+        morphologyEllipse5x5(darkPixels, out, cv::MORPH_CLOSE, 3);
+    });
+    return allIdentical;
+}
+
+/**
+ * @brief Vérifie la comparaison à une carte de référence (GoldenBoard) sur une carte synthétique.
+ * L'image testée est la référence dont on a retiré, déplacé (de 12 x 9 px) et ajouté quelques composants isolés,
+ * puis tournée de 0,4 degré et translatée de (25.5, -17.25) px. On vérifie que le recalage retrouve cette
+ * transformation (à moins d'un demi-pixel aux coins) et que les composants plantés sont dans les bonnes listes ;
+ * la durée médiane du recalage et de l'appariement (détection exclue) doit aussi tenir dans le budget
+ * (une seconde pour une carte de 20 MP, voir --budget-ms).
+ * @param budgetMs Durée médiane maximale en millisecondes (0 : durée affichée sans être vérifiée).
+ * @return true si la transformation et les trois listes sont retrouvées dans le budget.
+ */
+bool compareBoards(double megapixels, const PipelineParams& params, int repeat, double budgetMs)
+{
+    // Densité réduite à l'échelle de l'image : composants isolés, comme sur une vraie carte
+    const int scale = std::max(1, static_cast<int>(std::lround(std::sqrt(megapixels * 1e6 * 4.0 / 3.0))) / 1000);
+    const cv::Mat reference = makeSyntheticBoard(megapixels, std::max(8, 200 / (scale * scale)));
+    const cv::Scalar background(40, 110, 30);
+    PcbPipeline pipeline;
+    pipeline.setImage(reference);
+    const std::vector<cv::Rect> referenceRects = pipeline.run(params).rects;
+
+    // Composants isolés (aucun autre à moins de 40 px) et loin des bords : ceux que l'on modifie
+    const int margin = 40;
+    SpatialIndex index(128);
+    for (size_t i = 0; i < referenceRects.size(); ++i) {
+        index.insert(static_cast<int>(i), referenceRects[i]);
+    }
+    const cv::Rect inside(4 * margin, 4 * margin, reference.cols - 8 * margin, reference.rows - 8 * margin);
+    std::vector<int> isolated;
+    for (size_t i = 0; i < referenceRects.size() && isolated.size() < 6; ++i) {
+        const cv::Rect around = referenceRects[i] + cv::Size(2 * margin, 2 * margin) - cv::Point(margin, margin);
+        if ((around & inside) == around && index.queryRect(around).size() == 1) {
+            isolated.push_back(static_cast<int>(i));
+        }
+    }
+    if (isolated.size() < 6) {
+        std::cout << megapixels << " MP: not enough isolated components to plant differences\n";
+        return false;
+    }
+
+    cv::Mat modified = reference.clone();
+    const std::vector<int> removed = { isolated[0], isolated[1] };
+    const std::vector<int> moved = { isolated[2], isolated[3] };
+    const cv::Point shift(12, 9);
+    for (int i : removed) {
+        modified(referenceRects[i] + cv::Size(4, 4) - cv::Point(2, 2)).setTo(background);
+    }
+    for (int i : moved) {
+        const cv::Rect area = referenceRects[i] + cv::Size(4, 4) - cv::Point(2, 2);
+        const cv::Mat part = reference(area).clone();
+        modified(area).setTo(background);
+        part.copyTo(modified(area + shift));
+    }
+    // Ajouts : copies des deux derniers composants isolés dans une zone vide
+    cv::RNG rng(0xADD);
+    std::vector<cv::Point2d> addedCenters;
+    for (int k = 4; k < 6; ++k) {
+        const cv::Rect source = referenceRects[isolated[k]];
+        for (int attempt = 0; attempt < 10000; ++attempt) {
+            const cv::Rect target(rng.uniform(inside.x, inside.x + inside.width - source.width),
+                                  rng.uniform(inside.y, inside.y + inside.height - source.height),
+                                  source.width, source.height);
+            const cv::Rect around = target + cv::Size(2 * margin, 2 * margin) - cv::Point(margin, margin);
+            if (index.queryRect(around).empty()) {
+                reference(source).copyTo(modified(target));
+                index.insert(static_cast<int>(referenceRects.size() + addedCenters.size()), target);
+                addedCenters.emplace_back(target.x + target.width / 2.0, target.y + target.height / 2.0);
+                break;
+            }
+        }
+    }
+
+    cv::Mat truth = cv::getRotationMatrix2D(cv::Point2f(reference.cols / 2.0f, reference.rows / 2.0f), 0.4, 1.0);
+    truth.at<double>(0, 2) += 25.5;
+    truth.at<double>(1, 2) -= 17.25;
+    cv::Mat test;
+    cv::warpAffine(modified, test, truth, reference.size(), cv::INTER_LINEAR, cv::BORDER_CONSTANT, background);
+    pipeline.setImage(test);
+    const std::vector<cv::Rect> testRects = pipeline.run(params).rects;
+
+    GoldenBoard golden;
+    golden.setReference(reference, referenceRects);
+    std::vector<double> times;
+    BoardComparison comparison;
+    for (int r = 0; r < repeat; ++r) {
+        comparison = golden.compare(test, testRects);
+        times.push_back(comparison.registrationMs + comparison.diffMs);
+    }
+    std::sort(times.begin(), times.end());
+
+    // Écart entre la transformation trouvée et la vraie, aux quatre coins
+    const cv::Matx23d expected(truth.ptr<double>());
+    double registrationError = 0.0;
+    for (const cv::Point2d corner : { cv::Point2d(0, 0), cv::Point2d(reference.cols, 0),
+                                      cv::Point2d(0, reference.rows), cv::Point2d(reference.cols, reference.rows) }) {
+        const cv::Matx31d p(corner.x, corner.y, 1.0);
+        const cv::Matx21d found = comparison.registration.referenceToTest * p, wanted = expected * p;
+        registrationError = std::max(registrationError, std::hypot(found(0) - wanted(0), found(1) - wanted(1)));
+    }
+    auto contains = [](const std::vector<int>& list, int value) {
+        return std::find(list.begin(), list.end(), value) != list.end();
+    };
+    bool found = registrationError < 0.5;
+    for (int i : removed) {
+        found = contains(comparison.missing, i) && found;
+    }
+    for (int i : moved) {
+        found = std::any_of(comparison.shifted.begin(), comparison.shifted.end(),
+                            [&](const ComponentPair& pair) { return pair.reference == i; }) && found;
+    }
+    for (const cv::Point2d& center : addedCenters) {
+        found = std::any_of(comparison.extra.begin(), comparison.extra.end(), [&](int j) {
+            const cv::Rect& box = testRects[j];
+            const cv::Matx21d inReference = comparison.registration.testToReference
+                                            * cv::Matx31d(box.x + box.width / 2.0, box.y + box.height / 2.0, 1.0);
+            return std::hypot(inReference(0) - center.x, inReference(1) - center.y) < 3.0;
+        }) && found;
+    }
+
+    std::cout << megapixels << " MP (" << reference.cols << "x" << reference.rows << "), "
+              << referenceRects.size() << " / " << testRects.size() << " components: "
+              << "angle " << std::fixed << std::setprecision(3) << comparison.registration.angleDegrees()
+              << " deg, error " << registrationError << " px, phase response "
+              << std::setprecision(2) << comparison.registration.phaseResponse
+              << (comparison.registration.refined ? "" : " (ECC did not converge)") << "\n"
+              << "  missing " << comparison.missing.size() << ", extra " << comparison.extra.size()
+              << ", shifted " << comparison.shifted.size() << ", matched " << comparison.matched.size()
+              << " (planted: 2 / 2 / 2) -> " << (found ? "found" : "NOT FOUND") << "\n";
+    const double medianMs = times[times.size() / 2];
+    const bool inBudget = budgetMs <= 0.0 || medianMs <= budgetMs;
+    std::cout << "  registration + diff: " << std::setprecision(1) << medianMs << " ms median";
+    if (budgetMs > 0.0) {
+        std::cout << (inBudget ? " (budget " : " -> OVER BUDGET (") << budgetMs << " ms)";
+    }
+    std::cout << "\n";
+    std::cout.unsetf(std::ios::fixed);
+    return found && inBudget;
+}
+
+/**
+ * @brief Compare les deux méthodes d'extraction sur le masque final d'une carte dense (environ 2000 petits
+ * composants par mégapixel) : durée médiane de chacune, nombre d'objets, identité des boîtes et des aires,
+ * puis identité des composants retenus par filterComponents() avec le même contourMinArea.
+ * @return true si les deux méthodes donnent exactement les mêmes candidats et les mêmes composants filtrés.
+ */
+bool compareExtractors(double megapixels, const PipelineParams& params, int repeat)
+{
+    const cv::Mat bgr = makeSyntheticBoard(megapixels, 2000, 16);
+    PcbPipeline pipeline;
+    pipeline.setImage(bgr);
+    const cv::Mat mask = pipeline.run(params).mask;
+    const double pixels = static_cast<double>(mask.total());
+    const auto noPrepare = [] {};
+
+    std::vector<cv::Rect> contourRects, labelRects;
+    std::vector<double> contourAreas, labelAreas;
+    const StageTiming contours = measureStage("find_contours", pixels, repeat, noPrepare, [&] {
+        PcbPipeline::findContourCandidates(mask, contourRects, contourAreas);
+    });
+    const StageTiming labels = measureStage("connected_components", pixels, repeat, noPrepare, [&] {
+        PcbPipeline::findConnectedComponentCandidates(mask, labelRects, labelAreas);
+    });
+
+    // Les deux méthodes ne rendent pas les objets dans le même ordre : tri par boîte avant comparaison
+    using Entry = std::pair<std::vector<int>, double>;
+    auto sortedEntries = [](const std::vector<cv::Rect>& rects, const std::vector<double>& areas) {
+        std::vector<Entry> entries;
+        for (size_t i = 0; i < rects.size(); ++i) {
+            entries.push_back(Entry({ rects[i].y, rects[i].x, rects[i].width, rects[i].height }, areas[i]));
+        }
+        std::sort(entries.begin(), entries.end());
+        return entries;
+    };
+    const std::vector<Entry> expected = sortedEntries(contourRects, contourAreas);
+    const std::vector<Entry> actual = sortedEntries(labelRects, labelAreas);
+    bool sameBoxes = expected.size() == actual.size();
+    size_t areaMismatches = 0;
+    for (size_t i = 0; sameBoxes && i < expected.size(); ++i) {
+        sameBoxes = expected[i].first == actual[i].first;
+        if (expected[i].second != actual[i].second) ++areaMismatches; // Demi-entiers : comparaison exacte
+    }
+
+    // Ce que voit l'utilisateur : les composants qui passent le filtre d'aire
+    std::vector<cv::Rect> keptContourRects, keptLabelRects;
+    std::vector<double> keptContourAreas, keptLabelAreas;
+    PcbPipeline::filterComponents(contourRects, contourAreas, params.contourMinArea, mask.size(),
+                                  keptContourRects, keptContourAreas);
+    PcbPipeline::filterComponents(labelRects, labelAreas, params.contourMinArea, mask.size(),
+                                  keptLabelRects, keptLabelAreas);
+    const bool sameFiltered = sortedEntries(keptContourRects, keptContourAreas) == sortedEntries(keptLabelRects, keptLabelAreas);
+
+    std::cout << megapixels << " MP (" << mask.cols << "x" << mask.rows << "), " << expected.size()
+              << " contours, " << actual.size() << " labeled components\n" << std::fixed << std::setprecision(2)
+              << "  find_contours         " << std::setw(10) << contours.medianMs << " ms\n"
+              << "  connected_components  " << std::setw(10) << labels.medianMs << " ms  (x"
+              << contours.medianMs / std::max(labels.medianMs, 1e-6) << ")\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << (sameBoxes ? "  -> identical boxes" : "  -> MISMATCH in boxes")
+              << (areaMismatches == 0 ? ", identical areas\n" : ", MISMATCH in " + std::to_string(areaMismatches) + " areas\n")
+              << "  -> " << keptContourRects.size() << " / " << keptLabelRects.size() << " components above "
+              << params.contourMinArea << (sameFiltered ? ": identical\n" : ": MISMATCH\n");
+    return sameBoxes && areaMismatches == 0 && sameFiltered;
+}
+
+/**
+ * @brief Compare les composants (boîtes et aires) du pipeline par tuiles à ceux du pipeline complet.
+ * L'ordre des composants diffère entre les deux : les listes sont triées avant la comparaison.
+ * @return true si les deux listes sont identiques.
+ */
+bool verifyTiled(double megapixels, const PipelineParams& params, int tileSize)
+{
+    const cv::Mat bgr = makeSyntheticBoard(megapixels);
+
+    PcbPipeline pipeline;
+    pipeline.setImage(bgr);
+    const DetectionResult full = pipeline.run(params);
+    TilingOptions options;
+    options.tileSize = tileSize;
+    const DetectionResult tiled = TiledPipeline::run(bgr, params, options);
+
+    using Entry = std::pair<std::vector<int>, double>;
+    auto sortedEntries = [](const DetectionResult& r) {
+        std::vector<Entry> entries;
+        for (size_t i = 0; i < r.rects.size(); ++i) {
+            const cv::Rect& box = r.rects[i];
+            entries.push_back(Entry({ box.y, box.x, box.width, box.height }, r.areas[i]));
+        }
+        std::sort(entries.begin(), entries.end());
+        return entries;
+    };
+    const std::vector<Entry> expected = sortedEntries(full);
+    const std::vector<Entry> actual = sortedEntries(tiled);
+
+    std::cout << megapixels << " MP (" << bgr.cols << "x" << bgr.rows << "), tiles of " << tileSize << " px: "
+              << expected.size() << " components (full), " << actual.size() << " (tiled)";
+    if (expected == actual) {
+        std::cout << " -> identical\n";
+        return true;
+    }
+    size_t mismatches = 0;
+    for (const Entry& e : expected) {
+        if (!std::binary_search(actual.begin(), actual.end(), e)) ++mismatches;
+    }
+    std::cout << " -> MISMATCH (" << mismatches << " components of the full run not found)\n";
+    return false;
+}
+
+/**
+ * @brief Aller-retour complet d'une archive de composants (ComponentArchiveWriter / ComponentArchiveReader)
+ * dans le répertoire temporaire : création avec des blocs bruts (ROI non contiguës) et un bloc PNG,
+ * écriture interrompue simulée (entrée d'index et bloc de données incomplets en fin de fichier), réouverture
+ * en ajout qui doit écarter l'entrée tronquée, puis lecture par projection mémoire. Chaque composant relu doit
+ * redonner exactement ses pixels et sa boîte, et les blocs bruts doivent être alignés sur 64 octets.
+ * Enfin, create() doit repartir d'une archive vide.
+ * @return true si toutes les vérifications réussissent.
+ */
+bool verifyArchive()
+{
+    const cv::Mat board = makeSyntheticBoard(0.25);
+    const std::string basePath = (fs::temp_directory_path()
+        / ("pcb_bench_archive_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))).string();
+    const std::vector<cv::Rect> boxes = { { 0, 0, 37, 21 }, { 100, 50, 64, 64 }, { 213, 97, 1, 45 },
+                                          { 300, 200, 90, 33 }, { 17, 250, 45, 12 } };
+    bool ok = true;
+    auto check = [&ok](bool condition, const std::string& what) {
+        if (!condition) {
+            std::cout << "  MISMATCH: " << what << "\n";
+            ok = false;
+        }
+    };
+
+    // 1. Nouvelle archive : trois blocs bruts et un bloc PNG
+    {
+        ComponentArchiveWriter writer;
+        std::string error;
+        check(writer.create(basePath, &error), "create: " + error);
+        for (int i = 0; i < 3; ++i) {
+            check(writer.appendRaw(i, boxes[i], 10.0 * i, board(boxes[i])), "append raw " + std::to_string(i));
+        }
+        std::vector<unsigned char> png;
+        check(cv::imencode(".png", board(boxes[3]), png), "PNG encoding");
+        check(writer.appendEncoded(3, boxes[3], 30.0, board.type(), ArchiveEncoding::Png, png), "append PNG");
+    }
+
+    // 2. Écriture interrompue : bloc de données et entrée d'index incomplets
+    {
+        const char garbage[sizeof(ComponentRecord) / 2] = { 1, 2, 3, 4, 5 };
+        std::ofstream(ComponentArchiveWriter::dataPath(basePath), std::ios::binary | std::ios::app).write(garbage, 19);
+        std::ofstream(ComponentArchiveWriter::indexPath(basePath), std::ios::binary | std::ios::app)
+            .write(garbage, sizeof(garbage));
+    }
+
+    // 3. Réouverture en ajout : l'entrée tronquée est écartée, le bloc suivant est réaligné
+    {
+        ComponentArchiveWriter writer;
+        std::string error;
+        check(writer.open(basePath, &error), "reopen: " + error);
+        check(writer.appendRaw(4, boxes[4], 40.0, board(boxes[4])), "append raw after reopen");
+    }
+
+    // 4. Lecture par projection mémoire
+    {
+        ComponentArchiveReader reader;
+        std::string error;
+        check(reader.open(basePath, &error), "open for reading: " + error);
+        check(reader.count() == boxes.size(), std::to_string(reader.count()) + " records instead of "
+                                               + std::to_string(boxes.size()));
+        for (std::size_t i = 0; i < std::min(reader.count(), boxes.size()); ++i) {
+            const ComponentRecord& record = reader.record(i);
+            const cv::Rect box(record.x, record.y, record.width, record.height);
+            check(record.id == i && box == boxes[i] && record.area == 10.0 * i, "record " + std::to_string(i));
+            const cv::Mat pixels = reader.roi(i);
+            const cv::Mat expected = board(boxes[i]);
+            const bool samePixels = pixels.size() == expected.size() && pixels.type() == expected.type()
+                                    && cv::norm(pixels, expected, cv::NORM_INF) == 0.0;
+            check(samePixels, "pixels of record " + std::to_string(i));
+            if (record.encoding == static_cast<std::uint32_t>(ArchiveEncoding::Raw)) {
+                check(record.offset % 64 == 0 && reinterpret_cast<std::uintptr_t>(pixels.data) % 64 == 0,
+                      "alignment of record " + std::to_string(i));
+            }
+        }
+    }
+
+    // 5. create() remplace l'archive existante
+    {
+        ComponentArchiveWriter writer;
+        check(writer.create(basePath) && writer.appendRaw(0, boxes[0], 0.0, board(boxes[0])), "recreate");
+        writer.close();
+        ComponentArchiveReader reader;
+        check(reader.open(basePath) && reader.count() == 1, "recreated archive does not start empty");
+    }
+
+    std::error_code ec;
+    fs::remove(ComponentArchiveWriter::dataPath(basePath), ec);
+    fs::remove(ComponentArchiveWriter::indexPath(basePath), ec);
+    std::cout << "Component archive (write, reopen after an interrupted write, mapped read, recreate): "
+              << (ok ? "identical\n" : "MISMATCH\n");
+    return ok;
+}
+
+/**
+ * @brief Écrit les résultats en JSON (un objet par taille, un objet par étape).
+ */
+bool writeJson(const std::string& path, const std::vector<SizeResult>& results, const PipelineParams& params, int repeat)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << std::fixed << std::setprecision(4);
+    file << "{\n"
+         << "  \"benchmark\": \"pcb_bench\",\n"
+         << "  \"opencv_version\": \"" << CV_VERSION << "\",\n"
+         << "  \"opencv_threads\": " << cv::getNumThreads() << ",\n"
+         << "  \"repeat\": " << repeat << ",\n"
+         << "  \"params\": {\"blurKsize\": " << params.blurKsize << ", \"sigmaX\": " << params.sigmaX
+         << ", \"claheClipLimit\": " << params.claheClipLimit << ", \"separationKsize\": " << params.separationKsize
+         << ", \"fillHolesKsize\": " << params.fillHolesKsize << ", \"contourMinArea\": " << params.contourMinArea
+         << ", \"extractor\": \"" << componentExtractorName(params.extractor) << "\"},\n"
+         << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SizeResult& r = results[i];
+        file << "    {\"megapixels\": " << r.megapixels << ", \"width\": " << r.width << ", \"height\": " << r.height
+             << ", \"components\": " << r.components << ", \"stages\": [\n";
+        for (size_t s = 0; s < r.stages.size(); ++s) {
+            const StageTiming& t = r.stages[s];
+            file << "      {\"name\": \"" << t.name << "\", \"median_ms\": " << t.medianMs << ", \"min_ms\": " << t.minMs
+                 << ", \"ns_per_pixel\": " << t.nsPerPixel << "}" << (s + 1 < r.stages.size() ? "," : "") << "\n";
+        }
+        file << "    ]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<double> sizes = { 1, 4, 12, 25, 50 };
+    int repeat = 5;
+    std::string jsonPath;
+    int verifyTileSize = 0; // > 0 : mode --verify-tiled
+    bool verifyKernelsOnly = false;
+    bool compareExtractorsOnly = false;
+    bool verifyMorphologyOnly = false;
+    bool allocationsOnly = false;
+    bool compareBoardsOnly = false;
+    double budgetMs = 1000.0; // Budget du recalage + appariement de --compare-boards
+    bool verifyArchiveOnly = false;
+    bool verifyBlobCountsOnly = false;
+    PipelineParams params;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            sizes.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                const double mp = std::atof(item.c_str());
+                if (mp > 0.0) sizes.push_back(mp);
+            }
+        } else if (arg == "--repeat" && hasValue) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--verify-kernels") {
+            verifyKernelsOnly = true;
+        } else if (arg == "--compare-extractors") {
+            compareExtractorsOnly = true;
+        } else if (arg == "--verify-morphology") {
+            verifyMorphologyOnly = true;
+        } else if (arg == "--allocations") {
+            allocationsOnly = true;
+        } else if (arg == "--compare-boards") {
+            compareBoardsOnly = true;
+        } else if (arg == "--budget-ms" && hasValue) {
+            budgetMs = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--verify-archive") {
+            verifyArchiveOnly = true;
+        } else if (arg == "--verify-blob-counts") {
+            verifyBlobCountsOnly = true;
+        } else if (arg == "--verify-tiled") {
+            verifyTileSize = 512;
+            if (hasValue && std::atoi(argv[i + 1]) > 0) {
+                verifyTileSize = std::max(64, std::atoi(argv[++i]));
+            }
+        } else if (arg == "--params" && hasValue) {
+            std::string error;
+            if (!loadPipelineParams(argv[++i], params, &error)) {
+                std::cerr << "Error: " << error << "\n";
+                return EXIT_FAILURE;
+            }
+        } else {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (sizes.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (verifyArchiveOnly) {
+        return verifyArchive() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (verifyBlobCountsOnly) {
+        bool allIdentical = true;
+        for (double mp : sizes) {
+            allIdentical = verifyBlobCounts(mp) && allIdentical;
+        }
+        return allIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (verifyKernelsOnly) {
+        bool allIdentical = true;
+        for (double mp : sizes) {
+            allIdentical = verifyKernels(mp) && allIdentical;
+        }
+        return allIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (compareBoardsOnly) {
+        bool allFound = true;
+        for (double mp : sizes) {
+            allFound = compareBoards(mp, params, repeat, budgetMs) && allFound;
+        }
+        return allFound ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (allocationsOnly) {
+        for (double mp : sizes) {
+            reportAllocations(mp, params, std::max(8, repeat * 4));
+        }
+        return EXIT_SUCCESS;
+    }
+    if (verifyMorphologyOnly) {
+        bool allIdentical = true;
+        for (double mp : sizes) {
+            allIdentical = verifyMorphology(mp, repeat) && allIdentical;
+        }
+        return allIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (compareExtractorsOnly) {
+        bool allIdentical = true;
+        for (double mp : sizes) {
+            allIdentical = compareExtractors(mp, params, repeat) && allIdentical;
+        }
+        return allIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (verifyTileSize > 0) {
+        bool allIdentical = true;
+        for (double mp : sizes) {
+            allIdentical = verifyTiled(mp, params, verifyTileSize) && allIdentical;
+        }
+        return allIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::cout << "OpenCV " << CV_VERSION << ", " << cv::getNumThreads() << " threads, median of "
+              << repeat << " runs\n";
+
+    std::vector<SizeResult> results;
+    for (double mp : sizes) {
+        SizeResult r = benchmarkSize(mp, params, repeat);
+        std::cout << "\n" << r.megapixels << " MP (" << r.width << "x" << r.height << "), "
+                  << r.components << " components\n";
+        std::cout << "  " << std::left << std::setw(24) << "stage" << std::right << std::setw(12) << "median ms"
+                  << std::setw(12) << "ns/pixel" << "\n";
+        for (const StageTiming& t : r.stages) {
+            std::cout << "  " << std::left << std::setw(24) << t.name << std::right << std::fixed
+                      << std::setprecision(2) << std::setw(12) << t.medianMs
+                      << std::setprecision(3) << std::setw(12) << t.nsPerPixel << "\n";
+        }
+        std::cout.unsetf(std::ios::fixed);
+        results.push_back(r);
+    }
+
+    if (!jsonPath.empty()) {
+        if (!writeJson(jsonPath, results, params, repeat)) {
+            std::cerr << "Error: cannot write " << jsonPath << "\n";
+            return EXIT_FAILURE;
+        }
+        std::cout << "\nResults written to " << jsonPath << "\n";
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+// pcb_compare.cpp
+// Outil en ligne de commande : compare une carte à une carte de référence (« golden board »). Les composants
+// sont détectés sur les deux images avec les mêmes paramètres, l'image testée est recalée sur la référence
+// (GoldenBoard), puis les composants manquants, en trop et décalés sont listés.
+//
+// Usage : pcb_compare <reference_image> <test_image> [--params FILE] [--overlay FILE] [--csv FILE]
+//                     [--position-tolerance PX] [--search-radius PX] [--size-tolerance R] [--translation-only]
+//
+// Code de retour : 0 si les cartes sont identiques, 2 s'il y a des différences, 1 en cas d'erreur.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "boardcomparison.h"
+#include "pcbpipeline.h"
+#include "pipelineparams.h"
+
+namespace {
+
+// Affiche l'aide de la commande
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <reference_image> <test_image> [--params FILE] [--overlay FILE] [--csv FILE]\n"
+                 "       [--position-tolerance PX] [--search-radius PX] [--size-tolerance R] [--translation-only]\n"
+              << "  reference_image  known-good board\n"
+              << "  test_image       board to inspect (same camera setup, about the same size)\n"
+              << "  --params FILE    pipeline parameters, one 'key = value' per line (default: slider defaults)\n"
+              << "  --overlay FILE   write the test image annotated with the differences\n"
+              << "                   (missing: red, extra: magenta, shifted: yellow, matched: green)\n"
+              << "  --csv FILE       write one line per difference\n"
+              << "  --position-tolerance PX  center offset above which a matched part is reported as shifted (default: 3)\n"
+              << "  --search-radius PX       largest center offset for two parts to be matched (default: 30)\n"
+              << "  --size-tolerance R       largest relative width/height difference for two parts to match (default: 0.25)\n"
+              << "  --translation-only       register by translation only (no rotation)\n"
+              << "Exit status: 0 if the boards match, 2 if differences were found, 1 on error.\n";
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Une ligne par différence : type, indices, boîte (repère de l'image concernée) et décalage
+bool writeDifferences(const std::string& path, const BoardComparison& comparison,
+                      const std::vector<cv::Rect>& referenceRects, const std::vector<cv::Rect>& testRects)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "type,reference_id,test_id,x,y,width,height,dx,dy\n";
+    for (int i : comparison.missing) {
+        const cv::Rect& box = referenceRects[i];
+        file << "missing," << i << ",," << box.x << ',' << box.y << ',' << box.width << ',' << box.height << ",,\n";
+    }
+    for (int j : comparison.extra) {
+        const cv::Rect& box = testRects[j];
+        file << "extra,," << j << ',' << box.x << ',' << box.y << ',' << box.width << ',' << box.height << ",,\n";
+    }
+    for (const ComponentPair& pair : comparison.shifted) {
+        const cv::Rect& box = testRects[pair.test];
+        file << "shifted," << pair.reference << ',' << pair.test << ',' << box.x << ',' << box.y << ','
+             << box.width << ',' << box.height << ',' << pair.offset.x << ',' << pair.offset.y << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // --- Lecture des arguments ---
+    std::vector<std::string> positional;
+    std::string paramsFile, overlayFile, csvFile;
+    RegistrationOptions registrationOptions;
+    ComparisonOptions comparisonOptions;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--params" && hasValue) {
+            paramsFile = argv[++i];
+        } else if (arg == "--overlay" && hasValue) {
+            overlayFile = argv[++i];
+        } else if (arg == "--csv" && hasValue) {
+            csvFile = argv[++i];
+        } else if (arg == "--position-tolerance" && hasValue) {
+            comparisonOptions.positionTolerance = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--search-radius" && hasValue) {
+            comparisonOptions.searchRadius = std::max(1.0, std::atof(argv[++i]));
+        } else if (arg == "--size-tolerance" && hasValue) {
+            comparisonOptions.sizeTolerance = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--translation-only") {
+            registrationOptions.rotation = false;
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    PipelineParams params;
+    std::string error;
+    if (!paramsFile.empty() && !loadPipelineParams(paramsFile, params, &error)) {
+        std::cerr << "Error: " << error << "\n";
+        return EXIT_FAILURE;
+    }
+    const cv::Mat reference = cv::imread(positional[0], cv::IMREAD_COLOR);
+    const cv::Mat test = cv::imread(positional[1], cv::IMREAD_COLOR);
+    if (reference.empty() || test.empty()) {
+        std::cerr << "Error: cannot read " << (reference.empty() ? positional[0] : positional[1]) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        // --- Détection sur les deux cartes ---
+        auto start = std::chrono::steady_clock::now();
+        PcbPipeline pipeline;
+        pipeline.setImage(reference);
+        const std::vector<cv::Rect> referenceRects = pipeline.run(params).rects;
+        pipeline.setImage(test);
+        const std::vector<cv::Rect> testRects = pipeline.run(params).rects;
+        const double detectionMs = millisecondsSince(start);
+
+        // --- Recalage et appariement ---
+        GoldenBoard golden(registrationOptions, comparisonOptions);
+        golden.setReference(reference, referenceRects);
+        const BoardComparison comparison = golden.compare(test, testRects);
+        const BoardRegistration& registration = comparison.registration;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "Reference: " << referenceRects.size() << " components, test: " << testRects.size() << " components\n"
+                  << "Registration: translation (" << registration.testToReference(0, 2) << ", "
+                  << registration.testToReference(1, 2) << ") px, rotation " << registration.angleDegrees()
+                  << " deg, phase response " << registration.phaseResponse;
+        if (registration.refined) {
+            std::cout << ", ECC correlation " << registration.eccCorrelation << "\n";
+        } else {
+            std::cout << " (ECC did not converge: translation only)\n";
+        }
+        for (int i : comparison.missing) {
+            const cv::Rect& box = referenceRects[i];
+            std::cout << "  missing  #" << i << " at (" << box.x << ", " << box.y << ") " << box.width << "x" << box.height << "\n";
+        }
+        for (int j : comparison.extra) {
+            const cv::Rect& box = testRects[j];
+            std::cout << "  extra    #" << j << " at (" << box.x << ", " << box.y << ") " << box.width << "x" << box.height << "\n";
+        }
+        for (const ComponentPair& pair : comparison.shifted) {
+            std::cout << "  shifted  #" << pair.reference << " -> #" << pair.test << " by (" << pair.offset.x << ", "
+                      << pair.offset.y << ") px\n";
+        }
+        std::cout << "Missing " << comparison.missing.size() << ", extra " << comparison.extra.size()
+                  << ", shifted " << comparison.shifted.size() << ", matched " << comparison.matched.size() << "\n"
+                  << "Detection: " << detectionMs << " ms, registration: " << comparison.registrationMs
+                  << " ms, diff: " << comparison.diffMs << " ms\n";
+
+        if (!overlayFile.empty() && !cv::imwrite(overlayFile, golden.renderOverlay(test, testRects, comparison))) {
+            std::cerr << "Error: cannot write " << overlayFile << "\n";
+            return EXIT_FAILURE;
+        }
+        if (!csvFile.empty() && !writeDifferences(csvFile, comparison, referenceRects, testRects)) {
+            std::cerr << "Error: cannot write " << csvFile << "\n";
+            return EXIT_FAILURE;
+        }
+        return comparison.identical() ? EXIT_SUCCESS : 2;
+    } catch (const cv::Exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,449 @@
+// pcb_eval.cpp
+// Outil en ligne de commande : mesure la qualité de la détection sur un jeu d'images annotées, en parallèle,
+// avec les temps d'exécution. Pour chaque image et pour l'ensemble : précision, rappel, F1 et IoU moyen,
+// temps de détection (médiane, 95e centile) et débit. Des seuils facultatifs font échouer la commande
+// (code de retour 2) : une modification censée accélérer le pipeline se valide sur la vitesse ET la qualité.
+//
+// Usage : pcb_eval <dataset_dir> [--params FILE] [--threads N] [--min-iou R] [--repeat N] [--tiled [--tile-size N]]
+//                  [--csv FILE] [--json FILE] [--min-precision R] [--min-recall R] [--min-f1 R]
+//                  [--min-mean-iou R] [--max-median-ms MS]
+//
+// Chaque image <nom>.png du répertoire est accompagnée de ses annotations <nom>_annotations.csv (rectangles
+// enregistrés depuis la fenêtre de dessin, ou liste de composants de pcb_batch corrigée à la main).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "groundtruth.h"
+#include "pcbpipeline.h"
+#include "pipelineparams.h"
+#include "threadpool.h"
+#include "tiledpipeline.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Affiche l'aide de la commande
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <dataset_dir> [--params FILE] [--threads N] [--min-iou R] [--repeat N]"
+                 " [--tiled [--tile-size N]] [--csv FILE] [--json FILE] [--min-precision R] [--min-recall R]"
+                 " [--min-f1 R] [--min-mean-iou R] [--max-median-ms MS]\n"
+              << "  dataset_dir        board images, each with <name>_annotations.csv (columns x,y,width,height)\n"
+              << "  --params FILE      pipeline parameters, one 'key = value' per line (default: built-in values)\n"
+              << "  --threads N        number of worker threads (default: number of cores; use 1 for stable timings)\n"
+              << "  --min-iou R        smallest IoU for a detection to match an annotation (default: 0.5)\n"
+              << "  --repeat N         detection runs per image, the median time is kept (default: 1)\n"
+              << "  --tiled            process one image at a time, split into overlapping tiles (gigapixel scans)\n"
+              << "  --tile-size N      tile side in pixels for --tiled (default: 2048)\n"
+              << "  --csv FILE         write the per-image results\n"
+              << "  --json FILE        write the per-image and overall results\n"
+              << "  --min-precision R  fail (exit code 2) if the overall precision is below R\n"
+              << "  --min-recall R     fail if the overall recall is below R\n"
+              << "  --min-f1 R         fail if the overall F1 is below R\n"
+              << "  --min-mean-iou R   fail if the overall mean IoU is below R\n"
+              << "  --max-median-ms MS fail if the median detection time per image exceeds MS\n";
+}
+
+// Résultat de l'évaluation d'une image
+struct ImageEvaluation
+{
+    std::string name;        // Nom du fichier image
+    int width = 0;
+    int height = 0;
+    int annotations = 0;
+    int detections = 0;
+    MatchCounts counts;
+    double loadMs = 0.0;     // Lecture de l'image et des annotations
+    double detectMs = 0.0;   // Pipeline complet (médiane sur --repeat exécutions)
+    bool ok = false;
+    std::string error;
+};
+
+// Seuils de validation (négatif : pas de seuil)
+struct Gates
+{
+    double minPrecision = -1.0;
+    double minRecall = -1.0;
+    double minF1 = -1.0;
+    double minMeanIoU = -1.0;
+    double maxMedianMs = -1.0;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Centile (0 à 100) d'une liste de valeurs, par la méthode du rang le plus proche
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const std::size_t rank = static_cast<std::size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+// Chaîne JSON entre guillemets (noms de fichiers)
+std::string jsonString(const std::string& text)
+{
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Évalue une image : lecture, détection (répétée) et appariement avec les annotations
+ImageEvaluation evaluateImage(const AnnotatedImage& entry, const PipelineParams& params, double minIoU, int repeat,
+                              bool tiled, const TilingOptions& tiling)
+{
+    ImageEvaluation eval;
+    eval.name = fs::path(entry.imagePath).filename().string();
+
+    const auto loadStart = std::chrono::steady_clock::now();
+    std::vector<cv::Rect> annotations;
+    if (!loadAnnotations(entry.annotationPath, annotations, &eval.error)) {
+        return eval;
+    }
+    const cv::Mat image = cv::imread(entry.imagePath, cv::IMREAD_COLOR);
+    if (image.empty()) {
+        eval.error = "cannot read " + entry.imagePath;
+        return eval;
+    }
+    eval.loadMs = elapsedMs(loadStart);
+    eval.width = image.cols;
+    eval.height = image.rows;
+    eval.annotations = static_cast<int>(annotations.size());
+
+    // Un pipeline neuf à chaque exécution : le cache d'étapes ne doit pas fausser les temps répétés
+    DetectionResult result;
+    std::vector<double> times;
+    for (int r = 0; r < repeat; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        if (tiled) {
+            result = TiledPipeline::run(image, params, tiling);
+        } else {
+            PcbPipeline pipeline;
+            pipeline.setImage(image);
+            result = pipeline.run(params);
+        }
+        times.push_back(elapsedMs(start));
+    }
+    eval.detectMs = percentile(times, 50.0);
+    eval.detections = result.componentCount();
+    eval.counts = GroundTruth(annotations).match(result.rects, minIoU);
+    eval.ok = true;
+    return eval;
+}
+
+bool writeCsv(const std::string& path, const std::vector<ImageEvaluation>& evals)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << std::fixed << std::setprecision(4);
+    file << "image,width,height,annotations,detections,tp,fp,fn,precision,recall,f1,mean_iou,load_ms,detect_ms\n";
+    for (const ImageEvaluation& e : evals) {
+        if (!e.ok) {
+            continue;
+        }
+        file << e.name << ',' << e.width << ',' << e.height << ',' << e.annotations << ',' << e.detections << ','
+             << e.counts.truePositives << ',' << e.counts.falsePositives << ',' << e.counts.falseNegatives << ','
+             << e.counts.precision() << ',' << e.counts.recall() << ',' << e.counts.f1() << ','
+             << e.counts.meanIoU() << ',' << e.loadMs << ',' << e.detectMs << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+// Bilan global : comptes cumulés sur toutes les images (micro-moyenne) et temps
+struct Summary
+{
+    MatchCounts counts;
+    int images = 0;
+    int failed = 0;
+    double megapixels = 0.0;
+    double totalDetectMs = 0.0;
+    double medianDetectMs = 0.0;
+    double p95DetectMs = 0.0;
+    double maxDetectMs = 0.0;
+    double wallSeconds = 0.0;
+};
+
+bool writeJson(const std::string& path, const std::vector<ImageEvaluation>& evals, const Summary& summary,
+               const PipelineParams& params, double minIoU, unsigned threads, int repeat, bool tiled)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    const MatchCounts& c = summary.counts;
+    file << std::fixed << std::setprecision(4);
+    file << "{\n"
+         << "  \"benchmark\": \"pcb_eval\",\n"
+         << "  \"opencv_version\": \"" << CV_VERSION << "\",\n"
+         << "  \"threads\": " << threads << ",\n"
+         << "  \"repeat\": " << repeat << ",\n"
+         << "  \"tiled\": " << (tiled ? "true" : "false") << ",\n"
+         << "  \"min_iou\": " << minIoU << ",\n"
+         << "  \"params\": {\"blurKsize\": " << params.blurKsize << ", \"sigmaX\": " << params.sigmaX
+         << ", \"claheClipLimit\": " << params.claheClipLimit << ", \"separationKsize\": " << params.separationKsize
+         << ", \"fillHolesKsize\": " << params.fillHolesKsize << ", \"contourMinArea\": " << params.contourMinArea
+         << ", \"extractor\": \"" << componentExtractorName(params.extractor) << "\"},\n"
+         << "  \"overall\": {\"images\": " << summary.images << ", \"failed\": " << summary.failed
+         << ", \"tp\": " << c.truePositives << ", \"fp\": " << c.falsePositives << ", \"fn\": " << c.falseNegatives
+         << ", \"precision\": " << c.precision() << ", \"recall\": " << c.recall() << ", \"f1\": " << c.f1()
+         << ", \"mean_iou\": " << c.meanIoU() << ", \"median_detect_ms\": " << summary.medianDetectMs
+         << ", \"p95_detect_ms\": " << summary.p95DetectMs << ", \"max_detect_ms\": " << summary.maxDetectMs
+         << ", \"wall_seconds\": " << summary.wallSeconds << ", \"megapixels\": " << summary.megapixels << "},\n"
+         << "  \"images\": [\n";
+    bool first = true;
+    for (const ImageEvaluation& e : evals) {
+        if (!e.ok) {
+            continue;
+        }
+        file << (first ? "" : ",\n") << "    {\"image\": " << jsonString(e.name) << ", \"width\": " << e.width
+             << ", \"height\": " << e.height << ", \"annotations\": " << e.annotations
+             << ", \"detections\": " << e.detections << ", \"tp\": " << e.counts.truePositives
+             << ", \"fp\": " << e.counts.falsePositives << ", \"fn\": " << e.counts.falseNegatives
+             << ", \"precision\": " << e.counts.precision() << ", \"recall\": " << e.counts.recall()
+             << ", \"f1\": " << e.counts.f1() << ", \"mean_iou\": " << e.counts.meanIoU()
+             << ", \"load_ms\": " << e.loadMs << ", \"detect_ms\": " << e.detectMs << "}";
+        first = false;
+    }
+    file << "\n  ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+// Lit la valeur réelle d'une option ; false si elle n'est pas un nombre
+bool parseDouble(const char* text, double& value)
+{
+    std::istringstream stream(text);
+    return static_cast<bool>(stream >> value);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // --- Lecture des arguments ---
+    std::string directory;
+    std::string paramsFile;
+    std::string csvPath;
+    std::string jsonPath;
+    unsigned threadCount = 0; // 0 : nombre de cœurs
+    double minIoU = 0.5;
+    int repeat = 1;
+    bool tiled = false;
+    TilingOptions tiling;
+    Gates gates;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        double* gate = nullptr;
+        if (arg == "--min-precision") gate = &gates.minPrecision;
+        else if (arg == "--min-recall") gate = &gates.minRecall;
+        else if (arg == "--min-f1") gate = &gates.minF1;
+        else if (arg == "--min-mean-iou") gate = &gates.minMeanIoU;
+        else if (arg == "--max-median-ms") gate = &gates.maxMedianMs;
+
+        if (gate && hasValue) {
+            if (!parseDouble(argv[++i], *gate) || *gate < 0.0) {
+                std::cerr << "Error: invalid value for " << arg << ": " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--params" && hasValue) {
+            paramsFile = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            threadCount = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--min-iou" && hasValue) {
+            minIoU = std::min(1.0, std::max(0.01, std::atof(argv[++i])));
+        } else if (arg == "--repeat" && hasValue) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--tiled") {
+            tiled = true;
+        } else if (arg == "--tile-size" && hasValue) {
+            tiling.tileSize = std::max(64, std::atoi(argv[++i]));
+        } else if (arg == "--csv" && hasValue) {
+            csvPath = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (directory.empty() && !gate) {
+            directory = arg;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (directory.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    PipelineParams params;
+    if (!paramsFile.empty()) {
+        std::string error;
+        if (!loadPipelineParams(paramsFile, params, &error)) {
+            std::cerr << "Error: " << error << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    const std::vector<AnnotatedImage> dataset = findAnnotatedImages(directory);
+    if (dataset.empty()) {
+        std::cerr << "Error: no image with a <name>_annotations.csv file in " << directory << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // Même répartition que pcb_batch : parallélisme entre images (ou entre tuiles avec --tiled),
+    // parallélisme interne d'OpenCV désactivé
+    cv::setNumThreads(1);
+    tiling.threads = threadCount;
+
+    // --- Évaluation ---
+    std::vector<ImageEvaluation> evals(dataset.size());
+    std::mutex outputMutex; // Évite que les messages de plusieurs threads ne s'entremêlent
+    unsigned poolThreads = 1;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(tiled ? 1 : threadCount);
+        poolThreads = !tiled ? pool.threadCount()
+                    : tiling.threads > 0 ? tiling.threads : std::max(1u, std::thread::hardware_concurrency());
+        std::cout << "Evaluating " << dataset.size() << " images "
+                  << (tiled ? "one at a time, in tiles" : "with " + std::to_string(pool.threadCount()) + " threads")
+                  << " (IoU >= " << minIoU << ")...\n";
+
+        for (std::size_t i = 0; i < dataset.size(); ++i) {
+            pool.submit([&, i]() {
+                ImageEvaluation eval;
+                try {
+                    eval = evaluateImage(dataset[i], params, minIoU, repeat, tiled, tiling);
+                } catch (const cv::Exception& e) {
+                    eval.name = fs::path(dataset[i].imagePath).filename().string();
+                    eval.error = e.what();
+                }
+                std::lock_guard<std::mutex> lock(outputMutex);
+                if (!eval.ok) {
+                    std::cerr << "  [error] " << eval.name << ": " << eval.error << "\n";
+                }
+                evals[i] = std::move(eval); // Chaque tâche écrit sa propre case : l'ordre des images est conservé
+            });
+        }
+        pool.waitIdle();
+    } // Le pool est détruit ici : tous les threads sont rejoints
+
+    Summary summary;
+    summary.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::vector<double> detectTimes;
+    for (const ImageEvaluation& e : evals) {
+        if (!e.ok) {
+            ++summary.failed;
+            continue;
+        }
+        ++summary.images;
+        summary.counts += e.counts;
+        summary.megapixels += e.width * static_cast<double>(e.height) / 1e6;
+        summary.totalDetectMs += e.detectMs;
+        detectTimes.push_back(e.detectMs);
+    }
+    summary.medianDetectMs = percentile(detectTimes, 50.0);
+    summary.p95DetectMs = percentile(detectTimes, 95.0);
+    summary.maxDetectMs = detectTimes.empty() ? 0.0 : *std::max_element(detectTimes.begin(), detectTimes.end());
+
+    // --- Tableau par image ---
+    std::cout << std::fixed << std::setprecision(3) << "\n"
+              << std::left << std::setw(28) << "image" << std::right << std::setw(7) << "annot" << std::setw(7)
+              << "detect" << std::setw(6) << "TP" << std::setw(6) << "FP" << std::setw(6) << "FN" << std::setw(10)
+              << "precision" << std::setw(8) << "recall" << std::setw(8) << "F1" << std::setw(8) << "IoU"
+              << std::setw(11) << "detect ms" << "\n";
+    for (const ImageEvaluation& e : evals) {
+        if (!e.ok) {
+            continue;
+        }
+        const std::string name = e.name.size() > 27 ? e.name.substr(0, 24) + "..." : e.name;
+        std::cout << std::left << std::setw(28) << name << std::right << std::setw(7) << e.annotations
+                  << std::setw(7) << e.detections << std::setw(6) << e.counts.truePositives << std::setw(6)
+                  << e.counts.falsePositives << std::setw(6) << e.counts.falseNegatives << std::setw(10)
+                  << e.counts.precision() << std::setw(8) << e.counts.recall() << std::setw(8) << e.counts.f1()
+                  << std::setw(8) << e.counts.meanIoU() << std::setw(11) << std::setprecision(1) << e.detectMs
+                  << std::setprecision(3) << "\n";
+    }
+
+    // --- Bilan ---
+    const MatchCounts& c = summary.counts;
+    std::cout << "\nOverall (" << summary.images << " images, " << summary.failed << " failed): precision "
+              << c.precision() << ", recall " << c.recall() << ", F1 " << c.f1() << ", mean IoU " << c.meanIoU()
+              << " (" << c.truePositives << " TP, " << c.falsePositives << " FP, " << c.falseNegatives << " FN)\n"
+              << std::setprecision(1) << "Detection per image: median " << summary.medianDetectMs << " ms, p95 "
+              << summary.p95DetectMs << " ms, max " << summary.maxDetectMs << " ms";
+    if (summary.totalDetectMs > 0.0) {
+        std::cout << " (" << std::setprecision(2) << summary.megapixels / (summary.totalDetectMs / 1000.0)
+                  << " MP/s per thread)";
+    }
+    std::cout << "\n" << std::setprecision(2) << "Elapsed: " << summary.wallSeconds << " s with " << poolThreads
+              << " threads, throughput: " << (summary.wallSeconds > 0.0 ? summary.images / summary.wallSeconds : 0.0)
+              << " images/s\n";
+
+    if (!csvPath.empty()) {
+        if (!writeCsv(csvPath, evals)) {
+            std::cerr << "Error: cannot write " << csvPath << "\n";
+            return EXIT_FAILURE;
+        }
+        std::cout << "Per-image results written to " << csvPath << "\n";
+    }
+    if (!jsonPath.empty()) {
+        if (!writeJson(jsonPath, evals, summary, params, minIoU, poolThreads, repeat, tiled)) {
+            std::cerr << "Error: cannot write " << jsonPath << "\n";
+            return EXIT_FAILURE;
+        }
+        std::cout << "Results written to " << jsonPath << "\n";
+    }
+    if (summary.failed > 0) {
+        return EXIT_FAILURE;
+    }
+
+    // --- Seuils de validation ---
+    bool passed = true;
+    const auto check = [&](const char* name, double value, double limit, bool atMost) {
+        if (limit < 0.0) {
+            return;
+        }
+        const bool ok = atMost ? value <= limit : value >= limit;
+        std::cout << (ok ? "  [pass] " : "  [FAIL] ") << name << " " << std::setprecision(3) << value
+                  << (atMost ? " <= " : " >= ") << limit << "\n";
+        passed = passed && ok;
+    };
+    check("precision", c.precision(), gates.minPrecision, false);
+    check("recall", c.recall(), gates.minRecall, false);
+    check("F1", c.f1(), gates.minF1, false);
+    check("mean IoU", c.meanIoU(), gates.minMeanIoU, false);
+    check("median detection ms", summary.medianDetectMs, gates.maxMedianMs, true);
+    return passed ? EXIT_SUCCESS : 2;
+}
@@ -0,0 +1,164 @@
+// pcb_stream.cpp
+// Outil en ligne de commande : applique le pipeline de détection à un flux de trames (caméra, fichier vidéo,
+// suite d'images) avec FrameStream, sans interface graphique. Chaque seconde, il affiche le débit soutenu,
+// la latence, la profondeur de chaque file et le nombre de trames jetées ; à la fin, la durée moyenne par étage.
+//
+// Usage : pcb_stream <source> [--params FILE] [--output FILE] [--queue N] [--no-drop] [--realtime]
+//                             [--max-frames N]
+//
+// <source> est un numéro de caméra ("0"), une vidéo ("line3.mp4") ou un motif de suite d'images ("board_%04d.png").
+// --output enregistre les trames annotées dans une vidéo : c'est alors le consommateur qui limite le débit,
+// et les trames qu'il n'a pas le temps d'écrire sont jetées (sauf avec --no-drop).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "framestream.h"
+#include "pipelineparams.h"
+
+namespace {
+
+// Affiche l'aide de la commande
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <source> [--params FILE] [--output FILE] [--queue N] [--no-drop]"
+                 " [--realtime] [--max-frames N]\n"
+              << "  source          camera index (\"0\"), video file, or image sequence pattern (\"board_%04d.png\")\n"
+              << "  --params FILE   pipeline parameters, one 'key = value' per line (default: slider defaults)\n"
+              << "  --output FILE   write annotated frames to a video file (FOURCC MJPG)\n"
+              << "  --queue N       frames waiting at most between two stages (default: 2)\n"
+              << "  --no-drop       never drop frames: slow decoding down to the slowest stage instead\n"
+              << "  --realtime      decode a recording at its own frame rate, as a live camera would deliver it\n"
+              << "  --max-frames N  stop after N delivered frames\n";
+}
+
+// Une ligne d'état : débit, latence, puis profondeur/capacité et trames jetées de chaque file
+void printStatus(const StreamStats& stats)
+{
+    std::cout << std::fixed << std::setprecision(1)
+              << "[" << std::setw(6) << stats.elapsedSeconds << " s] "
+              << std::setw(5) << stats.fps << " fps, latency " << std::setw(6) << stats.latencyMs << " ms, queues";
+    for (const StreamStageStats& stage : stats.stages) {
+        std::cout << " " << stage.name << "->" << stage.queueDepth << "/" << stage.queueCapacity;
+    }
+    std::cout << ", dropped " << stats.dropped << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // --- Lecture des arguments ---
+    std::string source;
+    std::string paramsFile;
+    std::string outputFile;
+    StreamOptions options;
+    long long maxFrames = 0; // 0 : jusqu'à la fin de la source
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--params" && i + 1 < argc) {
+            paramsFile = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg == "--queue" && i + 1 < argc) {
+            options.queueCapacity = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--no-drop") {
+            options.dropFrames = false;
+        } else if (arg == "--realtime") {
+            options.realTime = true;
+        } else if (arg == "--max-frames" && i + 1 < argc) {
+            maxFrames = std::max(0LL, std::atoll(argv[++i]));
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (source.empty()) {
+            source = arg;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (source.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    PipelineParams params;
+    std::string error;
+    if (!paramsFile.empty() && !loadPipelineParams(paramsFile, params, &error)) {
+        std::cerr << "Error: " << error << "\n";
+        return EXIT_FAILURE;
+    }
+
+    FrameStream stream(options);
+    if (!stream.open(source, &error)) {
+        std::cerr << "Error: " << error << "\n";
+        return EXIT_FAILURE;
+    }
+    std::cout << "Streaming " << source;
+    if (stream.sourceFps() > 0.0) {
+        std::cout << " (" << stream.sourceFps() << " fps)";
+    }
+    std::cout << ", queues of " << options.queueCapacity << ", "
+              << (options.dropFrames ? "dropping frames when a stage lags" : "no frame dropping") << "\n";
+
+    cv::VideoWriter writer;
+    long long delivered = 0;
+    long long components = 0;
+    auto lastStatus = std::chrono::steady_clock::now();
+    stream.start(params);
+    while (!stream.isFinished()) {
+        StreamFrame frame;
+        if (stream.next(frame, std::chrono::milliseconds(100))) {
+            ++delivered;
+            components += frame.result.componentCount();
+            if (!outputFile.empty()) {
+                if (!writer.isOpened()) {
+                    const double fps = stream.sourceFps() > 0.0 ? stream.sourceFps() : 25.0;
+                    writer.open(outputFile, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps,
+                                frame.result.contoursImage.size());
+                    if (!writer.isOpened()) {
+                        std::cerr << "Error: cannot write " << outputFile << "\n";
+                        stream.stop();
+                        return EXIT_FAILURE;
+                    }
+                }
+                writer.write(frame.result.contoursImage);
+            }
+            if (maxFrames > 0 && delivered >= maxFrames) {
+                break;
+            }
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastStatus >= std::chrono::seconds(1)) {
+            printStatus(stream.stats());
+            lastStatus = now;
+        }
+    }
+    const StreamStats stats = stream.stats(); // Avant stop() : compteurs du flux tel qu'il a tourné
+    stream.stop();
+
+    // --- Bilan ---
+    std::cout << "\nDecoded " << stats.decoded << " frames, delivered " << delivered << ", dropped " << stats.dropped
+              << ", " << components << " components\n"
+              << "Elapsed: " << stats.elapsedSeconds << " s, sustained throughput: " << stats.averageFps << " fps\n"
+              << std::left << std::setw(12) << "stage" << std::right << std::setw(10) << "frames"
+              << std::setw(12) << "mean ms" << std::setw(10) << "dropped" << "\n";
+    for (const StreamStageStats& stage : stats.stages) {
+        std::cout << std::left << std::setw(12) << stage.name << std::right << std::setw(10) << stage.frames
+                  << std::setw(12) << std::setprecision(2) << stage.meanMs << std::setw(10) << stage.dropped << "\n";
+    }
+    const std::string streamError = stream.lastError();
+    if (!streamError.empty()) {
+        std::cerr << "Error: " << streamError << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+// pcb_tune.cpp
+// Outil en ligne de commande : cherche les paramètres du pipeline qui retrouvent le mieux les composants annotés
+// d'un jeu d'images (ParameterTuner), en parallèle sur tous les cœurs, et écrit le meilleur jeu de paramètres.
+//
+// Usage : pcb_tune <dataset_dir> [--output FILE] [--strategy grid|random] [--candidates N] [--seed N]
+//                  [--min-iou R] [--halving F] [--threads N] [--extractor NAME] [--range KEY=MIN:MAX[:STEP]]...
+//                  [--top N]
+//
+// Chaque image <nom>.png du répertoire est accompagnée de ses annotations <nom>_annotations.csv (rectangles
+// enregistrés depuis la fenêtre de dessin, ou liste de composants de pcb_batch corrigée à la main).
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "groundtruth.h"
+#include "parametertuner.h"
+#include "pipelineparams.h"
+
+namespace {
+
+// Affiche l'aide de la commande
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " <dataset_dir> [--output FILE] [--strategy grid|random] [--candidates N]"
+                 " [--seed N] [--min-iou R] [--halving F] [--threads N] [--extractor NAME]"
+                 " [--range KEY=MIN:MAX[:STEP]]... [--top N]\n"
+              << "  dataset_dir      board images, each with <name>_annotations.csv (columns x,y,width,height)\n"
+              << "  --output FILE    write the best parameters (default: tuned_params.txt)\n"
+              << "  --strategy S     grid: every combination (default); random: --candidates random combinations\n"
+              << "  --candidates N   combinations drawn by the random search (default: 400)\n"
+              << "  --seed N         seed of the random search and of the image order (default: 1)\n"
+              << "  --min-iou R      smallest IoU for a detection to match an annotation (default: 0.5)\n"
+              << "  --halving F      successive halving: keep 1 candidate in F after each round (default: 2, 1 = off)\n"
+              << "  --threads N      number of worker threads (default: number of cores)\n"
+              << "  --extractor NAME contours (default) or connected_components\n"
+              << "  --range K=A:B[:S]  values tried for slider K (blurKsize, sigmaX, claheClipLimit, separationKsize,\n"
+              << "                   fillHolesKsize, contourMinArea), from A to B by step S; may be repeated\n"
+              << "  --top N          number of best candidates printed (default: 10)\n";
+}
+
+// Lit "clé=min:max[:pas]" dans la plage correspondante de l'espace de recherche
+bool parseRange(const std::string& text, TuningSpace& space)
+{
+    const std::size_t equal = text.find('=');
+    if (equal == std::string::npos) {
+        return false;
+    }
+    const std::string key = text.substr(0, equal);
+    ParameterRange* range = nullptr;
+    if (key == "blurKsize") range = &space.blurKsize;
+    else if (key == "sigmaX") range = &space.sigmaX;
+    else if (key == "claheClipLimit") range = &space.claheClipLimit;
+    else if (key == "separationKsize") range = &space.separationKsize;
+    else if (key == "fillHolesKsize") range = &space.fillHolesKsize;
+    else if (key == "contourMinArea") range = &space.contourMinArea;
+    if (!range) {
+        return false;
+    }
+    std::istringstream values(text.substr(equal + 1));
+    ParameterRange parsed;
+    char colon = 0;
+    if (!(values >> parsed.min >> colon) || colon != ':' || !(values >> parsed.max) || parsed.max < parsed.min) {
+        return false;
+    }
+    if (values >> colon) {
+        if (colon != ':' || !(values >> parsed.step) || parsed.step <= 0) {
+            return false;
+        }
+    }
+    *range = parsed;
+    return true;
+}
+
+void printParams(const PipelineParams& p)
+{
+    std::cout << "blur " << std::setw(2) << p.blurKsize << "  sigma " << std::setw(2) << p.sigmaX
+              << "  clahe " << std::setw(2) << p.claheClipLimit << "  fill " << std::setw(2) << p.fillHolesKsize
+              << "  sep " << std::setw(2) << p.separationKsize << "  minArea " << std::setw(4) << p.contourMinArea;
+}
+
+void printCounts(const MatchCounts& counts)
+{
+    std::cout << "F1 " << counts.f1() << "  precision " << counts.precision() << "  recall " << counts.recall()
+              << "  mean IoU " << counts.meanIoU();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // --- Lecture des arguments ---
+    std::string directory;
+    std::string outputFile = "tuned_params.txt";
+    TunerOptions options;
+    int top = 10;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--output" && hasValue) {
+            outputFile = argv[++i];
+        } else if (arg == "--strategy" && hasValue) {
+            const std::string strategy = argv[++i];
+            if (strategy != "grid" && strategy != "random") {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            options.strategy = strategy == "random" ? SearchStrategy::Random : SearchStrategy::Grid;
+        } else if (arg == "--candidates" && hasValue) {
+            options.randomCandidates = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--min-iou" && hasValue) {
+            options.minIoU = std::min(1.0, std::max(0.01, std::atof(argv[++i])));
+        } else if (arg == "--halving" && hasValue) {
+            options.halvingFactor = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            options.threadCount = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--extractor" && hasValue) {
+            if (!parseComponentExtractor(argv[++i], options.space.extractor)) {
+                std::cerr << "Error: unknown extractor " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--range" && hasValue) {
+            if (!parseRange(argv[++i], options.space)) {
+                std::cerr << "Error: invalid range " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--top" && hasValue) {
+            top = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (directory.empty()) {
+            directory = arg;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (directory.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // --- Chargement du jeu d'images ---
+    ParameterTuner tuner(options);
+    long long annotationCount = 0;
+    for (const AnnotatedImage& entry : findAnnotatedImages(directory)) {
+        std::vector<cv::Rect> annotations;
+        std::string error;
+        if (!loadAnnotations(entry.annotationPath, annotations, &error)) {
+            std::cerr << "Error: " << error << "\n";
+            return EXIT_FAILURE;
+        }
+        const cv::Mat image = cv::imread(entry.imagePath, cv::IMREAD_COLOR);
+        if (image.empty()) {
+            std::cerr << "Error: cannot read " << entry.imagePath << "\n";
+            return EXIT_FAILURE;
+        }
+        tuner.addSample(image, annotations);
+        annotationCount += static_cast<long long>(annotations.size());
+    }
+    if (tuner.sampleCount() == 0) {
+        std::cerr << "Error: no image with a <name>_annotations.csv file in " << directory << "\n";
+        return EXIT_FAILURE;
+    }
+    const std::size_t candidateCount = tuner.candidates().size();
+    std::cout << "Tuning on " << tuner.sampleCount() << " images (" << annotationCount << " annotations), "
+              << candidateCount << " candidates ("
+              << (options.strategy == SearchStrategy::Random ? "random search" : "grid") << ")\n";
+
+    // --- Recherche ---
+    std::mutex outputMutex;
+    int lastRound = -1;
+    int lastPercent = -1;
+    TuningResult result;
+    try {
+        result = tuner.run([&](const TuningProgress& progress) {
+            // Appelé depuis les threads du pool : une ligne par tour, puis tous les 10 %
+            std::lock_guard<std::mutex> lock(outputMutex);
+            const int percent = progress.tasksTotal > 0 ? 100 * progress.tasksDone / progress.tasksTotal : 100;
+            if (progress.round != lastRound) {
+                std::cout << "Round " << progress.round + 1 << "/" << progress.roundCount << ": "
+                          << progress.candidates << " candidates\n";
+                lastRound = progress.round;
+                lastPercent = -1;
+            }
+            if (percent / 10 != lastPercent / 10) {
+                std::cout << "  " << percent << " %\n" << std::flush;
+                lastPercent = percent;
+            }
+        });
+    } catch (const cv::Exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // --- Bilan ---
+    std::cout << std::fixed << std::setprecision(3) << "\nBest candidates:\n";
+    for (int i = 0; i < std::min<int>(top, static_cast<int>(result.ranking.size())); ++i) {
+        std::cout << std::setw(3) << i + 1 << ". ";
+        printParams(result.ranking[i].params);
+        std::cout << "  ";
+        printCounts(result.ranking[i].counts);
+        std::cout << "\n";
+    }
+    std::cout << "\nBest: ";
+    printParams(result.best);
+    std::cout << "\n      ";
+    printCounts(result.bestCounts);
+    std::cout << "  (" << result.bestCounts.truePositives << " TP, " << result.bestCounts.falsePositives << " FP, "
+              << result.bestCounts.falseNegatives << " FN)\n"
+              << std::setprecision(1) << "Elapsed: " << result.elapsedSeconds << " s, " << result.evaluations
+              << " evaluations, " << result.preprocessingRuns << " blur/CLAHE runs, " << result.morphologyRuns
+              << " openings (shared by the other candidates)\n";
+
+    if (!savePipelineParams(outputFile, result.best)) {
+        std::cerr << "Error: cannot write " << outputFile << "\n";
+        return EXIT_FAILURE;
+    }
+    std::cout << "Parameters written to " << outputFile << "\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,647 @@
+// pcbpipeline.cpp
+
+// Inclusion des en-têtes nécessaires pour le pipeline de détection (aucune dépendance Qt)
+#include "pcbpipeline.h"
+#include <string>                // Pour std::to_string (numérotation des composants)
+#include <vector>                // Pour std::vector, utilisé notamment pour les contours OpenCV
+#include <algorithm>             // std::max
+#include <mutex>                 // Fusion des aires calculées par bandes (composantes connexes)
+#include <opencv2/imgproc.hpp>   // cvtColor, GaussianBlur, threshold, findContours, connectedComponentsWithStats, etc.
+#include <opencv2/core/utility.hpp> // parallel_for_ (remplissage des trous, aires des composantes connexes)
+#include "pipelineprofiler.h"    // Mesure de la durée de chaque étape (ScopedStageTimer)
+#include "bgrkernels.h"          // Niveaux de gris et pixels sombres en une passe (SIMD)
+#include "blobcounter.h"         // Comptage des contours externes des deux polarités
+#include "rectmorphology.h"      // Morphologie en temps constant par pixel (van Herk / Gil-Werman)
+
+// Directives using pour éviter de préfixer les fonctions OpenCV et STL avec 'cv::' et 'std::'
+using namespace cv;
+using namespace std;
+
+/**
+ * @brief Définit l'image couleur sur laquelle le pipeline travaille.
+ * @param image L'image OpenCV d'entrée (BGR).
+ */
+void PcbPipeline::setImage(const cv::Mat& image)
+{
+    // Même tampon, même taille, même type : c'est la même image, le cache reste valable.
+    // (Le pipeline détient une référence sur l'ancienne image : son tampon ne peut pas avoir été réutilisé.)
+    const bool sameImage = image.data == m_image.data && image.size() == m_image.size()
+                           && image.type() == m_image.type() && image.step == m_image.step;
+    m_image = image; // Partage les données (comptage de références), sans copie
+    if (image.empty()) {
+        clearCache(); // Plus d'image : inutile de garder les tampons
+    } else if (!sameImage) {
+        invalidateCache(); // Nouvelle image (trame suivante, autre carte) : les tampons resservent
+    }
+}
+
+/**
+ * @brief Vide le cache des étapes : la prochaine exécution recalculera tout, avec de nouveaux tampons.
+ */
+void PcbPipeline::clearCache()
+{
+    m_cache = StageCache();
+    m_workspace.release();
+}
+
+/**
+ * @brief Invalide toutes les étapes sans libérer leurs images, que la prochaine exécution réécrira.
+ */
+void PcbPipeline::invalidateCache()
+{
+    StageCache& c = m_cache;
+    c.grayValid = c.blurredValid = c.preprocessedValid = c.thresholdValid = false;
+    c.darkMaskValid = c.closedValid = c.openedValid = c.candidatesValid = c.resultValid = false;
+}
+
+/**
+ * @brief Convertit une image BGR en niveaux de gris.
+ * Le noyau de bgrkernels donne exactement le résultat de cvtColor(COLOR_BGR2GRAY).
+ * @param bgr L'image couleur d'entrée.
+ * @return L'image en niveaux de gris.
+ */
+cv::Mat PcbPipeline::toGray(const cv::Mat& bgr)
+{
+    Mat gray;
+    bgrToGrayAndDarkPixels(bgr, &gray, nullptr, kDarkMaxValue);
+    return gray;
+}
+
+/**
+ * @brief Niveaux de gris et pixels sombres en une seule lecture de l'image BGR.
+ * Évite la conversion complète en HSV : seule la valeur V = max(B, G, R) est utile au masque des zones sombres.
+ * @param bgr L'image couleur d'entrée.
+ * @param gray Sortie niveaux de gris.
+ * @param darkPixels Sortie masque des pixels sombres (255 si V <= kDarkMaxValue).
+ */
+void PcbPipeline::toGrayAndDarkPixels(const cv::Mat& bgr, cv::Mat& gray, cv::Mat& darkPixels)
+{
+    bgrToGrayAndDarkPixels(bgr, &gray, &darkPixels, kDarkMaxValue);
+}
+
+/**
+ * @brief Applique le flou gaussien pour réduire le bruit et lisser l'image.
+ * `blurKsize` est converti en une taille de noyau impaire (2*N+1) car `GaussianBlur` requiert un noyau impair.
+ * `sigmaX` est divisé par 10.0 pour permettre des valeurs décimales plus fines via le slider.
+ * @param gray L'image en niveaux de gris, modifiée sur place.
+ * @param params Les paramètres du pipeline.
+ */
+void PcbPipeline::applyGaussianBlur(cv::Mat& gray, const PipelineParams& params)
+{
+    applyGaussianBlur(gray, gray, params);
+}
+
+/**
+ * @brief Flou gaussien de `src` vers `dst` (mêmes paramètres que la version sur place).
+ */
+void PcbPipeline::applyGaussianBlur(const cv::Mat& src, cv::Mat& dst, const PipelineParams& params)
+{
+    int ksize_val = params.blurKsize * 2 + 1; // Taille du noyau (ex: 1 -> 3x3, 2 -> 5x5)
+    double sigmaX_val = params.sigmaX / 10.0; // Écart-type pour le flou (valeur décimale plus fine)
+    if (sigmaX_val < 0.1) sigmaX_val = 0.1; // S'assurer que sigmaX n'est pas trop petit
+    if (ksize_val > 0) { // S'assurer que la taille du noyau est valide et positive
+        cv::GaussianBlur(src, dst, cv::Size(ksize_val, ksize_val), sigmaX_val);
+    } else if (dst.data != src.data) {
+        src.copyTo(dst);
+    }
+}
+
+/**
+ * @brief Amélioration du contraste avec CLAHE (Contrast Limited Adaptive Histogram Equalization).
+ * Utile pour améliorer le contraste local dans les zones sombres ou lumineuses de l'image.
+ * @param gray L'image en niveaux de gris, modifiée sur place.
+ * @param params Les paramètres du pipeline.
+ */
+void PcbPipeline::applyClahe(cv::Mat& gray, const PipelineParams& params)
+{
+    Ptr<CLAHE> clahe = createCLAHE(); // Crée une instance de l'algorithme CLAHE
+    clahe->setClipLimit(params.claheClipLimit / 10.0); // Définit la limite de coupure (valeur décimale)
+    clahe->apply(gray, gray); // Applique CLAHE à l'image en niveaux de gris
+}
+
+/**
+ * @brief Prétraitement complet : niveaux de gris, flou gaussien puis CLAHE.
+ * @param bgr L'image couleur d'entrée.
+ * @param params Les paramètres du pipeline.
+ * @return L'image en niveaux de gris prétraitée.
+ */
+cv::Mat PcbPipeline::preprocess(const cv::Mat& bgr, const PipelineParams& params)
+{
+    Mat gray = toGray(bgr);
+    applyGaussianBlur(gray, params);
+    applyClahe(gray, params);
+    return gray;
+}
+
+/**
+ * @brief Segmente une image en niveaux de gris en utilisant le seuillage adaptatif.
+ * Des deux versions du seuillage adaptatif (binaire et binaire inverse), on garde celle qui produit
+ * le plus de contours externes, supposant qu'elle capture mieux les éléments d'intérêt.
+ * La version inverse est exactement le complément de la version binaire : une seule moyenne locale suffit,
+ * et les contours des deux versions sont comptés en une passe par countExternalBlobs()
+ * (mêmes nombres que findContours(RETR_EXTERNAL), sans construire les listes de points).
+ * @param img_gray Image d'entrée en niveaux de gris.
+ * @param thresholded Image de sortie seuillée (le résultat sélectionné).
+ * @param inverted Booléen de sortie indiquant si le seuillage a été inversé (true si THRESH_BINARY_INV a été choisi).
+ */
+void PcbPipeline::segmentByAdaptiveThresholding(const Mat& img_gray, Mat& thresholded, bool& inverted)
+{
+    Mat& thresh_binary = thresholded; // Écrit directement dans la sortie (tampon réutilisé s'il a la bonne taille)
+    // Applique le seuillage adaptatif de type MEAN_C (moyenne des pixels voisins)
+    // - `ADAPTIVE_THRESH_MEAN_C`: le seuil est la moyenne des voisins moins une constante
+    // - `15`: taille du voisinage (bloc) pour calculer la moyenne (doit être impair)
+    // - `10`: constante soustraite de la moyenne (C)
+    adaptiveThreshold(img_gray, thresh_binary, 255, ADAPTIVE_THRESH_MEAN_C, THRESH_BINARY, 15, 10);
+
+    // Contours externes de la version binaire (pixels non nuls) et de la version inverse (pixels nuls)
+    const BlobCounts counts = countExternalBlobs(thresh_binary);
+
+    // Compare le nombre de contours trouvés dans chaque version pour choisir la meilleure segmentation.
+    // L'idée est que la version qui révèle le plus de contours distincts est probablement plus pertinente.
+    if (counts.foreground > counts.background) {
+        inverted = false;            // Choisit la version binaire si elle a plus de contours
+    } else {
+        bitwise_not(thresh_binary, thresh_binary); // Sinon, la version inverse : identique à THRESH_BINARY_INV (255 <-> 0)
+        inverted = true;             // Indique que le seuillage a été inversé
+    }
+}
+
+/**
+ * @brief Segmente une image en niveaux de gris en utilisant le seuillage global (fixe et Otsu).
+ * @param img_gray Image d'entrée en niveaux de gris.
+ * @param simple_thresholded Image de sortie seuillée avec un seuil fixe (117).
+ * @param otsu_thresholded Image de sortie seuillée avec la méthode d'Otsu.
+ * @param otsu_thresh Valeur du seuil calculée par la méthode d'Otsu (sortie).
+ */
+void PcbPipeline::segmentByGlobalThresholding(const Mat& img_gray, Mat& simple_thresholded, Mat& otsu_thresholded, double& otsu_thresh)
+{
+    // Applique un seuil binaire fixe (117)
+    threshold(img_gray, simple_thresholded, 117, 255, THRESH_BINARY);
+    // Applique le seuillage d'Otsu pour trouver un seuil optimal automatiquement.
+    // La valeur du seuil calculée est retournée par la fonction et stockée dans `otsu_thresh`.
+    otsu_thresh = threshold(img_gray, otsu_thresholded, 0, 255, THRESH_BINARY + THRESH_OTSU);
+}
+
+/**
+ * @brief Détermine le type de seuillage à appliquer (adaptatif ou global) en fonction de la luminosité
+ * moyenne de l'image prétraitée, puis l'applique.
+ * @param preprocessedGray L'image en niveaux de gris prétraitée.
+ * @return Le masque binaire du seuillage principal.
+ */
+cv::Mat PcbPipeline::segment(const cv::Mat& preprocessedGray)
+{
+    Mat main_thresholded_binary; // Matrice pour stocker le résultat du seuillage principal (final)
+    segment(preprocessedGray, main_thresholded_binary);
+    return main_thresholded_binary;
+}
+
+/**
+ * @brief Seuillage principal écrit dans `mask`.
+ * @param preprocessedGray L'image en niveaux de gris prétraitée.
+ * @param mask Le masque binaire du seuillage principal (sortie).
+ */
+void PcbPipeline::segment(const cv::Mat& preprocessedGray, cv::Mat& mask)
+{
+    Scalar mean_val = mean(preprocessedGray); // Calcule la valeur moyenne des pixels de l'image en niveaux de gris
+
+    if (mean_val[0] > 140) { // Si l'image est globalement lumineuse (valeur moyenne des pixels > 140)
+        // Utilise le seuillage adaptatif, plus efficace pour les images avec des variations d'éclairage
+        bool inverted_main_threshold = false;
+        segmentByAdaptiveThresholding(preprocessedGray, mask, inverted_main_threshold);
+    } else { // Si l'image est globalement sombre ou de luminosité moyenne
+        // Utilise le seuillage global (méthode d'Otsu), souvent suffisant pour des images avec un contraste global.
+        // Seul le résultat d'Otsu sert : le seuil fixe de segmentByGlobalThresholding() n'est pas calculé.
+        threshold(preprocessedGray, mask, 0, 255, THRESH_BINARY + THRESH_OTSU);
+    }
+}
+
+/**
+ * @brief Détection des zones sombres (composants noirs).
+ * Cette étape est complémentaire au seuillage principal et vise à s'assurer que les composants sombres
+ * sont bien capturés, même si le seuillage binaire général ne les a pas parfaitement isolés.
+ * Équivaut à inRange(HSV, (0,0,0), (180,255,40)) : H et S n'étant pas contraints, seul V = max(B, G, R)
+ * est testé, directement sur l'image BGR (sans conversion complète en HSV).
+ * @param bgr L'image couleur d'entrée.
+ * @return Le masque des zones sombres, refermé par morphologie.
+ */
+cv::Mat PcbPipeline::darkAreaMask(const cv::Mat& bgr)
+{
+    Mat mask_black_areas;
+    bgrToGrayAndDarkPixels(bgr, nullptr, &mask_black_areas, kDarkMaxValue);
+    return closeDarkAreas(mask_black_areas);
+}
+
+/**
+ * @brief Referme le masque des pixels sombres.
+ * Même résultat que morphologyEx(MORPH_CLOSE) avec l'ellipse 5x5, décomposée en deux rectangles (rectmorphology).
+ * @param darkPixels Le masque des pixels sombres (non modifié).
+ * @return Le masque des zones sombres (nouvelle cv::Mat).
+ */
+cv::Mat PcbPipeline::closeDarkAreas(const cv::Mat& darkPixels)
+{
+    Mat closed;
+    closeDarkAreas(darkPixels, closed);
+    return closed;
+}
+
+/**
+ * @brief Referme le masque des pixels sombres dans `closed`.
+ * @param darkPixels Le masque des pixels sombres (non modifié).
+ * @param closed Le masque des zones sombres (sortie, tampon réutilisé s'il a la bonne taille).
+ * @param scratch Images intermédiaires de la morphologie à réutiliser (optionnel).
+ */
+void PcbPipeline::closeDarkAreas(const cv::Mat& darkPixels, cv::Mat& closed, MorphologyScratch* scratch)
+{
+    // Applique une fermeture morphologique (ellipse 5x5, 3 itérations) pour connecter les petites zones
+    // noires adjacentes et remplir les petits trous dans ces zones.
+    morphologyEllipse5x5(darkPixels, closed, MORPH_CLOSE, 3, scratch);
+}
+
+/**
+ * @brief Applique les opérations morphologiques finales pour nettoyer le masque binaire :
+ * la fermeture (remplissage des trous) puis l'ouverture (séparation).
+ * @param mask Le masque binaire, modifié sur place.
+ * @param params Les paramètres du pipeline.
+ */
+void PcbPipeline::applyMorphology(cv::Mat& mask, const PipelineParams& params)
+{
+    applyFillHoles(mask, params);
+    applySeparation(mask, params);
+}
+
+/**
+ * @brief Fermeture morphologique (MORPH_CLOSE) : remplit les petits trous à l'intérieur des objets
+ * et ferme les petites brèches. Noyau rectangulaire de taille 2*fillHolesKsize+1.
+ * Le coût par pixel ne dépend pas de la taille du noyau (voir rectmorphology).
+ * @param mask Le masque binaire, modifié sur place.
+ * @param params Les paramètres du pipeline.
+ */
+void PcbPipeline::applyFillHoles(cv::Mat& mask, const PipelineParams& params, MorphologyScratch* scratch)
+{
+    int fill_holes_ksize = params.fillHolesKsize * 2 + 1;  // Taille du noyau pour la fermeture (doit être impaire)
+    if (fill_holes_ksize > 1) { // Seulement si la taille du noyau est supérieure à 1 (pour avoir un effet)
+        morphologyRect(mask, mask, MORPH_CLOSE, Size(fill_holes_ksize, fill_holes_ksize), 1, scratch);
+    }
+}
+
+/**
+ * @brief Ouverture morphologique (MORPH_OPEN) : enlève les petits objets isolés (bruit) et sépare
+ * les objets connectés par de fins ponts. Noyau rectangulaire de taille 2*separationKsize+1.
+ * Le coût par pixel ne dépend pas de la taille du noyau (voir rectmorphology).
+ * @param mask Le masque binaire, modifié sur place.
+ * @param params Les paramètres du pipeline.
+ */
+void PcbPipeline::applySeparation(cv::Mat& mask, const PipelineParams& params, MorphologyScratch* scratch)
+{
+    int separation_ksize = params.separationKsize * 2 + 1; // Taille du noyau pour l'ouverture (doit être impaire)
+    if (separation_ksize > 1) {
+        morphologyRect(mask, mask, MORPH_OPEN, Size(separation_ksize, separation_ksize), 1, scratch);
+    }
+}
+
+/**
+ * @brief Détection finale des contours sur le masque binaire traité et filtrage par aire minimale.
+ * `RETR_EXTERNAL` ne récupère que les contours externes (les objets, pas les trous internes).
+ * @param mask Le masque binaire final.
+ * @param minArea L'aire minimale (exclue) d'un composant.
+ * @param imageSize La taille de l'image originale.
+ * @param rects Boîtes englobantes retenues (sortie).
+ * @param areas Aires correspondantes (sortie).
+ * @param extractor Méthode d'extraction (contours ou composantes connexes).
+ */
+void PcbPipeline::findComponents(const cv::Mat& mask, double minArea, const cv::Size& imageSize,
+                                 std::vector<cv::Rect>& rects, std::vector<double>& areas,
+                                 ComponentExtractor extractor)
+{
+    vector<Rect> candidate_rects;
+    vector<double> candidate_areas;
+    findComponentCandidates(mask, extractor, candidate_rects, candidate_areas);
+    filterComponents(candidate_rects, candidate_areas, minArea, imageSize, rects, areas);
+}
+
+/**
+ * @brief Trouve tous les contours externes du masque et calcule leur aire et leur boîte englobante.
+ * Aucun filtrage n'est fait ici : le résultat ne dépend que du masque et peut être mis en cache.
+ * @param mask Le masque binaire final.
+ * @param rects Boîtes englobantes de tous les contours (sortie).
+ * @param areas Aires de tous les contours (sortie).
+ */
+void PcbPipeline::findContourCandidates(const cv::Mat& mask, std::vector<cv::Rect>& rects, std::vector<double>& areas)
+{
+    vector<vector<Point>> final_contours; // Vecteur pour stocker les contours détectés
+    vector<Vec4i> hierarchy_final;      // Hiérarchie des contours
+    cv::findContours(mask, final_contours, hierarchy_final, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
+
+    rects.clear();
+    areas.clear();
+    rects.reserve(final_contours.size());
+    areas.reserve(final_contours.size());
+    for (const auto& contour : final_contours) {
+        areas.push_back(contourArea(contour));   // Aire du contour (nombre de pixels qu'il englobe)
+        rects.push_back(boundingRect(contour));  // Boîte englobante rectangulaire minimale
+    }
+}
+
+/**
+ * @brief Objets du masque par étiquetage en composantes connexes (connectedComponentsWithStats).
+ * Pour retrouver exactement les objets de RETR_EXTERNAL, les trous sont d'abord bouchés :
+ * 1. le fond est étiqueté en 4-connexité (la connexité duale de celle des objets) ; une composante du fond
+ *    qui ne touche pas le bord de l'image est un trou, entièrement entouré par un seul objet ;
+ * 2. les trous sont remplis, ce qui rattache aussi à leur objet les objets imbriqués qu'ils contiennent
+ *    (que RETR_EXTERNAL ignore) ;
+ * 3. le masque rempli est étiqueté en 8-connexité, comme le fait findContours : une composante par contour externe ;
+ * 4. l'aire est celle du polygone qui relie les centres des pixels du bord, comme contourArea() : chaque carré
+ *    de 2x2 pixels compte pour 1 s'il est plein et pour 1/2 s'il a trois pixels (le contour le coupe en diagonale),
+ *    les autres sont sur le bord ou à l'extérieur du polygone. Le nombre de pixels, plus grand d'environ la moitié
+ *    du périmètre, ferait retenir d'autres composants que les contours pour un même contourMinArea.
+ * Les deux étiquetages utilisent l'implémentation parallèle d'OpenCV (CCL_DEFAULT) et aucun vecteur de points
+ * n'est alloué, ce qui paie sur les cartes denses où les contours se comptent par dizaines de milliers.
+ * @param mask Le masque binaire final (pixels non nuls : objets).
+ * @param rects Boîtes englobantes de tous les objets (sortie).
+ * @param areas Aire de chaque objet, égale à contourArea() de son contour externe (sortie).
+ */
+void PcbPipeline::findConnectedComponentCandidates(const cv::Mat& mask, std::vector<cv::Rect>& rects, std::vector<double>& areas)
+{
+    rects.clear();
+    areas.clear();
+    if (mask.empty()) {
+        return;
+    }
+    Mat labels, stats, centroids;
+
+    // 1. Trous : composantes du fond (4-connexité) dont la boîte ne touche aucun bord
+    Mat background;
+    cv::compare(mask, 0, background, CMP_EQ);
+    const int backgroundCount = connectedComponentsWithStats(background, labels, stats, centroids, 4, CV_32S, CCL_DEFAULT);
+    vector<uchar> isHole(backgroundCount, 0); // Étiquette 0 : les objets eux-mêmes
+    bool anyHole = false;
+    for (int i = 1; i < backgroundCount; ++i) {
+        const int x = stats.at<int>(i, CC_STAT_LEFT), y = stats.at<int>(i, CC_STAT_TOP);
+        const int w = stats.at<int>(i, CC_STAT_WIDTH), h = stats.at<int>(i, CC_STAT_HEIGHT);
+        isHole[i] = x > 0 && y > 0 && x + w < mask.cols && y + h < mask.rows;
+        anyHole = anyHole || isHole[i];
+    }
+
+    // 2. Masque rempli (le masque d'entrée n'est pas modifié ; il est réutilisé tel quel s'il n'a aucun trou)
+    Mat filled = mask;
+    if (anyHole) {
+        filled = mask.clone();
+        parallel_for_(Range(0, mask.rows), [&](const Range& range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const int* label = labels.ptr<int>(y);
+                uchar* out = filled.ptr<uchar>(y);
+                for (int x = 0; x < mask.cols; ++x) {
+                    if (isHole[label[x]]) out[x] = 255;
+                }
+            }
+        });
+    }
+
+    // 3. Objets externes (8-connexité) : boîte de chaque étiquette
+    const int count = connectedComponentsWithStats(filled, labels, stats, centroids, 8, CV_32S, CCL_DEFAULT);
+
+    // 4. Double de l'aire du polygone de chaque étiquette : 2 par carré 2x2 plein, 1 par carré à trois pixels.
+    // Les pixels d'un même carré sont voisins (8-connexité) : ils portent tous la même étiquette, la plus grande
+    // des quatre (le fond vaut 0). Chaque bande de lignes accumule dans son propre tableau, fusionné ensuite.
+    vector<long long> twiceArea(count, 0);
+    std::mutex mergeMutex;
+    parallel_for_(Range(0, std::max(0, mask.rows - 1)), [&](const Range& range) {
+        vector<long long> local(count, 0);
+        for (int y = range.start; y < range.end; ++y) {
+            const uchar* top = filled.ptr<uchar>(y);
+            const uchar* bottom = filled.ptr<uchar>(y + 1);
+            const int* topLabel = labels.ptr<int>(y);
+            const int* bottomLabel = labels.ptr<int>(y + 1);
+            for (int x = 0; x + 1 < mask.cols; ++x) {
+                const int setCount = (top[x] != 0) + (top[x + 1] != 0) + (bottom[x] != 0) + (bottom[x + 1] != 0);
+                if (setCount >= 3) {
+                    const int label = std::max(std::max(topLabel[x], topLabel[x + 1]),
+                                               std::max(bottomLabel[x], bottomLabel[x + 1]));
+                    local[label] += setCount == 4 ? 2 : 1;
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        for (int i = 1; i < count; ++i) {
+            twiceArea[i] += local[i];
+        }
+    }, getNumThreads()); // Une bande par thread : autant de tableaux locaux que de threads
+
+    rects.reserve(count > 0 ? count - 1 : 0);
+    areas.reserve(count > 0 ? count - 1 : 0);
+    for (int i = 1; i < count; ++i) { // L'étiquette 0 est le fond
+        rects.emplace_back(stats.at<int>(i, CC_STAT_LEFT), stats.at<int>(i, CC_STAT_TOP),
+                           stats.at<int>(i, CC_STAT_WIDTH), stats.at<int>(i, CC_STAT_HEIGHT));
+        areas.push_back(twiceArea[i] / 2.0);
+    }
+}
+
+/**
+ * @brief Aiguille vers la méthode d'extraction choisie dans les paramètres.
+ */
+void PcbPipeline::findComponentCandidates(const cv::Mat& mask, ComponentExtractor extractor,
+                                          std::vector<cv::Rect>& rects, std::vector<double>& areas)
+{
+    if (extractor == ComponentExtractor::ConnectedComponents) {
+        findConnectedComponentCandidates(mask, rects, areas);
+    } else {
+        findContourCandidates(mask, rects, areas);
+    }
+}
+
+/**
+ * @brief Filtre les contours candidats par aire minimale (les petits bruits sont éliminés).
+ * @param candidateRects Boîtes de tous les contours.
+ * @param candidateAreas Aires de tous les contours.
+ * @param minArea L'aire minimale (exclue) d'un composant.
+ * @param imageSize La taille de l'image originale.
+ * @param rects Boîtes englobantes retenues (sortie).
+ * @param areas Aires correspondantes (sortie).
+ */
+void PcbPipeline::filterComponents(const std::vector<cv::Rect>& candidateRects, const std::vector<double>& candidateAreas,
+                                   double minArea, const cv::Size& imageSize,
+                                   std::vector<cv::Rect>& rects, std::vector<double>& areas)
+{
+    rects.clear();
+    areas.clear();
+    for (size_t i = 0; i < candidateRects.size(); ++i) {
+        const double area = candidateAreas[i];
+        if (area > minArea) {
+            const Rect& box = candidateRects[i];
+            // S'assurer que la boîte englobante est entièrement contenue dans les limites de l'image originale,
+            // pour éviter les erreurs d'accès mémoire lors de l'extraction de ROI.
+            if (box.x >= 0 && box.y >= 0 && box.width > 0 && box.height > 0 &&
+                box.x + box.width <= imageSize.width &&
+                box.y + box.height <= imageSize.height) {
+                rects.push_back(box);
+                areas.push_back(area);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Prépare les images de sortie : l'image originale annotée et les composants sur fond blanc.
+ * @param bgr L'image originale.
+ * @param rects Les boîtes englobantes des composants (l'indice sert de numéro affiché).
+ * @param contoursImage Image annotée (sortie).
+ * @param extractedOnBlank Composants copiés sur fond blanc (sortie).
+ */
+void PcbPipeline::renderResults(const cv::Mat& bgr, const std::vector<cv::Rect>& rects,
+                                cv::Mat& contoursImage, cv::Mat& extractedOnBlank)
+{
+    // `contoursImage` affichera l'image originale avec les boîtes englobantes dessinées.
+    bgr.copyTo(contoursImage);
+    // `extractedOnBlank` est une image blanche sur laquelle les composants détectés seront copiés.
+    extractedOnBlank.create(bgr.size(), bgr.type());
+    extractedOnBlank.setTo(Scalar(255, 255, 255));
+
+    for (size_t index = 0; index < rects.size(); ++index) {
+        const Rect& box = rects[index];
+        // Dessine le rectangle rouge et le numéro du composant en vert
+        cv::rectangle(contoursImage, box, Scalar(0, 0, 255), 2);
+        cv::putText(contoursImage, to_string(index), box.tl(), FONT_HERSHEY_SIMPLEX, 0.6, Scalar(0, 255, 0), 1);
+
+        // Copie le composant extrait (ROI de l'image originale) sur le fond blanc.
+        // Les deux images ont le même type puisque le fond est créé à partir de l'originale.
+        bgr(box).copyTo(extractedOnBlank(box));
+    }
+}
+
+/**
+ * @brief Lance le pipeline complet de traitement d'image et de détection de composants.
+ * Applique les opérations (flou, CLAHE, seuillage, zones sombres, morphologie, détection de contours)
+ * et prépare les résultats (images et liste de composants).
+ *
+ * Chaque étape n'est recalculée que si l'un des paramètres qu'elle lit, ou une étape amont, a changé
+ * depuis l'exécution précédente (voir StageCache). Une étape recalculée réécrit le tampon de son image
+ * seulement si personne d'autre ne le détient (PipelineWorkspace::prepare()) : les résultats déjà remis
+ * à l'appelant ne sont jamais modifiés, et les autres tampons ne sont pas réalloués à chaque passage.
+ * Entre deux étapes, le jeton d'annulation est consulté pour abandonner au plus tôt une demande obsolète ;
+ * les étapes déjà terminées restent dans le cache.
+ * @param params Les paramètres du pipeline.
+ * @param token Jeton d'annulation de la demande.
+ * @return Le résultat de la détection (incomplet si la demande a été annulée).
+ */
+DetectionResult PcbPipeline::run(const PipelineParams& params, const CancellationToken& token)
+{
+    if (m_image.empty() || token.isCancelled()) {
+        return DetectionResult(); // Rien à traiter, ou demande déjà remplacée
+    }
+    StageCache& c = m_cache;
+    PipelineWorkspace& ws = m_workspace;
+    const Size size = m_image.size();
+    ws.beginRun();
+    PipelineProfiler::instance().beginRun();
+    ScopedStageTimer totalTimer("pipeline_total"); // Durée totale du passage (étapes en cache comprises)
+
+    // 1. Niveaux de gris et pixels sombres, en une passe (dépendent uniquement de l'image)
+    if (!c.grayValid) {
+        ScopedStageTimer timer("gray");
+        ws.prepare(c.gray, size, CV_8UC1);
+        ws.prepare(c.darkPixels, size, CV_8UC1);
+        toGrayAndDarkPixels(m_image, c.gray, c.darkPixels);
+        c.grayValid = true;
+        c.blurredValid = false;
+        c.darkMaskValid = false;
+    }
+
+    // 2. Flou gaussien (blurKsize, sigmaX)
+    if (!c.blurredValid || c.blurKsize != params.blurKsize || c.sigmaX != params.sigmaX) {
+        ScopedStageTimer timer("gaussian_blur");
+        ws.prepare(c.blurred, size, CV_8UC1);
+        applyGaussianBlur(c.gray, c.blurred, params);
+        c.blurKsize = params.blurKsize;
+        c.sigmaX = params.sigmaX;
+        c.blurredValid = true;
+        c.preprocessedValid = false;
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 3. CLAHE (claheClipLimit)
+    if (!c.preprocessedValid || c.claheClipLimit != params.claheClipLimit) {
+        ScopedStageTimer timer("clahe");
+        ws.prepare(c.preprocessed, size, CV_8UC1);
+        ws.clahe(params.claheClipLimit / 10.0)->apply(c.blurred, c.preprocessed); // Même réglage que applyClahe()
+        c.claheClipLimit = params.claheClipLimit;
+        c.preprocessedValid = true;
+        c.thresholdValid = false;
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 4. Seuillage principal (adaptatif ou Otsu selon la luminosité ; aucun paramètre)
+    if (!c.thresholdValid) {
+        ScopedStageTimer timer("threshold");
+        ws.prepare(c.threshold, size, CV_8UC1);
+        segment(c.preprocessed, c.threshold);
+        c.thresholdValid = true;
+        c.closedValid = false;
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 5. Zones sombres : fermeture des pixels sombres de l'étape 1
+    if (!c.darkMaskValid) {
+        ScopedStageTimer timer("dark_mask");
+        ws.prepare(c.darkMask, size, CV_8UC1);
+        closeDarkAreas(c.darkPixels, c.darkMask, &ws.morphology());
+        c.darkMaskValid = true;
+        c.closedValid = false;
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 6. Combinaison (OR bit à bit) puis fermeture pour remplir les trous (fillHolesKsize)
+    // Cela permet d'inclure tous les objets détectés par l'une ou l'autre des méthodes.
+    if (!c.closedValid || c.fillHolesKsize != params.fillHolesKsize) {
+        ScopedStageTimer timer("combine_fill_holes");
+        ws.prepare(c.closed, size, CV_8UC1);
+        cv::bitwise_or(c.threshold, c.darkMask, c.closed); // Tampon interne, jamais remis à l'appelant
+        applyFillHoles(c.closed, params, &ws.morphology());
+        c.fillHolesKsize = params.fillHolesKsize;
+        c.closedValid = true;
+        c.openedValid = false;
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 7. Ouverture pour séparer les objets (separationKsize) : c'est le masque final
+    if (!c.openedValid || c.separationKsize != params.separationKsize) {
+        ScopedStageTimer timer("separation");
+        c.result.mask.release(); // Le résultat précédent sera refait : seul l'appelant peut encore détenir ce masque
+        ws.prepare(c.opened, size, CV_8UC1);
+        c.closed.copyTo(c.opened);
+        applySeparation(c.opened, params, &ws.morphology());
+        c.separationKsize = params.separationKsize;
+        c.openedValid = true;
+        c.candidatesValid = false;
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 8. Contours externes, aires et boîtes (sans filtrage), selon la méthode d'extraction (extractor)
+    if (!c.candidatesValid || c.extractor != params.extractor) {
+        ScopedStageTimer timer("find_contours");
+        findComponentCandidates(c.opened, params.extractor, c.candidateRects, c.candidateAreas);
+        c.extractor = params.extractor;
+        c.candidatesValid = true;
+        c.resultValid = false;
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 9. Filtrage par aire minimale (contourMinArea) et rendu des images de sortie
+    // Les images du résultat précédent sont réécrites sur place si l'appelant ne les détient plus.
+    if (!c.resultValid || c.contourMinArea != params.contourMinArea) {
+        DetectionResult& result = c.result;
+        result.mask = c.opened;
+        {
+            ScopedStageTimer timer("filter_components");
+            filterComponents(c.candidateRects, c.candidateAreas, params.contourMinArea, m_image.size(),
+                             result.rects, result.areas);
+        }
+        ScopedStageTimer timer("render_results");
+        ws.prepare(result.contoursImage, size, m_image.type());
+        ws.prepare(result.extractedComponentsOnBlank, size, m_image.type());
+        renderResults(m_image, result.rects, result.contoursImage, result.extractedComponentsOnBlank);
+        c.contourMinArea = params.contourMinArea;
+        c.resultValid = true;
+    }
+
+    return c.result;
+}
@@ -0,0 +1,260 @@
+// pcbpipeline.h
+#ifndef PCBPIPELINE_H
+#define PCBPIPELINE_H
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "pipelineparams.h"
+#include "detectionresult.h"
+#include "cancellationtoken.h"
+#include "pipelineworkspace.h"
+
+/**
+ * @brief La classe PcbPipeline contient la logique de traitement d'image OpenCV et la détection
+ * de composants, indépendamment de toute interface graphique.
+ * Elle ne dépend pas de Qt : elle peut être utilisée par ImageWindow, par un outil en ligne
+ * de commande, dans un thread de travail ou dans un benchmark.
+ *
+ * Chaque étape du pipeline est aussi exposée sous forme de fonction statique afin de pouvoir
+ * être appelée (et mesurée) séparément.
+ *
+ * Entre deux appels à run(), le pipeline conserve le résultat de chaque étape avec les paramètres
+ * qu'elle a lus : seules les étapes dont un paramètre (ou une étape amont) a changé sont recalculées.
+ * Par exemple, changer l'aire minimale ne refait que le filtrage des contours et le rendu.
+ *
+ * Les images des étapes recalculées réutilisent leurs tampons (voir PipelineWorkspace), y compris après
+ * un changement d'image de même taille : seuls les tampons encore détenus par l'appelant sont réalloués.
+ */
+class PcbPipeline
+{
+public:
+    PcbPipeline() = default;
+
+    /**
+     * @brief Définit l'image couleur (BGR) sur laquelle le pipeline travaille.
+     * L'image n'est pas copiée : elle ne doit pas être modifiée tant que le pipeline l'utilise.
+     * Le cache des étapes est invalidé si l'image est différente de la précédente (ses tampons sont gardés
+     * pour être réutilisés), et libéré si l'image est vide.
+     * @param image L'image OpenCV d'entrée.
+     */
+    void setImage(const cv::Mat& image);
+
+    /**
+     * @brief Vide le cache des étapes (libère les images intermédiaires et l'espace de travail).
+     */
+    void clearCache();
+
+    /**
+     * @brief Espace de travail du pipeline (compteurs d'allocation des tampons).
+     */
+    const PipelineWorkspace& workspace() const { return m_workspace; }
+
+    /**
+     * @brief Retourne l'image d'entrée actuellement définie.
+     */
+    const cv::Mat& image() const { return m_image; }
+
+    /**
+     * @brief Lance le pipeline complet sur l'image définie par setImage().
+     * Le jeton est consulté entre chaque étape : si la demande est annulée, le pipeline
+     * s'arrête au plus tôt et le résultat retourné est incomplet (à ignorer).
+     * @param params Les paramètres du pipeline (valeurs des sliders).
+     * @param token Jeton d'annulation (par défaut : jamais annulé).
+     * @return Le résultat de la détection (vide si aucune image n'est définie).
+     */
+    DetectionResult run(const PipelineParams& params, const CancellationToken& token = CancellationToken());
+
+    // --- Étapes individuelles du pipeline ---
+
+    /**
+     * @brief Valeur V (HSV) maximale d'un pixel considéré comme sombre.
+     */
+    static constexpr int kDarkMaxValue = 40;
+
+    /**
+     * @brief Convertit une image BGR en niveaux de gris (même résultat que cvtColor(COLOR_BGR2GRAY)).
+     */
+    static cv::Mat toGray(const cv::Mat& bgr);
+
+    /**
+     * @brief Niveaux de gris et pixels sombres (V <= kDarkMaxValue) en une seule lecture de l'image.
+     * @param bgr L'image couleur d'entrée.
+     * @param gray Sortie niveaux de gris.
+     * @param darkPixels Sortie masque des pixels sombres, avant fermeture (voir closeDarkAreas()).
+     */
+    static void toGrayAndDarkPixels(const cv::Mat& bgr, cv::Mat& gray, cv::Mat& darkPixels);
+
+    /**
+     * @brief Applique le flou gaussien (noyau 2*N+1, sigmaX / 10.0) sur place.
+     */
+    static void applyGaussianBlur(cv::Mat& gray, const PipelineParams& params);
+
+    /**
+     * @brief Flou gaussien de `src` vers `dst` (le tampon de `dst` est réutilisé s'il a la bonne taille).
+     */
+    static void applyGaussianBlur(const cv::Mat& src, cv::Mat& dst, const PipelineParams& params);
+
+    /**
+     * @brief Applique l'égalisation CLAHE (clipLimit / 10.0) sur place.
+     */
+    static void applyClahe(cv::Mat& gray, const PipelineParams& params);
+
+    /**
+     * @brief Enchaîne niveaux de gris, flou gaussien et CLAHE : produit l'image "masque" prétraitée.
+     * @param bgr L'image couleur d'entrée.
+     * @param params Les paramètres du pipeline.
+     * @return L'image en niveaux de gris prétraitée.
+     */
+    static cv::Mat preprocess(const cv::Mat& bgr, const PipelineParams& params);
+
+    /**
+     * @brief Segmente une image en niveaux de gris en utilisant le seuillage adaptatif.
+     * La version (binaire ou binaire inverse) qui produit le plus de contours est choisie.
+     * @param img_gray Image d'entrée en niveaux de gris.
+     * @param thresholded Image de sortie seuillée (le résultat sélectionné).
+     * @param inverted Vrai si THRESH_BINARY_INV a été choisi.
+     */
+    static void segmentByAdaptiveThresholding(const cv::Mat& img_gray, cv::Mat& thresholded, bool& inverted);
+
+    /**
+     * @brief Segmente une image en niveaux de gris avec un seuil fixe (117) et la méthode d'Otsu.
+     * @param img_gray Image d'entrée en niveaux de gris.
+     * @param simple_thresholded Image de sortie seuillée avec le seuil fixe.
+     * @param otsu_thresholded Image de sortie seuillée avec Otsu.
+     * @param otsu_thresh Valeur du seuil calculée par Otsu (sortie).
+     */
+    static void segmentByGlobalThresholding(const cv::Mat& img_gray, cv::Mat& simple_thresholded, cv::Mat& otsu_thresholded, double& otsu_thresh);
+
+    /**
+     * @brief Choisit le seuillage (adaptatif si l'image est lumineuse, Otsu sinon) et l'applique.
+     * @param preprocessedGray L'image en niveaux de gris prétraitée.
+     * @return Le masque binaire du seuillage principal.
+     */
+    static cv::Mat segment(const cv::Mat& preprocessedGray);
+
+    /**
+     * @brief Même seuillage, écrit dans `mask` (son tampon est réutilisé s'il a la bonne taille).
+     */
+    static void segment(const cv::Mat& preprocessedGray, cv::Mat& mask);
+
+    /**
+     * @brief Détecte les zones sombres (V <= 40 en HSV) puis les referme (ellipse 5x5, 3 itérations).
+     * @param bgr L'image couleur d'entrée.
+     * @return Le masque des zones sombres.
+     */
+    static cv::Mat darkAreaMask(const cv::Mat& bgr);
+
+    /**
+     * @brief Referme le masque des pixels sombres (ellipse 5x5, 3 itérations).
+     * @return Le masque des zones sombres (nouvelle cv::Mat, l'entrée n'est pas modifiée).
+     */
+    static cv::Mat closeDarkAreas(const cv::Mat& darkPixels);
+
+    /**
+     * @brief Même fermeture, écrite dans `closed`, avec des images intermédiaires réutilisables.
+     */
+    static void closeDarkAreas(const cv::Mat& darkPixels, cv::Mat& closed, MorphologyScratch* scratch = nullptr);
+
+    /**
+     * @brief Applique la fermeture (remplissage des trous) puis l'ouverture (séparation) sur place.
+     */
+    static void applyMorphology(cv::Mat& mask, const PipelineParams& params);
+
+    /**
+     * @brief Fermeture seule (remplissage des trous, fillHolesKsize), sur place.
+     * @param scratch Images intermédiaires à réutiliser (nullptr : allouées pour cet appel).
+     */
+    static void applyFillHoles(cv::Mat& mask, const PipelineParams& params, MorphologyScratch* scratch = nullptr);
+
+    /**
+     * @brief Ouverture seule (séparation, separationKsize), sur place.
+     * @param scratch Images intermédiaires à réutiliser (nullptr : allouées pour cet appel).
+     */
+    static void applySeparation(cv::Mat& mask, const PipelineParams& params, MorphologyScratch* scratch = nullptr);
+
+    /**
+     * @brief Trouve les contours externes du masque et retient ceux dont l'aire dépasse le minimum.
+     * @param mask Le masque binaire final.
+     * @param minArea L'aire minimale (exclue) d'un composant.
+     * @param imageSize La taille de l'image originale (pour valider les boîtes).
+     * @param rects Boîtes englobantes retenues (sortie).
+     * @param areas Aires correspondantes (sortie).
+     * @param extractor Méthode d'extraction.
+     */
+    static void findComponents(const cv::Mat& mask, double minArea, const cv::Size& imageSize,
+                               std::vector<cv::Rect>& rects, std::vector<double>& areas,
+                               ComponentExtractor extractor = ComponentExtractor::Contours);
+
+    /**
+     * @brief Trouve tous les contours externes du masque, sans filtrage (boîtes et aires).
+     */
+    static void findContourCandidates(const cv::Mat& mask, std::vector<cv::Rect>& rects, std::vector<double>& areas);
+
+    /**
+     * @brief Même objets que findContourCandidates(), par étiquetage en composantes connexes.
+     * Aucun contour n'est construit : les boîtes viennent des statistiques de l'étiquetage et les aires d'une passe
+     * sur les étiquettes. Boîtes et aires sont identiques à celles de contourArea() (le même contourMinArea retient
+     * donc les mêmes composants avec les deux méthodes) ; seul l'ordre diffère.
+     */
+    static void findConnectedComponentCandidates(const cv::Mat& mask, std::vector<cv::Rect>& rects, std::vector<double>& areas);
+
+    /**
+     * @brief Trouve tous les objets du masque avec la méthode d'extraction demandée, sans filtrage.
+     */
+    static void findComponentCandidates(const cv::Mat& mask, ComponentExtractor extractor,
+                                        std::vector<cv::Rect>& rects, std::vector<double>& areas);
+
+    /**
+     * @brief Retient les candidats dont l'aire dépasse le minimum et dont la boîte est dans l'image.
+     */
+    static void filterComponents(const std::vector<cv::Rect>& candidateRects, const std::vector<double>& candidateAreas,
+                                 double minArea, const cv::Size& imageSize,
+                                 std::vector<cv::Rect>& rects, std::vector<double>& areas);
+
+    /**
+     * @brief Produit l'image annotée et l'image des composants extraits sur fond blanc.
+     * Les deux sorties sont réécrites sur place si elles ont déjà la taille et le type de `bgr` :
+     * elles ne doivent pas partager leurs pixels avec une image encore utilisée ailleurs.
+     * @param bgr L'image originale.
+     * @param rects Les boîtes englobantes des composants.
+     * @param contoursImage Image annotée (sortie).
+     * @param extractedOnBlank Composants copiés sur fond blanc (sortie).
+     */
+    static void renderResults(const cv::Mat& bgr, const std::vector<cv::Rect>& rects,
+                              cv::Mat& contoursImage, cv::Mat& extractedOnBlank);
+
+private:
+    /**
+     * @brief Résultats intermédiaires conservés entre deux exécutions.
+     * Chaque étape garde les paramètres qu'elle a lus ; un indicateur "valid" faux force son recalcul.
+     * Une étape recalculée invalide les étapes qui en dépendent (et seulement celles-ci) :
+     *   gris -> flou (blurKsize, sigmaX) -> CLAHE (claheClipLimit) -> seuillage ┐
+     *   pixels sombres -> fermeture ─────────────────────────────────────────────┴-> fermeture (fillHolesKsize)
+     *   -> ouverture (separationKsize) -> contours (extractor) -> filtrage + rendu (contourMinArea)
+     *   (gris et pixels sombres ne dépendent que de l'image : ils sont calculés ensemble, en une passe)
+     */
+    struct StageCache
+    {
+        bool grayValid = false;         cv::Mat gray;         cv::Mat darkPixels; // Calculés ensemble
+        bool blurredValid = false;      cv::Mat blurred;      int blurKsize = 0; int sigmaX = 0;
+        bool preprocessedValid = false; cv::Mat preprocessed; int claheClipLimit = 0;
+        bool thresholdValid = false;    cv::Mat threshold;
+        bool darkMaskValid = false;     cv::Mat darkMask;
+        bool closedValid = false;       cv::Mat closed;       int fillHolesKsize = 0;
+        bool openedValid = false;       cv::Mat opened;       int separationKsize = 0;
+        bool candidatesValid = false;   std::vector<cv::Rect> candidateRects; std::vector<double> candidateAreas;
+                                        ComponentExtractor extractor = ComponentExtractor::Contours;
+        bool resultValid = false;       DetectionResult result; int contourMinArea = 0;
+    };
+
+    /**
+     * @brief Invalide toutes les étapes en gardant leurs tampons (nouvelle image).
+     */
+    void invalidateCache();
+
+    cv::Mat m_image;     // L'image couleur d'entrée (partagée, non copiée)
+    StageCache m_cache;  // Résultats intermédiaires de la dernière exécution
+    PipelineWorkspace m_workspace; // Objet CLAHE, images intermédiaires de la morphologie, compteurs d'allocation
+};
+
+#endif // PCBPIPELINE_H
@@ -0,0 +1,129 @@
+// pipelineparams.cpp
+#include "pipelineparams.h"
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+
+namespace {
+
+// Retire les espaces en début et en fin de chaîne
+std::string trimmed(const std::string& text)
+{
+    const char* spaces = " \t\r\n";
+    const std::size_t begin = text.find_first_not_of(spaces);
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const std::size_t end = text.find_last_not_of(spaces);
+    return text.substr(begin, end - begin + 1);
+}
+
+// Retourne l'adresse du champ de PipelineParams correspondant à une clé, ou nullptr si la clé est inconnue
+int* fieldForKey(PipelineParams& params, const std::string& key)
+{
+    if (key == "blurKsize") return &params.blurKsize;
+    if (key == "sigmaX") return &params.sigmaX;
+    if (key == "claheClipLimit") return &params.claheClipLimit;
+    if (key == "separationKsize") return &params.separationKsize;
+    if (key == "fillHolesKsize") return &params.fillHolesKsize;
+    if (key == "contourMinArea") return &params.contourMinArea;
+    return nullptr;
+}
+
+} // namespace
+
+const char* componentExtractorName(ComponentExtractor extractor)
+{
+    switch (extractor) {
+    case ComponentExtractor::ConnectedComponents: return "connected_components";
+    case ComponentExtractor::Contours: break;
+    }
+    return "contours";
+}
+
+bool parseComponentExtractor(const std::string& name, ComponentExtractor& extractor)
+{
+    for (ComponentExtractor candidate : { ComponentExtractor::Contours, ComponentExtractor::ConnectedComponents }) {
+        if (name == componentExtractorName(candidate)) {
+            extractor = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Lit un fichier de paramètres "clé = valeur".
+ * @param path Chemin du fichier.
+ * @param params Paramètres à compléter (les clés absentes ne sont pas modifiées).
+ * @param error Message d'erreur en cas d'échec (optionnel).
+ * @return true si toutes les lignes ont été comprises.
+ */
+bool loadPipelineParams(const std::string& path, PipelineParams& params, std::string* error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    PipelineParams loaded = params; // Les paramètres ne sont modifiés que si tout le fichier est valide
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trimmed(line);
+        if (line.empty() || line[0] == '#') {
+            continue; // Ligne vide ou commentaire
+        }
+        const std::size_t equal = line.find('=');
+        if (equal != std::string::npos && trimmed(line.substr(0, equal)) == "extractor") {
+            // Seule clé dont la valeur est un nom et non un entier
+            if (!parseComponentExtractor(trimmed(line.substr(equal + 1)), loaded.extractor)) {
+                if (error) *error = path + ":" + std::to_string(lineNumber) + ": unknown extractor in '" + line + "'";
+                return false;
+            }
+            continue;
+        }
+        int* field = equal == std::string::npos ? nullptr : fieldForKey(loaded, trimmed(line.substr(0, equal)));
+        std::istringstream value(trimmed(equal == std::string::npos ? std::string() : line.substr(equal + 1)));
+        int parsed = 0;
+        char extra = 0;
+        if (!field || !(value >> parsed) || (value >> extra)) {
+            // Clé inconnue, valeur absente ou suivie d'autres caractères ("5abc", "3.7")
+            if (error) *error = path + ":" + std::to_string(lineNumber) + ": invalid line '" + line + "'";
+            return false;
+        }
+        if (parsed < 0) {
+            // Toutes les valeurs sont des positions de sliders : une valeur négative ferait échouer chaque image
+            if (error) *error = path + ":" + std::to_string(lineNumber) + ": negative value in '" + line + "'";
+            return false;
+        }
+        *field = parsed;
+    }
+    params = loaded;
+    return true;
+}
+
+/**
+ * @brief Écrit les paramètres au format "clé = valeur".
+ * @param path Chemin du fichier.
+ * @param params Paramètres à écrire.
+ * @return true si l'écriture a réussi.
+ */
+bool savePipelineParams(const std::string& path, const PipelineParams& params)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "# PCB_PROJECT pipeline parameters (raw slider values)\n"
+         << "blurKsize = " << params.blurKsize << "\n"
+         << "sigmaX = " << params.sigmaX << "\n"
+         << "claheClipLimit = " << params.claheClipLimit << "\n"
+         << "separationKsize = " << params.separationKsize << "\n"
+         << "fillHolesKsize = " << params.fillHolesKsize << "\n"
+         << "contourMinArea = " << params.contourMinArea << "\n"
+         << "extractor = " << componentExtractorName(params.extractor) << "\n";
+    return static_cast<bool>(file);
+}
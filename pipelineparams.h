@@ -0,0 +1,78 @@
+// pipelineparams.h
+#ifndef PIPELINEPARAMS_H
+#define PIPELINEPARAMS_H
+
+#include <string>
+
+/**
+ * @brief Méthode d'extraction des composants du masque final (dernière étape du pipeline).
+ */
+enum class ComponentExtractor
+{
+    Contours,            // findContours(RETR_EXTERNAL), puis contourArea et boundingRect de chaque contour
+    ConnectedComponents  // Étiquetage en composantes connexes : aires et boîtes sans construire de contours
+};
+
+/**
+ * @brief Nom d'une méthode d'extraction dans les fichiers de paramètres et en ligne de commande
+ * ("contours" ou "connected_components").
+ */
+const char* componentExtractorName(ComponentExtractor extractor);
+
+/**
+ * @brief Lit un nom produit par componentExtractorName().
+ * @return false si le nom est inconnu (`extractor` n'est alors pas modifié).
+ */
+bool parseComponentExtractor(const std::string& name, ComponentExtractor& extractor);
+
+/**
+ * @brief La structure PipelineParams regroupe les six paramètres du pipeline de détection
+ * (les valeurs brutes des sliders de MainWindow) et la méthode d'extraction des composants.
+ * Elle ne dépend ni de Qt ni d'une fenêtre : elle peut être copiée librement entre threads,
+ * sauvegardée ou comparée pour savoir si un nouveau traitement est nécessaire.
+ * Les valeurs par défaut correspondent aux positions initiales des sliders.
+ */
+struct PipelineParams
+{
+    int blurKsize = 1;        // Taille du noyau pour le flou gaussien (sera convertie en 2*N+1)
+    int sigmaX = 5;           // Écart-type en X pour le flou gaussien (sera divisé par 10.0)
+    int claheClipLimit = 15;  // Limite de coupure pour l'algorithme CLAHE (sera divisée par 10.0)
+    int separationKsize = 3;  // Taille du noyau pour l'ouverture morphologique (séparation, 2*N+1)
+    int fillHolesKsize = 1;   // Taille du noyau pour la fermeture morphologique (remplissage des trous, 2*N+1)
+    int contourMinArea = 50;  // Aire minimale pour filtrer les contours détectés
+    ComponentExtractor extractor = ComponentExtractor::Contours; // Pas un slider : menu Tools ou fichier de paramètres
+
+    bool operator==(const PipelineParams& other) const {
+        return blurKsize == other.blurKsize
+               && sigmaX == other.sigmaX
+               && claheClipLimit == other.claheClipLimit
+               && separationKsize == other.separationKsize
+               && fillHolesKsize == other.fillHolesKsize
+               && contourMinArea == other.contourMinArea
+               && extractor == other.extractor;
+    }
+    bool operator!=(const PipelineParams& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Lit un fichier de paramètres au format texte "clé = valeur" (une clé par ligne).
+ * Les clés sont les noms des champs de PipelineParams (blurKsize, sigmaX, ...) ; la valeur de `extractor`
+ * est un nom (voir componentExtractorName()), les autres sont des entiers positifs ou nuls, sans autre
+ * caractère après le nombre ("5abc" ou "3.7" sont refusés). Les lignes vides
+ * et celles commençant par '#' sont ignorées. Les clés absentes gardent leur valeur actuelle.
+ * @param path Chemin du fichier.
+ * @param params Paramètres à compléter (entrée/sortie).
+ * @param error Message d'erreur en cas d'échec (optionnel).
+ * @return true si le fichier a été lu sans erreur.
+ */
+bool loadPipelineParams(const std::string& path, PipelineParams& params, std::string* error = nullptr);
+
+/**
+ * @brief Écrit les paramètres dans un fichier texte lisible par loadPipelineParams().
+ * @param path Chemin du fichier.
+ * @param params Paramètres à écrire.
+ * @return true si l'écriture a réussi.
+ */
+bool savePipelineParams(const std::string& path, const PipelineParams& params);
+
+#endif // PIPELINEPARAMS_H
@@ -0,0 +1,167 @@
+// pipelineprofiler.cpp
+#include "pipelineprofiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+// Percentile par la méthode du rang le plus proche ; `sorted` est trié et non vide
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const std::size_t rank = static_cast<std::size_t>(p / 100.0 * sorted.size() + 0.5);
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+// Échappe les caractères spéciaux d'une chaîne JSON (les noms d'étapes sont des identifiants simples)
+std::string jsonString(const std::string& text)
+{
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+/**
+ * @brief Retourne l'instance unique (créée au premier appel, thread-safe en C++11).
+ */
+PipelineProfiler& PipelineProfiler::instance()
+{
+    static PipelineProfiler profiler;
+    return profiler;
+}
+
+/**
+ * @brief Début d'un passage : vide la décomposition du dernier passage.
+ */
+void PipelineProfiler::beginRun()
+{
+    if (!isEnabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastRun.clear();
+    ++m_runs;
+}
+
+/**
+ * @brief Ajoute une mesure à la fenêtre glissante de l'étape et au passage courant.
+ */
+void PipelineProfiler::record(const char* stage, double ms)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_history.begin(), m_history.end(),
+                           [stage](const StageHistory& h) { return h.stage == stage; });
+    if (it == m_history.end()) {
+        m_history.push_back(StageHistory{stage, {}, 0, 0, 0.0});
+        it = m_history.end() - 1;
+        it->window.reserve(kWindowSize);
+    }
+    if (it->window.size() < kWindowSize) {
+        it->window.push_back(ms);
+    } else {
+        it->window[it->next] = ms;
+    }
+    it->next = (it->next + 1) % kWindowSize;
+    ++it->count;
+    it->lastMs = ms;
+    m_lastRun.push_back(StageSample{stage, ms});
+}
+
+/**
+ * @brief Copie de la décomposition du passage courant.
+ */
+std::vector<StageSample> PipelineProfiler::lastRun() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastRun;
+}
+
+/**
+ * @brief Calcule moyenne, percentiles et maximum de chaque étape sur sa fenêtre glissante.
+ */
+std::vector<StageStats> PipelineProfiler::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<StageStats> stats;
+    stats.reserve(m_history.size());
+    for (const StageHistory& h : m_history) {
+        if (h.window.empty()) {
+            continue;
+        }
+        std::vector<double> sorted = h.window;
+        std::sort(sorted.begin(), sorted.end());
+        StageStats s;
+        s.stage = h.stage;
+        s.count = h.count;
+        s.lastMs = h.lastMs;
+        double sum = 0.0;
+        for (double v : sorted) sum += v;
+        s.meanMs = sum / sorted.size();
+        s.p50Ms = percentile(sorted, 50);
+        s.p95Ms = percentile(sorted, 95);
+        s.p99Ms = percentile(sorted, 99);
+        s.maxMs = sorted.back();
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+/**
+ * @brief Écrit les statistiques de chaque étape puis la décomposition du dernier passage.
+ */
+bool PipelineProfiler::writeJson(const std::string& path, std::string* error) const
+{
+    const std::vector<StageStats> stats = statistics();
+    const std::vector<StageSample> last = lastRun();
+    std::size_t runs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        runs = m_runs;
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        if (error) *error = "Cannot open " + path + " for writing";
+        return false;
+    }
+    file << std::fixed << std::setprecision(4);
+    file << "{\n  \"runs\": " << runs << ",\n  \"window\": " << kWindowSize << ",\n  \"stages\": [\n";
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        const StageStats& s = stats[i];
+        file << "    {\"name\": " << jsonString(s.stage) << ", \"count\": " << s.count
+             << ", \"last_ms\": " << s.lastMs << ", \"mean_ms\": " << s.meanMs
+             << ", \"p50_ms\": " << s.p50Ms << ", \"p95_ms\": " << s.p95Ms << ", \"p99_ms\": " << s.p99Ms
+             << ", \"max_ms\": " << s.maxMs << "}" << (i + 1 < stats.size() ? "," : "") << "\n";
+    }
+    file << "  ],\n  \"last_run\": [\n";
+    for (std::size_t i = 0; i < last.size(); ++i) {
+        file << "    {\"name\": " << jsonString(last[i].stage) << ", \"ms\": " << last[i].ms << "}"
+             << (i + 1 < last.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    if (!file) {
+        if (error) *error = "Error while writing " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Oublie toutes les mesures et remet le compteur de passages à zéro.
+ */
+void PipelineProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_history.clear();
+    m_lastRun.clear();
+    m_runs = 0;
+}
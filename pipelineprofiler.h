@@ -0,0 +1,138 @@
+// pipelineprofiler.h
+#ifndef PIPELINEPROFILER_H
+#define PIPELINEPROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Durée d'une étape lors du dernier passage du pipeline.
+ */
+struct StageSample
+{
+    std::string stage;
+    double ms = 0.0;
+};
+
+/**
+ * @brief Statistiques glissantes d'une étape (sur les derniers passages).
+ */
+struct StageStats
+{
+    std::string stage;
+    std::size_t count = 0; // Nombre total de mesures depuis le dernier reset()
+    double lastMs = 0.0;
+    double meanMs = 0.0;   // Moyenne sur la fenêtre glissante
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;    // Maximum sur la fenêtre glissante
+};
+
+/**
+ * @brief La classe PipelineProfiler collecte la durée de chaque étape du pipeline et de l'affichage.
+ * Instance unique, utilisable depuis n'importe quel thread. Désactivé par défaut : un ScopedStageTimer
+ * ne coûte alors qu'une lecture atomique, sans horloge ni verrou.
+ * Pour chaque étape, les `kWindowSize` dernières mesures sont conservées (percentiles glissants).
+ */
+class PipelineProfiler
+{
+public:
+    static constexpr std::size_t kWindowSize = 1000;
+
+    static PipelineProfiler& instance();
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Marque le début d'un passage du pipeline : la décomposition du "dernier passage" repart de zéro.
+     */
+    void beginRun();
+
+    /**
+     * @brief Enregistre la durée d'une étape (ignoré si le profileur est désactivé).
+     * @param stage Nom de l'étape (chaîne littérale, conservée telle quelle).
+     * @param ms Durée en millisecondes.
+     */
+    void record(const char* stage, double ms);
+
+    /**
+     * @brief Retourne les étapes mesurées depuis le dernier beginRun(), dans l'ordre d'exécution.
+     * Les étapes servies par le cache du pipeline n'y figurent pas.
+     */
+    std::vector<StageSample> lastRun() const;
+
+    /**
+     * @brief Retourne les statistiques glissantes de toutes les étapes déjà mesurées.
+     */
+    std::vector<StageStats> statistics() const;
+
+    /**
+     * @brief Écrit les statistiques (p50/p95/p99, ...) et le dernier passage dans un fichier JSON.
+     * @param path Chemin du fichier.
+     * @param error Message d'erreur en cas d'échec (optionnel).
+     * @return true si le fichier a été écrit.
+     */
+    bool writeJson(const std::string& path, std::string* error = nullptr) const;
+
+    /**
+     * @brief Oublie toutes les mesures.
+     */
+    void reset();
+
+private:
+    PipelineProfiler() = default;
+
+    struct StageHistory
+    {
+        std::string stage;
+        std::vector<double> window; // Tampon circulaire des dernières mesures
+        std::size_t next = 0;       // Prochaine case à écrire dans `window`
+        std::size_t count = 0;      // Nombre total de mesures
+        double lastMs = 0.0;
+    };
+
+    std::atomic<bool> m_enabled{false};
+    mutable std::mutex m_mutex;           // Protège les membres ci-dessous
+    std::vector<StageHistory> m_history;  // Une entrée par étape, dans l'ordre de première apparition
+    std::vector<StageSample> m_lastRun;   // Étapes du passage courant
+    std::size_t m_runs = 0;               // Nombre de passages (appels à beginRun)
+};
+
+/**
+ * @brief Mesure la durée de sa portée et l'enregistre dans PipelineProfiler à la destruction.
+ * Usage : `ScopedStageTimer timer("gaussian_blur");` au début du bloc à mesurer.
+ */
+class ScopedStageTimer
+{
+public:
+    explicit ScopedStageTimer(const char* stage)
+        : m_stage(PipelineProfiler::instance().isEnabled() ? stage : nullptr)
+    {
+        if (m_stage) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedStageTimer()
+    {
+        if (m_stage) {
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_start;
+            PipelineProfiler::instance().record(m_stage, elapsed.count());
+        }
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    const char* m_stage; // Nul si le profileur était désactivé à la construction
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // PIPELINEPROFILER_H
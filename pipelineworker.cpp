@@ -0,0 +1,93 @@
+// pipelineworker.cpp
+#include "pipelineworker.h"
+#include "tiledpipeline.h"
+#include <QMutexLocker>
+
+/**
+ * @brief Constructeur de PipelineWorker.
+ * Enregistre le type DetectionResult pour les connexions en file (entre threads).
+ * @param parent Objet parent (doit rester nul si le worker est déplacé dans un autre thread).
+ */
+PipelineWorker::PipelineWorker(QObject *parent)
+    : QObject(parent)
+    , m_hasPending(false)
+    , m_pendingGeneration(0)
+    , m_latestGeneration(0)
+{
+    qRegisterMetaType<DetectionResult>("DetectionResult");
+}
+
+/**
+ * @brief Soumet une nouvelle demande de traitement.
+ * La demande remplace celle en attente et, en incrémentant la génération, annule celle en cours.
+ * Le traitement est ensuite planifié dans le thread de travail via la boucle d'événements.
+ * @param image L'image couleur à traiter.
+ * @param params Les paramètres du pipeline.
+ * @return Le numéro de génération attribué à cette demande.
+ */
+quint64 PipelineWorker::submit(const cv::Mat& image, const PipelineParams& params)
+{
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_mutex);
+        generation = ++m_latestGeneration; // Rend obsolète toute demande antérieure
+        m_pendingImage = image;            // Partage les données (pas de copie)
+        m_pendingParams = params;
+        m_pendingGeneration = generation;
+        m_hasPending = true;
+    }
+    // Appel en file : processPending() s'exécutera dans le thread auquel appartient ce worker.
+    // Si plusieurs appels s'accumulent, seul le premier trouve une demande ; les suivants ne font rien.
+    QMetaObject::invokeMethod(this, &PipelineWorker::processPending, Qt::QueuedConnection);
+    return generation;
+}
+
+/**
+ * @brief Annule toutes les demandes : la demande en attente est oubliée
+ * et le traitement en cours s'arrêtera à sa prochaine vérification du jeton.
+ */
+void PipelineWorker::cancelAll()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_latestGeneration;
+    m_hasPending = false;
+    m_pendingImage.release();
+}
+
+/**
+ * @brief Traite la demande en attente (thread de travail).
+ * Le résultat n'est émis que si aucune demande plus récente n'est arrivée entre-temps.
+ */
+void PipelineWorker::processPending()
+{
+    cv::Mat image;
+    PipelineParams params;
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_hasPending) {
+            return; // Demande déjà traitée ou annulée
+        }
+        image = m_pendingImage;
+        params = m_pendingParams;
+        generation = m_pendingGeneration;
+        m_hasPending = false;
+        m_pendingImage.release();
+    }
+
+    CancellationToken token(&m_latestGeneration, generation);
+    DetectionResult result;
+    if (static_cast<double>(image.total()) >= TiledPipeline::kAutoTilingPixels) {
+        // Scan de panneau très grand : traitement par tuiles, sans garder les étapes pleine taille en cache
+        m_pipeline.setImage(cv::Mat());
+        result = TiledPipeline::run(image, params, TilingOptions(), token);
+    } else {
+        m_pipeline.setImage(image);
+        result = m_pipeline.run(params, token);
+    }
+
+    if (token.isCancelled()) {
+        return; // Remplacée par une demande plus récente : cas normal pendant le glissement d'un curseur
+    }
+    emit resultReady(generation, result);
+}
@@ -0,0 +1,73 @@
+// pipelineworker.h
+#ifndef PIPELINEWORKER_H
+#define PIPELINEWORKER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QMetaType>
+#include <atomic>
+#include <opencv2/core.hpp>
+#include "pcbpipeline.h" // Pipeline de détection (bibliothèque pcb_core)
+
+// Permet de transporter un DetectionResult dans un signal entre threads
+Q_DECLARE_METATYPE(DetectionResult)
+
+/**
+ * @brief La classe PipelineWorker exécute le pipeline de détection dans un thread dédié.
+ * Elle est déplacée dans un QThread par ImageWindow. Les demandes sont traitées selon la règle
+ * "la plus récente gagne" : une seule demande en attente est conservée, toute nouvelle demande
+ * remplace la précédente et annule le traitement en cours (voir CancellationToken).
+ */
+class PipelineWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PipelineWorker(QObject *parent = nullptr);
+
+    /**
+     * @brief Soumet une nouvelle demande de traitement (appelable depuis n'importe quel thread).
+     * La demande précédente, en attente ou en cours, devient obsolète.
+     * @param image L'image couleur à traiter (partagée, ne doit plus être modifiée).
+     * @param params Les paramètres du pipeline.
+     * @return Le numéro de génération attribué à cette demande.
+     */
+    quint64 submit(const cv::Mat& image, const PipelineParams& params);
+
+    /**
+     * @brief Annule toutes les demandes (en attente et en cours).
+     */
+    void cancelAll();
+
+    /**
+     * @brief Retourne le numéro de génération de la demande la plus récente.
+     */
+    quint64 latestGeneration() const { return m_latestGeneration.load(); }
+
+signals:
+    /**
+     * @brief Signal émis (depuis le thread de travail) lorsqu'une demande non annulée est terminée.
+     * @param generation Le numéro de génération de la demande.
+     * @param result Le résultat de la détection.
+     */
+    void resultReady(quint64 generation, const DetectionResult& result);
+
+private slots:
+    /**
+     * @brief Traite la demande en attente, s'il y en a une (exécuté dans le thread de travail).
+     */
+    void processPending();
+
+private:
+    QMutex m_mutex;                // Protège la demande en attente
+    bool m_hasPending;             // Vrai si une demande attend d'être traitée
+    cv::Mat m_pendingImage;        // Image de la demande en attente
+    PipelineParams m_pendingParams; // Paramètres de la demande en attente
+    quint64 m_pendingGeneration;   // Génération de la demande en attente
+
+    std::atomic<std::uint64_t> m_latestGeneration; // Dernière génération publiée (lue par les jetons d'annulation)
+
+    PcbPipeline m_pipeline; // Pipeline utilisé uniquement dans le thread de travail
+};
+
+#endif // PIPELINEWORKER_H
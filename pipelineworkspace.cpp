@@ -0,0 +1,46 @@
+// pipelineworkspace.cpp
+#include "pipelineworkspace.h"
+#include <algorithm> // std::max
+
+/**
+ * @brief Réutilise le tampon s'il est exclusif et de la bonne forme.
+ * Le compteur de références d'OpenCV (u->refcount) compte toutes les cv::Mat qui partagent le tampon :
+ * s'il vaut 1, seule `buffer` le détient, et personne ne peut en obtenir une nouvelle référence sans passer
+ * par le pipeline (qui appelle prepare() depuis son unique thread).
+ */
+bool PipelineWorkspace::prepare(cv::Mat& buffer, cv::Size size, int type)
+{
+    const bool exclusive = buffer.u == nullptr || buffer.u->refcount == 1;
+    if (!buffer.empty() && exclusive && buffer.size() == size && buffer.type() == type && buffer.isContinuous()) {
+        ++m_stats.reuses;
+        return false;
+    }
+    buffer.release(); // Ne libère le tampon que si personne d'autre ne le détient
+    buffer.create(size, type);
+    ++m_stats.allocations;
+    ++m_stats.lastRunAllocations;
+    m_stats.peakRunAllocations = std::max(m_stats.peakRunAllocations, m_stats.lastRunAllocations);
+    m_stats.bytesAllocated += buffer.total() * buffer.elemSize();
+    return true;
+}
+
+cv::Ptr<cv::CLAHE> PipelineWorkspace::clahe(double clipLimit)
+{
+    if (!m_clahe) {
+        m_clahe = cv::createCLAHE();
+    }
+    m_clahe->setClipLimit(clipLimit);
+    return m_clahe;
+}
+
+void PipelineWorkspace::beginRun()
+{
+    ++m_stats.runs;
+    m_stats.lastRunAllocations = 0;
+}
+
+void PipelineWorkspace::release()
+{
+    m_clahe.release();
+    m_morphology = MorphologyScratch();
+}
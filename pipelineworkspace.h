@@ -0,0 +1,78 @@
+// pipelineworkspace.h
+#ifndef PIPELINEWORKSPACE_H
+#define PIPELINEWORKSPACE_H
+
+#include <cstddef>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp> // cv::CLAHE
+#include "rectmorphology.h"
+
+/**
+ * @brief Compteurs d'allocation d'un espace de travail.
+ * Une « allocation » est un tampon d'image (re)créé par prepare() ; une réutilisation est un tampon
+ * existant réécrit sur place.
+ */
+struct WorkspaceStats
+{
+    std::size_t runs = 0;                  // Passages commencés (beginRun)
+    std::size_t allocations = 0;           // Tampons alloués depuis la création (ou resetStats)
+    std::size_t reuses = 0;                // Tampons réutilisés depuis la création (ou resetStats)
+    std::size_t bytesAllocated = 0;        // Octets alloués depuis la création (ou resetStats)
+    std::size_t lastRunAllocations = 0;    // Tampons alloués pendant le dernier passage
+    std::size_t peakRunAllocations = 0;    // Maximum par passage (le premier, en général : tout y est alloué)
+};
+
+/**
+ * @brief Espace de travail d'un pipeline : tampons, objet CLAHE et images intermédiaires de la morphologie
+ * conservés d'un passage à l'autre, pour qu'un glissement de slider ne réalloue pas des images pleine taille
+ * à chaque trame.
+ *
+ * Les images des étapes restent des membres du cache du pipeline ; l'espace de travail décide seulement
+ * si leur tampon peut être réécrit. Un tampon encore partagé (résultat remis à l'appelant, image affichée,
+ * QImage qui l'enveloppe) n'est jamais réécrit : un nouveau tampon est alloué à sa place, ce qui garantit
+ * que les résultats déjà remis ne changent pas. En régime établi, seuls ces tampons partagés sont réalloués.
+ *
+ * Comme le pipeline qui le possède, un espace de travail ne sert qu'à un thread à la fois.
+ */
+class PipelineWorkspace
+{
+public:
+    /**
+     * @brief Rend `buffer` prêt à être écrit avec la taille et le type donnés.
+     * Le tampon est réutilisé s'il a déjà cette taille et ce type et que `buffer` en est le seul détenteur ;
+     * sinon il est remplacé par un nouveau tampon (le contenu n'est pas initialisé).
+     * @return true si un tampon a été alloué.
+     */
+    bool prepare(cv::Mat& buffer, cv::Size size, int type);
+
+    /**
+     * @brief Objet CLAHE du pipeline (grille 8x8 par défaut), réglé sur `clipLimit`.
+     * Il est créé une seule fois : ses tables et son image bordée internes sont réutilisées d'un passage à l'autre.
+     */
+    cv::Ptr<cv::CLAHE> clahe(double clipLimit);
+
+    /**
+     * @brief Images intermédiaires de la morphologie (fermeture, ouverture, zones sombres).
+     */
+    MorphologyScratch& morphology() { return m_morphology; }
+
+    /**
+     * @brief Marque le début d'un passage (remet à zéro le compteur du passage).
+     */
+    void beginRun();
+
+    const WorkspaceStats& stats() const { return m_stats; }
+    void resetStats() { m_stats = WorkspaceStats(); }
+
+    /**
+     * @brief Libère les images intermédiaires et l'objet CLAHE (les compteurs sont conservés).
+     */
+    void release();
+
+private:
+    cv::Ptr<cv::CLAHE> m_clahe;
+    MorphologyScratch m_morphology;
+    WorkspaceStats m_stats;
+};
+
+#endif // PIPELINEWORKSPACE_H
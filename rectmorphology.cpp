@@ -0,0 +1,259 @@
+// rectmorphology.cpp
+#include "rectmorphology.h"
+#include <algorithm>               // std::min, std::max, std::copy
+#include <vector>
+#include <opencv2/core/utility.hpp> // parallel_for_
+
+using namespace cv;
+
+namespace {
+
+const int kDirectMaxLength = 5;  // Au-delà, van Herk / Gil-Werman est plus rapide que le calcul direct
+const int kColumnStripWidth = 128; // Largeur des bandes de la passe verticale
+
+// Érosion : minimum, les pixels hors de l'image valent 255 (sans effet)
+struct MinOp
+{
+    static constexpr uchar identity = 255;
+    uchar operator()(uchar a, uchar b) const { return std::min(a, b); }
+    static void images(const Mat& a, const Mat& b, Mat& out) { cv::min(a, b, out); }
+};
+
+// Dilatation : maximum, les pixels hors de l'image valent 0 (sans effet)
+struct MaxOp
+{
+    static constexpr uchar identity = 0;
+    uchar operator()(uchar a, uchar b) const { return std::max(a, b); }
+    static void images(const Mat& a, const Mat& b, Mat& out) { cv::max(a, b, out); }
+};
+
+// out[i] = op(out[i], in[i]) sur `count` octets (boucle simple, vectorisée par le compilateur)
+template <class Op>
+void combine(uchar* out, const uchar* in, int count)
+{
+    const Op op;
+    for (int i = 0; i < count; ++i) {
+        out[i] = op(out[i], in[i]);
+    }
+}
+
+/**
+ * @brief Passe horizontale : dst(x, y) = op de src(x - anchor .. x - anchor + length - 1, y).
+ * Chaque ligne est recopiée dans un tampon bordé d'au moins `anchor` et `length - 1 - anchor` valeurs neutres,
+ * de sorte que la fenêtre du pixel x commence à l'indice x du tampon.
+ */
+template <class Op>
+void horizontalPass(const Mat& src, Mat& dst, int length, int anchor)
+{
+    const int cols = src.cols;
+    // Multiple de `length` (blocs complets pour van Herk / Gil-Werman) couvrant cols + length - 1
+    const int padded = (cols + 2 * (length - 1)) / length * length;
+    dst.create(src.size(), CV_8UC1);
+
+    parallel_for_(Range(0, src.rows), [&](const Range& rows) {
+        const Op op;
+        std::vector<uchar> line(padded, Op::identity), forward(padded), backward(padded);
+        for (int y = rows.start; y < rows.end; ++y) {
+            const uchar* in = src.ptr<uchar>(y);
+            uchar* out = dst.ptr<uchar>(y);
+            std::copy(in, in + cols, line.begin() + anchor); // Les bords gardent la valeur neutre
+
+            if (length <= kDirectMaxLength) {
+                std::copy(line.begin(), line.begin() + cols, out);
+                for (int j = 1; j < length; ++j) {
+                    combine<Op>(out, line.data() + j, cols);
+                }
+                continue;
+            }
+            // Cumuls par blocs : vers l'avant (depuis le début du bloc) et vers l'arrière (jusqu'à sa fin)
+            for (int start = 0; start < padded; start += length) {
+                forward[start] = line[start];
+                for (int i = start + 1; i < start + length; ++i) {
+                    forward[i] = op(forward[i - 1], line[i]);
+                }
+                backward[start + length - 1] = line[start + length - 1];
+                for (int i = start + length - 2; i >= start; --i) {
+                    backward[i] = op(backward[i + 1], line[i]);
+                }
+            }
+            // La fenêtre [x, x + length - 1] chevauche au plus deux blocs : fin de l'un, début du suivant
+            for (int x = 0; x < cols; ++x) {
+                out[x] = op(backward[x], forward[x + length - 1]);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Passe verticale : dst(x, y) = op de src(x, y - anchor .. y - anchor + length - 1).
+ * Même algorithme que la passe horizontale, appliqué à des lignes entières d'une bande de colonnes :
+ * chaque opération porte sur une ligne de la bande, ce qui se vectorise. `dst` ne doit pas être `src`.
+ */
+template <class Op>
+void verticalPass(const Mat& src, Mat& dst, int length, int anchor)
+{
+    const int rows = src.rows;
+    const int padded = (rows + 2 * (length - 1)) / length * length;
+    dst.create(src.size(), CV_8UC1);
+    const int strips = (src.cols + kColumnStripWidth - 1) / kColumnStripWidth;
+
+    parallel_for_(Range(0, strips), [&](const Range& range) {
+        const std::vector<uchar> neutral(kColumnStripWidth, Op::identity);
+        std::vector<uchar> forward, backward;
+        if (length > kDirectMaxLength) {
+            forward.resize(static_cast<size_t>(padded) * kColumnStripWidth);
+            backward.resize(forward.size());
+        }
+        for (int strip = range.start; strip < range.end; ++strip) {
+            const int x0 = strip * kColumnStripWidth;
+            const int width = std::min(kColumnStripWidth, src.cols - x0);
+            // Ligne `j` du tampon bordé : ligne j - anchor de la source, ou valeurs neutres hors de l'image
+            auto paddedRow = [&](int j) {
+                const int y = j - anchor;
+                return y >= 0 && y < rows ? src.ptr<uchar>(y) + x0 : neutral.data();
+            };
+
+            if (length <= kDirectMaxLength) {
+                for (int y = 0; y < rows; ++y) {
+                    uchar* out = dst.ptr<uchar>(y) + x0;
+                    std::copy(paddedRow(y), paddedRow(y) + width, out);
+                    for (int j = 1; j < length; ++j) {
+                        combine<Op>(out, paddedRow(y + j), width);
+                    }
+                }
+                continue;
+            }
+            for (int start = 0; start < padded; start += length) {
+                uchar* f = &forward[static_cast<size_t>(start) * kColumnStripWidth];
+                std::copy(paddedRow(start), paddedRow(start) + width, f);
+                for (int j = start + 1; j < start + length; ++j) {
+                    uchar* next = f + kColumnStripWidth;
+                    std::copy(f, f + width, next);
+                    combine<Op>(next, paddedRow(j), width);
+                    f = next;
+                }
+                const int last = start + length - 1;
+                uchar* b = &backward[static_cast<size_t>(last) * kColumnStripWidth];
+                std::copy(paddedRow(last), paddedRow(last) + width, b);
+                for (int j = last - 1; j >= start; --j) {
+                    uchar* previous = b - kColumnStripWidth;
+                    std::copy(b, b + width, previous);
+                    combine<Op>(previous, paddedRow(j), width);
+                    b = previous;
+                }
+            }
+            for (int y = 0; y < rows; ++y) {
+                uchar* out = dst.ptr<uchar>(y) + x0;
+                std::copy(&backward[static_cast<size_t>(y) * kColumnStripWidth],
+                          &backward[static_cast<size_t>(y) * kColumnStripWidth] + width, out);
+                combine<Op>(out, &forward[static_cast<size_t>(y + length - 1) * kColumnStripWidth], width);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Érosion (Op = MinOp) ou dilatation (Op = MaxOp) par un rectangle : passe horizontale puis verticale.
+ * La passe horizontale peut travailler sur place (chaque ligne est recopiée avant d'être écrite), pas la verticale :
+ * son entrée est alors `temp`.
+ * @param dst Sortie (peut être `src`).
+ * @param anchor Point d'ancrage dans le rectangle.
+ * @param temp Image intermédiaire (ni `src` ni `dst`), réutilisée si elle a déjà la bonne taille.
+ */
+template <class Op>
+void filterRect(const Mat& src, Mat& dst, Size ksize, Point anchor, Mat& temp)
+{
+    if (ksize.height <= 1) {
+        if (ksize.width > 1) {
+            horizontalPass<Op>(src, dst, ksize.width, anchor.x);
+        } else if (dst.data != src.data) {
+            src.copyTo(dst);
+        }
+        return;
+    }
+    const Mat* verticalInput = &src;
+    if (ksize.width > 1) {
+        horizontalPass<Op>(src, temp, ksize.width, anchor.x);
+        verticalInput = &temp;
+    } else if (dst.data == src.data) {
+        src.copyTo(temp);
+        verticalInput = &temp;
+    }
+    verticalPass<Op>(*verticalInput, dst, ksize.height, anchor.y);
+}
+
+// Érosion (MinOp) ou dilatation (MaxOp) par l'ellipse 5x5 : réunion du rectangle 5x3 et du segment 1x5
+template <class Op>
+void filterEllipse5x5(const Mat& src, Mat& dst, MorphologyScratch& scratch)
+{
+    filterRect<Op>(src, scratch.first, Size(5, 3), Point(2, 1), scratch.pass);
+    filterRect<Op>(src, scratch.second, Size(1, 5), Point(0, 2), scratch.pass);
+    Op::images(scratch.first, scratch.second, dst);
+}
+
+/**
+ * @brief Enchaîne érosion et dilatation selon `op` ; `erode(in, out)` et `dilate(in, out)` acceptent out == in.
+ */
+template <class ErodeFn, class DilateFn>
+void applyMorphology(const Mat& src, Mat& dst, MorphTypes op, ErodeFn erode, DilateFn dilate)
+{
+    CV_Assert(src.type() == CV_8UC1);
+    switch (op) {
+    case MORPH_ERODE:
+        erode(src, dst);
+        break;
+    case MORPH_DILATE:
+        dilate(src, dst);
+        break;
+    case MORPH_OPEN:
+        erode(src, dst);
+        dilate(dst, dst);
+        break;
+    case MORPH_CLOSE:
+        dilate(src, dst);
+        erode(dst, dst);
+        break;
+    default:
+        CV_Error(Error::StsBadArg, "morphology: only MORPH_ERODE, MORPH_DILATE, MORPH_OPEN and MORPH_CLOSE are supported");
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Morphologie par un rectangle.
+ * n applications d'un rectangle k x l ancré en (a, b) équivalent à une seule application d'un rectangle
+ * (n(k-1)+1) x (n(l-1)+1) ancré en (na, nb) : c'est aussi ce que fait OpenCV, et le coût reste celui
+ * d'une seule passe.
+ */
+void morphologyRect(const cv::Mat& src, cv::Mat& dst, cv::MorphTypes op, cv::Size ksize, int iterations,
+                    MorphologyScratch* scratch)
+{
+    MorphologyScratch local;
+    MorphologyScratch& buffers = scratch ? *scratch : local;
+    iterations = std::max(1, iterations);
+    ksize = Size(std::max(1, ksize.width), std::max(1, ksize.height));
+    const Size grown((ksize.width - 1) * iterations + 1, (ksize.height - 1) * iterations + 1);
+    const Point anchor(ksize.width / 2 * iterations, ksize.height / 2 * iterations);
+    applyMorphology(src, dst, op,
+                    [&](const Mat& in, Mat& out) { filterRect<MinOp>(in, out, grown, anchor, buffers.pass); },
+                    [&](const Mat& in, Mat& out) { filterRect<MaxOp>(in, out, grown, anchor, buffers.pass); });
+}
+
+void morphologyEllipse5x5(const cv::Mat& src, cv::Mat& dst, cv::MorphTypes op, int iterations,
+                          MorphologyScratch* scratch)
+{
+    MorphologyScratch local;
+    MorphologyScratch& buffers = scratch ? *scratch : local;
+    iterations = std::max(1, iterations);
+    // L'ellipse n'est pas un rectangle : les itérations sont appliquées une à une, comme dans OpenCV
+    applyMorphology(src, dst, op,
+                    [&](const Mat& in, Mat& out) {
+                        filterEllipse5x5<MinOp>(in, out, buffers);
+                        for (int i = 1; i < iterations; ++i) filterEllipse5x5<MinOp>(out, out, buffers);
+                    },
+                    [&](const Mat& in, Mat& out) {
+                        filterEllipse5x5<MaxOp>(in, out, buffers);
+                        for (int i = 1; i < iterations; ++i) filterEllipse5x5<MaxOp>(out, out, buffers);
+                    });
+}
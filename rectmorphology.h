@@ -0,0 +1,52 @@
+// rectmorphology.h
+#ifndef RECTMORPHOLOGY_H
+#define RECTMORPHOLOGY_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp> // cv::MorphTypes
+
+/**
+ * @brief Images intermédiaires de la morphologie, réutilisées d'un appel à l'autre quand la taille ne change pas.
+ * Une instance par appelant : elle ne doit pas servir à deux appels simultanés.
+ */
+struct MorphologyScratch
+{
+    cv::Mat pass;   // Sortie de la passe horizontale
+    cv::Mat first;  // Ellipse : érosion/dilatation par le rectangle 5x3
+    cv::Mat second; // Ellipse : érosion/dilatation par le segment 1x5
+};
+
+/**
+ * @brief Érosion, dilatation, ouverture ou fermeture d'une image CV_8UC1 par un rectangle, en temps
+ * constant par pixel quelle que soit la taille du rectangle.
+ *
+ * Un rectangle est séparable : une passe horizontale (segment 1 x largeur) puis une passe verticale
+ * (segment hauteur x 1). Chaque passe utilise l'algorithme de van Herk / Gil-Werman : la ligne est découpée
+ * en blocs de la longueur du segment, dont on calcule les minimums (maximums) cumulés vers l'avant et vers
+ * l'arrière ; le résultat en un point est le minimum de deux valeurs cumulées, soit trois comparaisons par
+ * pixel. Les segments courts (longueur <= 5) sont calculés directement, ce qui est plus rapide à cette taille.
+ * Les passes sont réparties avec cv::parallel_for_ : par bandes de lignes pour la passe horizontale, par
+ * bandes de colonnes pour la passe verticale (qui traite alors des lignes entières de la bande à la fois).
+ *
+ * Le résultat est identique à cv::morphologyEx(src, dst, op, getStructuringElement(MORPH_RECT, ksize),
+ * Point(-1, -1), iterations) avec la bordure par défaut (les pixels hors de l'image sont ignorés).
+ * @param src Image CV_8UC1.
+ * @param dst Sortie (peut être `src`) ; son tampon est réutilisé s'il a déjà la bonne taille.
+ * @param op MORPH_ERODE, MORPH_DILATE, MORPH_OPEN ou MORPH_CLOSE.
+ * @param ksize Taille du rectangle (point d'ancrage au centre, ksize / 2).
+ * @param iterations Nombre d'applications de chaque opération élémentaire.
+ * @param scratch Images intermédiaires à réutiliser (nullptr : allouées pour cet appel).
+ */
+void morphologyRect(const cv::Mat& src, cv::Mat& dst, cv::MorphTypes op, cv::Size ksize, int iterations = 1,
+                    MorphologyScratch* scratch = nullptr);
+
+/**
+ * @brief Même opérations avec l'ellipse getStructuringElement(MORPH_ELLIPSE, Size(5, 5)).
+ * Cette ellipse est la réunion d'un rectangle 5x3 et d'un segment vertical 1x5, centrés : son érosion
+ * (dilatation) est le minimum (maximum) des érosions (dilatations) par ces deux rectangles.
+ * Le résultat est identique à cv::morphologyEx avec cette ellipse.
+ */
+void morphologyEllipse5x5(const cv::Mat& src, cv::Mat& dst, cv::MorphTypes op, int iterations = 1,
+                          MorphologyScratch* scratch = nullptr);
+
+#endif // RECTMORPHOLOGY_H
@@ -0,0 +1,134 @@
+// spatialindex.cpp
+#include "spatialindex.h"
+#include <algorithm> // std::sort, std::unique, std::find
+
+SpatialIndex::SpatialIndex(int cellSize)
+    : m_cellSize(std::max(1, cellSize))
+    , m_count(0)
+{
+}
+
+/**
+ * @brief Case contenant une coordonnée (division arrondie vers le bas, y compris pour les négatifs).
+ */
+int SpatialIndex::cellOf(int coordinate) const
+{
+    return coordinate >= 0 ? coordinate / m_cellSize : -((-coordinate - 1) / m_cellSize) - 1;
+}
+
+bool SpatialIndex::contains(int id) const
+{
+    return id >= 0 && id < static_cast<int>(m_rects.size()) && !m_rects[id].empty();
+}
+
+void SpatialIndex::insert(int id, const cv::Rect& rect)
+{
+    CV_Assert(id >= 0);
+    remove(id);
+    if (rect.empty()) {
+        return; // Un rectangle vide ne contient aucun point : inutile de l'indexer
+    }
+    if (id >= static_cast<int>(m_rects.size())) {
+        m_rects.resize(id + 1);
+    }
+    m_rects[id] = rect;
+    ++m_count;
+    const int cx0 = cellOf(rect.x), cx1 = cellOf(rect.x + rect.width - 1);
+    const int cy0 = cellOf(rect.y), cy1 = cellOf(rect.y + rect.height - 1);
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            m_cells[cellKey(cx, cy)].push_back(id);
+        }
+    }
+}
+
+void SpatialIndex::remove(int id)
+{
+    if (!contains(id)) {
+        return;
+    }
+    const cv::Rect rect = m_rects[id];
+    const int cx0 = cellOf(rect.x), cx1 = cellOf(rect.x + rect.width - 1);
+    const int cy0 = cellOf(rect.y), cy1 = cellOf(rect.y + rect.height - 1);
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            auto cell = m_cells.find(cellKey(cx, cy));
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            std::vector<int>& ids = cell->second;
+            auto found = std::find(ids.begin(), ids.end(), id);
+            if (found != ids.end()) {
+                *found = ids.back(); // Retrait sans décalage : l'ordre dans une case n'a pas d'importance
+                ids.pop_back();
+            }
+            if (ids.empty()) {
+                m_cells.erase(cell);
+            }
+        }
+    }
+    m_rects[id] = cv::Rect();
+    --m_count;
+}
+
+void SpatialIndex::clear()
+{
+    m_rects.clear();
+    m_cells.clear();
+    m_count = 0;
+}
+
+std::vector<int> SpatialIndex::queryPoint(const cv::Point& point) const
+{
+    std::vector<int> result;
+    auto cell = m_cells.find(cellKey(cellOf(point.x), cellOf(point.y)));
+    if (cell == m_cells.end()) {
+        return result;
+    }
+    for (int id : cell->second) {
+        if (m_rects[id].contains(point)) {
+            result.push_back(id);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<int> SpatialIndex::queryRect(const cv::Rect& area) const
+{
+    std::vector<int> result;
+    if (area.empty() || m_count == 0) {
+        return result;
+    }
+    const int cx0 = cellOf(area.x), cx1 = cellOf(area.x + area.width - 1);
+    const int cy0 = cellOf(area.y), cy1 = cellOf(area.y + area.height - 1);
+    // Une zone plus grande que l'ensemble des cases occupées : parcourir les cases plutôt que la zone
+    const long long areaCells = static_cast<long long>(cx1 - cx0 + 1) * (cy1 - cy0 + 1);
+    if (areaCells > static_cast<long long>(m_cells.size())) {
+        for (const auto& cell : m_cells) {
+            for (int id : cell.second) {
+                if ((m_rects[id] & area).area() > 0) {
+                    result.push_back(id);
+                }
+            }
+        }
+    } else {
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                auto cell = m_cells.find(cellKey(cx, cy));
+                if (cell == m_cells.end()) {
+                    continue;
+                }
+                for (int id : cell->second) {
+                    if ((m_rects[id] & area).area() > 0) {
+                        result.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+    // Un rectangle inscrit dans plusieurs cases n'est rapporté qu'une fois
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
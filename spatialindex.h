@@ -0,0 +1,73 @@
+// spatialindex.h
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <unordered_map>
+#include <vector>
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Index spatial de rectangles par grille uniforme.
+ *
+ * Chaque rectangle est inscrit dans les cases de la grille qu'il recouvre : une recherche par point ou par
+ * rectangle ne parcourt que les cases concernées au lieu de toute la liste. L'index se met à jour
+ * élément par élément (insert/remove), ce qui convient aux annotations dessinées une à une.
+ * Les identifiants sont des entiers positifs choisis par l'appelant (en pratique l'indice dans sa liste).
+ */
+class SpatialIndex
+{
+public:
+    /**
+     * @param cellSize Côté d'une case, en pixels (de l'ordre de la taille des objets indexés).
+     */
+    explicit SpatialIndex(int cellSize = 128);
+
+    /**
+     * @brief Ajoute un rectangle (remplace celui qui avait le même identifiant).
+     */
+    void insert(int id, const cv::Rect& rect);
+
+    /**
+     * @brief Retire un rectangle (sans effet si l'identifiant est absent).
+     */
+    void remove(int id);
+
+    /**
+     * @brief Retire tous les rectangles.
+     */
+    void clear();
+
+    /**
+     * @brief Nombre de rectangles indexés.
+     */
+    int size() const { return m_count; }
+
+    /**
+     * @brief Vrai si l'identifiant est présent dans l'index.
+     */
+    bool contains(int id) const;
+
+    /**
+     * @brief Rectangles qui contiennent un point.
+     * @return Leurs identifiants, en ordre croissant.
+     */
+    std::vector<int> queryPoint(const cv::Point& point) const;
+
+    /**
+     * @brief Rectangles qui ont une intersection non vide avec `area`.
+     * @return Leurs identifiants, en ordre croissant.
+     */
+    std::vector<int> queryRect(const cv::Rect& area) const;
+
+private:
+    // Clé d'une case : (cx, cy) regroupés sur 64 bits
+    static long long cellKey(int cx, int cy) { return (static_cast<long long>(cx) << 32) ^ static_cast<unsigned>(cy); }
+    int cellOf(int coordinate) const;
+
+    int m_cellSize;
+    int m_count;
+    std::vector<cv::Rect> m_rects;  // Rectangle de chaque identifiant (vide : absent)
+    std::unordered_map<long long, std::vector<int>> m_cells; // Identifiants inscrits dans chaque case
+};
+
+#endif // SPATIALINDEX_H
@@ -0,0 +1,107 @@
+// threadpool.cpp
+#include "threadpool.h"
+
+/**
+ * @brief Démarre les threads du pool.
+ * @param threadCount Nombre de threads (0 : nombre de cœurs disponibles, au moins 1).
+ * @param maxQueued Nombre maximal de tâches en attente (0 : file non bornée).
+ */
+ThreadPool::ThreadPool(unsigned threadCount, std::size_t maxQueued)
+    : m_maxQueued(maxQueued), m_running(0), m_stopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1; // hardware_concurrency() peut retourner 0 si inconnu
+    }
+    m_workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Laisse les threads vider la file, puis les arrête et les rejoint.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Ajoute une tâche à la file. Si la file est bornée et pleine, l'appelant attend
+ * qu'un thread en retire une (contre-pression).
+ * @param task La tâche à exécuter.
+ */
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_maxQueued > 0) {
+            m_spaceAvailable.wait(lock, [this] { return m_tasks.size() < m_maxQueued; });
+        }
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+/**
+ * @brief Bloque jusqu'à ce que la file soit vide et qu'aucune tâche ne soit en cours.
+ */
+void ThreadPool::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_tasks.empty() && m_running == 0; });
+}
+
+/**
+ * @brief Retourne le nombre de tâches en attente.
+ */
+std::size_t ThreadPool::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+/**
+ * @brief Boucle d'un thread : retire une tâche, l'exécute, recommence.
+ * À l'arrêt, le thread ne se termine qu'une fois la file vide.
+ */
+void ThreadPool::workerLoop()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return; // Arrêt demandé et plus rien à faire
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_running;
+        }
+        m_spaceAvailable.notify_one();
+
+        try {
+            task();
+        } catch (...) {
+            // Les tâches doivent gérer leurs propres erreurs ; une exception échappée est ignorée
+            // pour ne pas tuer le thread ni bloquer waitIdle().
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_running;
+            if (m_tasks.empty() && m_running == 0) {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+// threadpool.h
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief La classe ThreadPool exécute des tâches sur un nombre fixe de threads.
+ * La file d'attente peut être bornée : submit() bloque alors l'appelant tant qu'elle est pleine,
+ * ce qui limite la mémoire occupée par les tâches en attente (contre-pression).
+ * Indépendante de Qt, elle sert aux outils en ligne de commande comme au reste de pcb_core.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Démarre le pool.
+     * @param threadCount Nombre de threads (0 : nombre de cœurs disponibles).
+     * @param maxQueued Nombre maximal de tâches en attente (0 : file non bornée).
+     */
+    explicit ThreadPool(unsigned threadCount = 0, std::size_t maxQueued = 0);
+
+    /**
+     * @brief Termine les tâches déjà soumises puis arrête les threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Ajoute une tâche à la file (bloque si la file bornée est pleine).
+     * @param task La tâche à exécuter.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Attend que toutes les tâches soumises soient terminées.
+     */
+    void waitIdle();
+
+    /**
+     * @brief Retourne le nombre de tâches en attente (hors tâches en cours d'exécution).
+     */
+    std::size_t pendingCount() const;
+
+    /**
+     * @brief Retourne le nombre de threads du pool.
+     */
+    unsigned threadCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+private:
+    void workerLoop(); // Boucle exécutée par chaque thread
+
+    std::vector<std::thread> m_workers;         // Threads du pool
+    std::deque<std::function<void()>> m_tasks;  // Tâches en attente
+    mutable std::mutex m_mutex;                 // Protège la file et les compteurs
+    std::condition_variable m_taskAvailable;    // Signalé quand une tâche est ajoutée (ou à l'arrêt)
+    std::condition_variable m_spaceAvailable;   // Signalé quand une place se libère dans la file bornée
+    std::condition_variable m_idle;             // Signalé quand plus aucune tâche n'est en attente ni en cours
+    std::size_t m_maxQueued;                    // Taille maximale de la file (0 : non bornée)
+    std::size_t m_running;                      // Nombre de tâches en cours d'exécution
+    bool m_stopping;                            // Vrai pendant la destruction
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,57 @@
+// thumbnailcache.cpp
+#include "thumbnailcache.h"
+#include <algorithm>             // std::max, std::min
+#include <opencv2/imgproc.hpp>   // resize
+#include "matimage.h"            // Conversion cv::Mat -> QPixmap
+#include "pipelineprofiler.h"    // Mesure de la génération des vignettes (ScopedStageTimer)
+
+/**
+ * @brief Construit un cache vide.
+ * @param maxKilobytes Mémoire maximale occupée par les vignettes, en kilo-octets.
+ */
+ThumbnailCache::ThumbnailCache(int maxKilobytes)
+    : m_cache(maxKilobytes)
+{
+}
+
+/**
+ * @brief Retourne la vignette d'un composant, générée au besoin.
+ * La ROI est réduite avec INTER_AREA (moyenne des pixels) avant la conversion en QPixmap :
+ * seule la vignette, et non la ROI pleine résolution, est convertie et conservée.
+ */
+QPixmap ThumbnailCache::thumbnail(const Composant& component, const QSize& iconSize)
+{
+    const ComponentSourcePtr& source = component.getSource();
+    if (!source || !iconSize.isValid()) {
+        return QPixmap();
+    }
+    const cv::Rect box = component.getBoundingBox();
+    const ThumbnailKey key{source->id, box.x, box.y, box.width, box.height, iconSize.width(), iconSize.height()};
+    if (const QPixmap* cached = m_cache.object(key)) {
+        return *cached;
+    }
+
+    ScopedStageTimer timer("ThumbnailCache::generate");
+    const cv::Mat roi = component.getImageRegion();
+    if (roi.empty()) {
+        return QPixmap();
+    }
+
+    // Réduit la ROI pour tenir dans l'icône en conservant les proportions (jamais d'agrandissement)
+    const double scale = std::min({1.0,
+                                   static_cast<double>(iconSize.width()) / roi.cols,
+                                   static_cast<double>(iconSize.height()) / roi.rows});
+    cv::Mat small = roi;
+    if (scale < 1.0) {
+        const cv::Size target(std::max(1, cvRound(roi.cols * scale)), std::max(1, cvRound(roi.rows * scale)));
+        cv::resize(roi, small, target, 0, 0, cv::INTER_AREA);
+    } else {
+        small = roi.clone(); // La vignette ne doit pas garder toute l'image source en vie
+    }
+
+    QPixmap* pixmap = new QPixmap(matToQPixmap(small));
+    const QPixmap result = *pixmap;
+    const int cost = std::max(1, pixmap->width() * pixmap->height() * std::max(1, pixmap->depth() / 8) / 1024);
+    m_cache.insert(key, pixmap, cost); // Le cache devient propriétaire (ou le détruit s'il dépasse la limite)
+    return result;
+}
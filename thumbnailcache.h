@@ -0,0 +1,67 @@
+// thumbnailcache.h
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+#include <QSize>
+#include "composant.h"
+
+/**
+ * @brief Clé d'une vignette : source, boîte englobante et taille d'icône demandée.
+ * Un composant dont la boîte ne change pas d'un traitement à l'autre retrouve donc sa vignette.
+ */
+struct ThumbnailKey
+{
+    quint64 sourceId;
+    int x, y, width, height;
+    int iconWidth, iconHeight;
+
+    bool operator==(const ThumbnailKey& other) const
+    {
+        return sourceId == other.sourceId && x == other.x && y == other.y && width == other.width
+               && height == other.height && iconWidth == other.iconWidth && iconHeight == other.iconHeight;
+    }
+};
+
+// La clé ne contient pas d'octets de remplissage : elle peut être hachée directement (Qt 5 et Qt 6)
+static_assert(sizeof(ThumbnailKey) == sizeof(quint64) + 6 * sizeof(int), "ThumbnailKey ne doit pas avoir de remplissage");
+
+inline uint qHash(const ThumbnailKey& key, uint seed = 0)
+{
+    return static_cast<uint>(qHashBits(&key, sizeof(key), seed));
+}
+
+/**
+ * @brief Cache des vignettes de composants, borné en mémoire.
+ *
+ * Les vignettes sont générées à la demande (thread GUI) à la taille de l'icône, à partir de la ROI du composant
+ * dans son image source ; les moins récemment utilisées sont évincées quand la limite est atteinte.
+ */
+class ThumbnailCache
+{
+public:
+    /**
+     * @param maxKilobytes Mémoire maximale occupée par les vignettes, en kilo-octets.
+     */
+    explicit ThumbnailCache(int maxKilobytes = 32 * 1024);
+
+    /**
+     * @brief Retourne la vignette d'un composant, en la générant si elle n'est pas en cache.
+     * @param component Le composant (sa source doit être valide).
+     * @param iconSize Taille maximale de la vignette (les proportions sont conservées).
+     * @return La vignette, ou une QPixmap nulle si le composant n'a pas d'image.
+     */
+    QPixmap thumbnail(const Composant& component, const QSize& iconSize);
+
+    /**
+     * @brief Vide le cache (par exemple au chargement d'une nouvelle image).
+     */
+    void clear() { m_cache.clear(); }
+
+private:
+    QCache<ThumbnailKey, QPixmap> m_cache; // Coût d'une entrée : sa taille en kilo-octets
+};
+
+#endif // THUMBNAILCACHE_H
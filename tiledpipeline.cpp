@@ -0,0 +1,638 @@
+// tiledpipeline.cpp
+
+// Pipeline de détection par tuiles (aucune dépendance Qt)
+#include "tiledpipeline.h"
+#include <algorithm>             // Pour std::max, std::sort
+#include <cfloat>                // Pour FLT_EPSILON (méthode d'Otsu)
+#include <functional>            // Pour std::function (masque d'une région)
+#include <mutex>                 // Pour fusionner les histogrammes des tuiles
+#include <string>                // Pour std::to_string (numérotation des composants)
+#include <vector>
+#include <opencv2/imgproc.hpp>   // cvtColor, GaussianBlur, adaptiveThreshold, findContours, resize, etc.
+#include "pcbpipeline.h"         // Étapes individuelles du pipeline
+#include "pipelineprofiler.h"    // Mesure de la durée de chaque passe
+#include "threadpool.h"          // Traitement des tuiles en parallèle
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+const int kClaheTiles = 8;       // Grille utilisée par createCLAHE() (8x8 cellules)
+const int kHistSize = 256;       // Niveaux de gris
+const int kAdaptiveRadius = 7;   // Rayon du voisinage du seuillage adaptatif (bloc 15x15)
+const int kDarkMaskRadius = 12;  // Fermeture elliptique 5x5 répétée 3 fois : 3 dilatations + 3 érosions de rayon 2
+
+/**
+ * @brief Un contour externe : boîte englobante (coordonnées de l'image entière) et aire.
+ */
+struct Component
+{
+    Rect rect;
+    double area;
+};
+
+/**
+ * @brief Tables de correspondance CLAHE de l'image entière, calculées comme le fait cv::CLAHE :
+ * l'image est d'abord complétée en bas et à droite (réflexion 101) jusqu'à un multiple de la grille.
+ */
+struct ClaheTables
+{
+    Size cellSize;       // Taille d'une cellule de la grille (image complétée / 8)
+    int padX = 0;        // Colonnes ajoutées à droite
+    int padY = 0;        // Lignes ajoutées en bas
+    vector<uchar> lut;   // kClaheTiles * kClaheTiles tables de kHistSize entrées
+};
+
+/**
+ * @brief Découpage de l'image en tuiles carrées (cœurs sans recouvrement), en ordre ligne par ligne.
+ */
+struct TileGrid
+{
+    Size imageSize;
+    int tileSize;
+    int cols;
+    int rows;
+
+    TileGrid(const Size& size, int tile)
+        : imageSize(size), tileSize(tile)
+        , cols((size.width + tile - 1) / tile), rows((size.height + tile - 1) / tile) {}
+
+    int count() const { return cols * rows; }
+
+    Rect core(int index) const
+    {
+        const Rect tile((index % cols) * tileSize, (index / cols) * tileSize, tileSize, tileSize);
+        return tile & Rect(0, 0, imageSize.width, imageSize.height);
+    }
+
+    // Indices des tuiles dont le cœur rencontre `r`
+    void tilesOverlapping(const Rect& r, vector<int>& tiles) const
+    {
+        tiles.clear();
+        const int x0 = max(0, r.x / tileSize), x1 = min(cols - 1, (r.x + r.width - 1) / tileSize);
+        const int y0 = max(0, r.y / tileSize), y1 = min(rows - 1, (r.y + r.height - 1) / tileSize);
+        for (int ty = y0; ty <= y1; ++ty)
+            for (int tx = x0; tx <= x1; ++tx)
+                tiles.push_back(ty * cols + tx);
+    }
+};
+
+// Agrandit un rectangle de `margin` pixels de chaque côté, sans sortir de l'image
+Rect expandClip(const Rect& r, int margin, const Size& size)
+{
+    return Rect(r.x - margin, r.y - margin, r.width + 2 * margin, r.height + 2 * margin)
+           & Rect(0, 0, size.width, size.height);
+}
+
+// Vrai si `a`, agrandi d'un pixel, rencontre `b` (deux objets 8-connexes peuvent se toucher)
+bool touches(const Rect& a, const Rect& b)
+{
+    return !(Rect(a.x - 1, a.y - 1, a.width + 2, a.height + 2) & b).empty();
+}
+
+// Niveaux de gris et flou gaussien d'une région ; exacts à au moins `blurKsize` pixels des bords de la région
+// (ou jusqu'au bord si celui-ci est le bord de l'image : la réflexion est alors la même qu'en pleine image).
+Mat blurredGray(const Mat& bgr, const Rect& region, const PipelineParams& params)
+{
+    Mat gray = PcbPipeline::toGray(bgr(region));
+    PcbPipeline::applyGaussianBlur(gray, params);
+    return gray;
+}
+
+/**
+ * @brief Ajoute les pixels d'un cœur de tuile aux histogrammes des cellules CLAHE.
+ * Les pixels recopiés par la réflexion du bourrage sont comptés une seconde fois dans leur cellule miroir.
+ */
+void accumulateClaheHistograms(const Mat& core, const Point& origin, const Size& imageSize,
+                               const ClaheTables& tables, vector<int>& hist)
+{
+    const int W = imageSize.width, H = imageSize.height;
+    const int cw = tables.cellSize.width, ch = tables.cellSize.height;
+    vector<int> cellOffset(core.cols);
+    for (int x = 0; x < core.cols; ++x) {
+        cellOffset[x] = (origin.x + x) / cw * kHistSize;
+    }
+    // Colonnes gx de [W-1-padX, W-2] : recopiées en 2W-2-gx par le bourrage de droite
+    const int mirrorStart = max(0, W - 1 - tables.padX - origin.x);
+    const int mirrorEnd = min(core.cols, W - 1 - origin.x);
+
+    for (int y = 0; y < core.rows; ++y) {
+        const int gy = origin.y + y;
+        const uchar* row = core.ptr<uchar>(y);
+        int* rowHist = &hist[(gy / ch) * kClaheTiles * kHistSize];
+        for (int x = 0; x < core.cols; ++x) {
+            rowHist[cellOffset[x] + row[x]]++;
+        }
+        for (int x = mirrorStart; x < mirrorEnd; ++x) {
+            rowHist[(2 * W - 2 - (origin.x + x)) / cw * kHistSize + row[x]]++;
+        }
+        // Ligne recopiée en 2H-2-gy par le bourrage du bas
+        const int py = 2 * H - 2 - gy;
+        if (py >= H && py < H + tables.padY) {
+            int* mirrorHist = &hist[(py / ch) * kClaheTiles * kHistSize];
+            for (int x = 0; x < core.cols; ++x) {
+                mirrorHist[cellOffset[x] + row[x]]++;
+            }
+            for (int x = mirrorStart; x < mirrorEnd; ++x) {
+                mirrorHist[(2 * W - 2 - (origin.x + x)) / cw * kHistSize + row[x]]++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Calcule les tables CLAHE à partir des histogrammes des cellules (écrêtage, redistribution,
+ * cumul), avec la même arithmétique que cv::CLAHE.
+ */
+void computeClaheLuts(const vector<int>& hist, double clipLimit, ClaheTables& tables)
+{
+    const int tileSizeTotal = tables.cellSize.area();
+    const float lutScale = static_cast<float>(kHistSize - 1) / tileSizeTotal;
+    int clip = 0;
+    if (clipLimit > 0.0) {
+        clip = max(static_cast<int>(clipLimit * tileSizeTotal / kHistSize), 1);
+    }
+
+    tables.lut.assign(kClaheTiles * kClaheTiles * kHistSize, 0);
+    for (int cell = 0; cell < kClaheTiles * kClaheTiles; ++cell) {
+        int h[kHistSize];
+        copy(hist.begin() + cell * kHistSize, hist.begin() + (cell + 1) * kHistSize, h);
+
+        if (clipLimit > 0.0) {
+            int clipped = 0;
+            for (int i = 0; i < kHistSize; ++i) {
+                if (h[i] > clip) {
+                    clipped += h[i] - clip;
+                    h[i] = clip;
+                }
+            }
+            const int redistBatch = clipped / kHistSize;
+            int residual = clipped - redistBatch * kHistSize;
+            for (int i = 0; i < kHistSize; ++i) {
+                h[i] += redistBatch;
+            }
+            if (residual != 0) {
+                const int residualStep = max(kHistSize / residual, 1);
+                for (int i = 0; i < kHistSize && residual > 0; i += residualStep, residual--) {
+                    h[i]++;
+                }
+            }
+        }
+
+        int sum = 0;
+        uchar* lut = &tables.lut[cell * kHistSize];
+        for (int i = 0; i < kHistSize; ++i) {
+            sum += h[i];
+            lut[i] = saturate_cast<uchar>(sum * lutScale);
+        }
+    }
+}
+
+/**
+ * @brief Applique les tables CLAHE à une région (interpolation bilinéaire entre les quatre cellules voisines,
+ * même arithmétique flottante que cv::CLAHE). `origin` est la position de la région dans l'image.
+ */
+void applyClaheTables(Mat& gray, const Point& origin, const ClaheTables& tables)
+{
+    const float invTw = 1.0f / tables.cellSize.width;
+    const float invTh = 1.0f / tables.cellSize.height;
+
+    vector<int> ind1(gray.cols), ind2(gray.cols);
+    vector<float> xa(gray.cols), xa1(gray.cols);
+    for (int x = 0; x < gray.cols; ++x) {
+        const float txf = (origin.x + x) * invTw - 0.5f;
+        int tx1 = cvFloor(txf);
+        int tx2 = tx1 + 1;
+        xa[x] = txf - tx1;
+        xa1[x] = 1.0f - xa[x];
+        tx1 = max(tx1, 0);
+        tx2 = min(tx2, kClaheTiles - 1);
+        ind1[x] = tx1 * kHistSize;
+        ind2[x] = tx2 * kHistSize;
+    }
+
+    for (int y = 0; y < gray.rows; ++y) {
+        const float tyf = (origin.y + y) * invTh - 0.5f;
+        int ty1 = cvFloor(tyf);
+        int ty2 = ty1 + 1;
+        const float ya = tyf - ty1, ya1 = 1.0f - ya;
+        ty1 = max(ty1, 0);
+        ty2 = min(ty2, kClaheTiles - 1);
+        const uchar* lut1 = &tables.lut[ty1 * kClaheTiles * kHistSize];
+        const uchar* lut2 = &tables.lut[ty2 * kClaheTiles * kHistSize];
+
+        uchar* row = gray.ptr<uchar>(y);
+        for (int x = 0; x < gray.cols; ++x) {
+            const int v = row[x];
+            const float res = (lut1[ind1[x] + v] * xa1[x] + lut1[ind2[x] + v] * xa[x]) * ya1 +
+                              (lut2[ind1[x] + v] * xa1[x] + lut2[ind2[x] + v] * xa[x]) * ya;
+            row[x] = saturate_cast<uchar>(res);
+        }
+    }
+}
+
+/**
+ * @brief Seuil d'Otsu calculé à partir d'un histogramme, comme le fait cv::threshold(THRESH_OTSU).
+ */
+double otsuThreshold(const vector<double>& hist, double total)
+{
+    const double scale = 1.0 / total;
+    double mu = 0.0;
+    for (int i = 0; i < kHistSize; ++i) {
+        mu += i * hist[i];
+    }
+    mu *= scale;
+
+    double mu1 = 0.0, q1 = 0.0, maxSigma = 0.0, maxVal = 0.0;
+    for (int i = 0; i < kHistSize; ++i) {
+        const double p_i = hist[i] * scale;
+        mu1 *= q1;
+        q1 += p_i;
+        const double q2 = 1.0 - q1;
+        if (min(q1, q2) < FLT_EPSILON || max(q1, q2) > 1.0 - FLT_EPSILON) {
+            continue;
+        }
+        mu1 = (mu1 + i * p_i) / q1;
+        const double mu2 = (mu - q1 * mu1) / q2;
+        const double sigma = q1 * q2 * (mu1 - mu2) * (mu1 - mu2);
+        if (sigma > maxSigma) {
+            maxSigma = sigma;
+            maxVal = i;
+        }
+    }
+    return maxVal;
+}
+
+// Vrai si la boîte touche un bord du cœur qui n'est pas un bord de l'image (l'objet peut continuer dans la tuile voisine)
+bool touchesSeam(const Rect& box, const Rect& core, const Size& size)
+{
+    return (box.x == core.x && core.x > 0)
+           || (box.y == core.y && core.y > 0)
+           || (box.x + box.width == core.x + core.width && core.x + core.width < size.width)
+           || (box.y + box.height == core.y + core.height && core.y + core.height < size.height);
+}
+
+// Contours externes d'un masque (coordonnées de l'image entière), avec la méthode d'extraction demandée
+void externalContours(const Mat& mask, const Point& origin, ComponentExtractor extractor, vector<Component>& out)
+{
+    vector<Rect> rects;
+    vector<double> areas;
+    PcbPipeline::findComponentCandidates(mask, extractor, rects, areas);
+    for (size_t i = 0; i < rects.size(); ++i) {
+        out.push_back(Component{ rects[i] + origin, areas[i] });
+    }
+}
+
+/**
+ * @brief Trouve les contours externes d'un masque binaire de l'image entière sans jamais le construire en entier.
+ * `maskFor(rect)` doit retourner le masque exact de `rect`.
+ *
+ * 1. Chaque tuile est traitée seule. Un contour qui ne touche aucune jointure est complet et définitif.
+ * 2. Les morceaux qui touchent une jointure sont regroupés avec ceux des tuiles voisines qu'ils touchent.
+ * 3. Chaque groupe donne une région, agrandie jusqu'à contenir entièrement tout objet qui la rencontre
+ *    (y compris ceux qui pourraient l'entourer) : sa bordure d'un pixel est alors vide.
+ * 4. Les contours de ces régions sont recalculés d'un seul tenant ; ils remplacent les contours de tuile
+ *    qu'elles contiennent.
+ */
+vector<Component> collectExternalContours(const TileGrid& grid, const function<Mat(const Rect&)>& maskFor,
+                                          ComponentExtractor extractor, ThreadPool& pool, const CancellationToken& token)
+{
+    const Size size = grid.imageSize;
+
+    // 1. Contours de chaque tuile, séparés en contours complets et morceaux touchant une jointure
+    vector<vector<Component>> localByTile(grid.count()), seamByTile(grid.count());
+    for (int t = 0; t < grid.count(); ++t) {
+        pool.submit([&, t]() {
+            if (token.isCancelled()) return;
+            const Rect core = grid.core(t);
+            vector<Component> found;
+            externalContours(maskFor(core), core.tl(), extractor, found);
+            for (const Component& c : found) {
+                (touchesSeam(c.rect, core, size) ? seamByTile[t] : localByTile[t]).push_back(c);
+            }
+        });
+    }
+    pool.waitIdle();
+    if (token.isCancelled()) return vector<Component>();
+
+    // 2. Regroupement des morceaux qui se touchent d'une tuile à l'autre (union-find)
+    vector<Component> seams;
+    vector<vector<int>> seamIndexByTile(grid.count());
+    for (int t = 0; t < grid.count(); ++t) {
+        for (const Component& c : seamByTile[t]) {
+            seamIndexByTile[t].push_back(static_cast<int>(seams.size()));
+            seams.push_back(c);
+        }
+    }
+    vector<int> parent(seams.size());
+    for (size_t i = 0; i < parent.size(); ++i) parent[i] = static_cast<int>(i);
+    auto find = [&parent](int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    for (int t = 0; t < grid.count(); ++t) {
+        const int tx = t % grid.cols, ty = t / grid.cols;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const int nx = tx + dx, ny = ty + dy;
+                if (nx < 0 || ny < 0 || nx >= grid.cols || ny >= grid.rows) continue;
+                const int n = ny * grid.cols + nx;
+                for (int i : seamIndexByTile[t]) {
+                    for (int j : seamIndexByTile[n]) {
+                        if (j > i && touches(seams[i].rect, seams[j].rect)) {
+                            parent[find(i)] = find(j);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    vector<int> groupOf(seams.size(), -1);
+    vector<Rect> groups;
+    for (size_t i = 0; i < seams.size(); ++i) {
+        const int root = find(static_cast<int>(i));
+        if (groupOf[root] < 0) {
+            groupOf[root] = static_cast<int>(groups.size());
+            groups.push_back(seams[i].rect);
+        } else {
+            groups[groupOf[root]] |= seams[i].rect;
+        }
+    }
+
+    // 3. Régions à recalculer : fermeture de chaque groupe sur les contours et groupes qu'il rencontre
+    vector<Component> locals;
+    vector<vector<int>> localsByTile(grid.count()), groupsByTile(grid.count());
+    for (int t = 0; t < grid.count(); ++t) {
+        for (const Component& c : localByTile[t]) {
+            localsByTile[t].push_back(static_cast<int>(locals.size()));
+            locals.push_back(c);
+        }
+    }
+    vector<int> tiles;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        grid.tilesOverlapping(groups[g], tiles);
+        for (int t : tiles) groupsByTile[t].push_back(static_cast<int>(g));
+    }
+    vector<char> localAbsorbed(locals.size(), 0), groupAbsorbed(groups.size(), 0);
+    vector<Rect> regions;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        if (groupAbsorbed[g]) continue;
+        groupAbsorbed[g] = 1;
+        Rect region = groups[g];
+        bool grown = true;
+        while (grown) {
+            grown = false;
+            const Rect query = expandClip(region, 1, size);
+            grid.tilesOverlapping(query, tiles);
+            for (int t : tiles) {
+                for (int li : localsByTile[t]) {
+                    if (!localAbsorbed[li] && !(locals[li].rect & query).empty()) {
+                        localAbsorbed[li] = 1;
+                        region |= locals[li].rect;
+                        grown = true;
+                    }
+                }
+                for (int gi : groupsByTile[t]) {
+                    if (!groupAbsorbed[gi] && !(groups[gi] & query).empty()) {
+                        groupAbsorbed[gi] = 1;
+                        region |= groups[gi];
+                        grown = true;
+                    }
+                }
+            }
+            for (size_t r = 0; r < regions.size();) {
+                if (!(regions[r] & query).empty()) {
+                    region |= regions[r];
+                    regions.erase(regions.begin() + r);
+                    grown = true;
+                } else {
+                    ++r;
+                }
+            }
+        }
+        regions.push_back(region);
+    }
+
+    // 4. Recalcul des régions d'un seul tenant (avec une bordure d'un pixel, vide par construction)
+    vector<vector<Component>> fixedByRegion(regions.size());
+    for (size_t r = 0; r < regions.size(); ++r) {
+        pool.submit([&, r]() {
+            if (token.isCancelled()) return;
+            const Rect area = expandClip(regions[r], 1, size);
+            externalContours(maskFor(area), area.tl(), extractor, fixedByRegion[r]);
+        });
+    }
+    pool.waitIdle();
+    if (token.isCancelled()) return vector<Component>();
+
+    vector<Component> components;
+    for (size_t i = 0; i < locals.size(); ++i) {
+        if (!localAbsorbed[i]) components.push_back(locals[i]);
+    }
+    for (const vector<Component>& fixed : fixedByRegion) {
+        components.insert(components.end(), fixed.begin(), fixed.end());
+    }
+    return components;
+}
+
+/**
+ * @brief Prépare les images de résultat à l'échelle de l'aperçu (au plus `maxSide` pixels de côté).
+ */
+void renderPreview(const Mat& bgr, const vector<Rect>& rects, int maxSide, Mat& contoursImage, Mat& extractedOnBlank)
+{
+    const int side = max(bgr.cols, bgr.rows);
+    if (maxSide <= 0 || side <= maxSide) {
+        PcbPipeline::renderResults(bgr, rects, contoursImage, extractedOnBlank);
+        return;
+    }
+    const double scale = static_cast<double>(maxSide) / side;
+    Mat preview;
+    resize(bgr, preview, Size(max(1, cvRound(bgr.cols * scale)), max(1, cvRound(bgr.rows * scale))), 0, 0, INTER_AREA);
+    contoursImage = preview.clone();
+    extractedOnBlank = Mat(preview.size(), preview.type(), Scalar(255, 255, 255));
+
+    const Rect bounds(0, 0, preview.cols, preview.rows);
+    for (size_t index = 0; index < rects.size(); ++index) {
+        const Rect& box = rects[index];
+        const Rect scaled = Rect(cvFloor(box.x * scale), cvFloor(box.y * scale),
+                                 max(1, cvRound(box.width * scale)), max(1, cvRound(box.height * scale))) & bounds;
+        if (scaled.empty()) continue;
+        cv::rectangle(contoursImage, scaled, Scalar(0, 0, 255), 1);
+        cv::putText(contoursImage, to_string(index), scaled.tl(), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 255, 0), 1);
+        preview(scaled).copyTo(extractedOnBlank(scaled));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Marge de recouvrement : rayon cumulé des filtres entre l'image et le masque final.
+ * Le seuillage (flou puis voisinage adaptatif) et les zones sombres (fermeture elliptique) sont parallèles ;
+ * viennent ensuite la fermeture (fillHolesKsize) et l'ouverture (separationKsize), chacune de rayon 2*N.
+ */
+int TiledPipeline::halo(const PipelineParams& params)
+{
+    const int blurRadius = max(0, params.blurKsize);
+    const int segmentation = max(blurRadius + kAdaptiveRadius, kDarkMaskRadius);
+    return segmentation + 2 * max(0, params.fillHolesKsize) + 2 * max(0, params.separationKsize);
+}
+
+/**
+ * @brief Lance le pipeline par tuiles.
+ * Passes successives, chacune parallèle sur les tuiles (les tuiles sont relues depuis l'image source
+ * à chaque passe : on recalcule plutôt que de garder des images pleine taille) :
+ * 1. histogrammes des cellules CLAHE -> tables CLAHE globales ;
+ * 2. histogramme de l'image prétraitée -> moyenne (choix adaptatif / Otsu) et seuil d'Otsu ;
+ * 3. si seuillage adaptatif : nombre de contours des deux polarités -> choix de la polarité ;
+ * 4. masque final par tuile et contours, avec recollage aux jointures.
+ */
+DetectionResult TiledPipeline::run(const cv::Mat& bgr, const PipelineParams& params,
+                                   const TilingOptions& options, const CancellationToken& token)
+{
+    if (bgr.empty() || token.isCancelled()) {
+        return DetectionResult();
+    }
+    PipelineProfiler::instance().beginRun();
+    ScopedStageTimer totalTimer("tiled_total");
+
+    const Size size = bgr.size();
+    const TileGrid grid(size, max(64, options.tileSize));
+    ThreadPool pool(options.threads);
+    const int blurRadius = max(0, params.blurKsize);
+
+    // 1. Tables CLAHE (même découpage et même bourrage que cv::CLAHE)
+    ClaheTables tables;
+    {
+        ScopedStageTimer timer("tiled_clahe_tables");
+        if (size.width % kClaheTiles != 0 || size.height % kClaheTiles != 0) {
+            tables.padX = kClaheTiles - size.width % kClaheTiles;
+            tables.padY = kClaheTiles - size.height % kClaheTiles;
+        }
+        tables.cellSize = Size((size.width + tables.padX) / kClaheTiles, (size.height + tables.padY) / kClaheTiles);
+
+        vector<int> hist(kClaheTiles * kClaheTiles * kHistSize, 0);
+        mutex histMutex;
+        for (int t = 0; t < grid.count(); ++t) {
+            pool.submit([&, t]() {
+                if (token.isCancelled()) return;
+                const Rect core = grid.core(t);
+                const Rect region = expandClip(core, blurRadius, size);
+                const Mat blurred = blurredGray(bgr, region, params);
+                vector<int> local(hist.size(), 0);
+                accumulateClaheHistograms(blurred(core - region.tl()), core.tl(), size, tables, local);
+                lock_guard<mutex> lock(histMutex);
+                for (size_t i = 0; i < hist.size(); ++i) hist[i] += local[i];
+            });
+        }
+        pool.waitIdle();
+        if (token.isCancelled()) return DetectionResult();
+        computeClaheLuts(hist, params.claheClipLimit / 10.0, tables);
+    }
+
+    // Image prétraitée (niveaux de gris, flou, CLAHE) d'une région ; exacte à `blurRadius` pixels de ses bords
+    auto preprocessed = [&](const Rect& region) {
+        Mat gray = blurredGray(bgr, region, params);
+        applyClaheTables(gray, region.tl(), tables);
+        return gray;
+    };
+
+    // 2. Moyenne et seuil d'Otsu de l'image prétraitée entière
+    bool adaptive = false;
+    double otsuThresh = 0.0;
+    {
+        ScopedStageTimer timer("tiled_threshold_stats");
+        vector<double> hist(kHistSize, 0.0);
+        mutex histMutex;
+        for (int t = 0; t < grid.count(); ++t) {
+            pool.submit([&, t]() {
+                if (token.isCancelled()) return;
+                const Rect core = grid.core(t);
+                const Rect region = expandClip(core, blurRadius, size);
+                const Mat pre = preprocessed(region);
+                const Mat coreView = pre(core - region.tl());
+                vector<double> local(kHistSize, 0.0);
+                for (int y = 0; y < coreView.rows; ++y) {
+                    const uchar* row = coreView.ptr<uchar>(y);
+                    for (int x = 0; x < coreView.cols; ++x) local[row[x]] += 1.0;
+                }
+                lock_guard<mutex> lock(histMutex);
+                for (int i = 0; i < kHistSize; ++i) hist[i] += local[i];
+            });
+        }
+        pool.waitIdle();
+        if (token.isCancelled()) return DetectionResult();
+
+        const double total = static_cast<double>(size.area());
+        double sum = 0.0;
+        for (int i = 0; i < kHistSize; ++i) sum += i * hist[i];
+        adaptive = sum * (1.0 / total) > 140; // Même critère que PcbPipeline::segment()
+        if (!adaptive) {
+            otsuThresh = otsuThreshold(hist, total);
+        }
+    }
+
+    // 3. Polarité du seuillage adaptatif : celle qui donne le plus de contours externes sur l'image entière
+    bool inverted = false;
+    if (adaptive) {
+        ScopedStageTimer timer("tiled_adaptive_polarity");
+        auto adaptiveMask = [&](int type) {
+            return [&, type](const Rect& rect) {
+                const Rect region = expandClip(rect, blurRadius + kAdaptiveRadius, size);
+                Mat thresholded;
+                adaptiveThreshold(preprocessed(region), thresholded, 255, ADAPTIVE_THRESH_MEAN_C, type, 15, 10);
+                return Mat(thresholded(rect - region.tl()));
+            };
+        };
+        const size_t binaryCount = collectExternalContours(grid, adaptiveMask(THRESH_BINARY), params.extractor, pool, token).size();
+        const size_t inverseCount = collectExternalContours(grid, adaptiveMask(THRESH_BINARY_INV), params.extractor, pool, token).size();
+        if (token.isCancelled()) return DetectionResult();
+        inverted = !(binaryCount > inverseCount); // Même choix que segmentByAdaptiveThresholding()
+    }
+
+    // 4. Masque final (seuillage | zones sombres, fermeture, ouverture) et contours, recollés aux jointures
+    const int margin = halo(params);
+    auto finalMask = [&](const Rect& rect) {
+        const Rect region = expandClip(rect, margin, size);
+        const Mat pre = preprocessed(region);
+        Mat thresholded;
+        if (adaptive) {
+            adaptiveThreshold(pre, thresholded, 255, ADAPTIVE_THRESH_MEAN_C,
+                              inverted ? THRESH_BINARY_INV : THRESH_BINARY, 15, 10);
+        } else {
+            threshold(pre, thresholded, otsuThresh, 255, THRESH_BINARY);
+        }
+        Mat mask;
+        bitwise_or(thresholded, PcbPipeline::darkAreaMask(bgr(region)), mask);
+        PcbPipeline::applyFillHoles(mask, params);
+        PcbPipeline::applySeparation(mask, params);
+        return Mat(mask(rect - region.tl()));
+    };
+    vector<Component> components;
+    {
+        ScopedStageTimer timer("tiled_masks_contours");
+        components = collectExternalContours(grid, finalMask, params.extractor, pool, token);
+    }
+    if (token.isCancelled()) return DetectionResult();
+
+    // 5. Filtrage par aire minimale, ordre stable (haut en bas, gauche à droite) et aperçus
+    sort(components.begin(), components.end(), [](const Component& a, const Component& b) {
+        return a.rect.y != b.rect.y ? a.rect.y < b.rect.y : a.rect.x < b.rect.x;
+    });
+    vector<Rect> candidateRects;
+    vector<double> candidateAreas;
+    for (const Component& c : components) {
+        candidateRects.push_back(c.rect);
+        candidateAreas.push_back(c.area);
+    }
+    DetectionResult result;
+    PcbPipeline::filterComponents(candidateRects, candidateAreas, params.contourMinArea, size, result.rects, result.areas);
+    {
+        ScopedStageTimer timer("tiled_render_preview");
+        renderPreview(bgr, result.rects, options.previewMaxSide, result.contoursImage, result.extractedComponentsOnBlank);
+    }
+    return result;
+}
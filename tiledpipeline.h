@@ -0,0 +1,62 @@
+// tiledpipeline.h
+#ifndef TILEDPIPELINE_H
+#define TILEDPIPELINE_H
+
+#include <opencv2/core.hpp>
+#include "pipelineparams.h"
+#include "detectionresult.h"
+#include "cancellationtoken.h"
+
+/**
+ * @brief Options du mode tuilé.
+ */
+struct TilingOptions
+{
+    int tileSize = 2048;       // Côté du cœur d'une tuile (sans la marge de recouvrement)
+    unsigned threads = 0;      // Nombre de threads (0 : nombre de cœurs)
+    int previewMaxSide = 4096; // Plus grand côté des images de résultat (0 : pleine résolution)
+};
+
+/**
+ * @brief La classe TiledPipeline applique le pipeline de PcbPipeline par tuiles qui se recouvrent,
+ * pour les scans de panneaux trop grands pour garder toutes les images intermédiaires en mémoire.
+ *
+ * Chaque tuile est traitée avec une marge égale au rayon cumulé des filtres (flou, seuillage adaptatif,
+ * morphologie, voir halo()) : le masque du cœur de la tuile est identique à celui du traitement complet.
+ * Les grandeurs globales (tables CLAHE, moyenne, seuil d'Otsu, choix de la polarité du seuillage adaptatif)
+ * sont calculées par des passes préalables sur les tuiles. Les composants coupés par une jointure de tuiles
+ * sont recalculés d'un seul tenant sur la région qui les englobe. Le résultat (boîtes et aires) est donc
+ * le même qu'avec PcbPipeline::run(), à l'ordre des composants près (ici triés de haut en bas,
+ * puis de gauche à droite).
+ *
+ * La mémoire utilisée est bornée par (nombre de threads) x (taille d'une tuile et de sa marge), plus
+ * l'image source. Les images de résultat sont réduites à `previewMaxSide` et `mask` reste vide.
+ */
+class TiledPipeline
+{
+public:
+    /**
+     * @brief Taille (en pixels) à partir de laquelle le mode tuilé est utilisé automatiquement.
+     */
+    static constexpr double kAutoTilingPixels = 100e6;
+
+    /**
+     * @brief Retourne la marge de recouvrement nécessaire pour que le masque du cœur d'une tuile soit exact.
+     * @param params Les paramètres du pipeline.
+     */
+    static int halo(const PipelineParams& params);
+
+    /**
+     * @brief Lance le pipeline tuilé.
+     * @param bgr L'image couleur d'entrée (partagée, non copiée).
+     * @param params Les paramètres du pipeline.
+     * @param options Taille des tuiles, nombre de threads et taille des aperçus.
+     * @param token Jeton d'annulation, consulté entre les tuiles.
+     * @return Le résultat de la détection (incomplet si la demande a été annulée).
+     */
+    static DetectionResult run(const cv::Mat& bgr, const PipelineParams& params,
+                               const TilingOptions& options = TilingOptions(),
+                               const CancellationToken& token = CancellationToken());
+};
+
+#endif // TILEDPIPELINE_H